@@ -5,6 +5,7 @@
 
 #include "../Core/Platform.hpp"
 
+#include <array>
 #include <optional>
 #include <string_view>
 
@@ -32,24 +33,7 @@ public:
      */
     constexpr std::string_view GetTag() const noexcept
     {
-        if (m_Tag)
-            return *m_Tag;
-
-        switch (m_Level)
-        {
-            case LogLevel::LOG_DEBUG:
-                return "DEBUG";
-            case LogLevel::LOG_INFO:
-                return "INFO";
-            case LogLevel::LOG_WARNING:
-                return "WARNING";
-            case LogLevel::LOG_ERROR:
-                return "ERROR";
-            case LogLevel::LOG_FATAL:
-                return "FATAL";
-        }
-
-        RKLOG_UNREACHABLE();
+        return m_Tag ? *m_Tag : GetLevelName(m_Level);
     }
 
     /**
@@ -68,6 +52,18 @@ public:
      */
     constexpr std::optional<Color> GetBackgroundColor() const noexcept { return m_Background; }
 
+    /**
+     * Gets the ANSI escape sequence setting the colors of the log level. The
+     * sequence is rendered once, when the configuration is built
+     *
+     * @return
+     *      The escape sequence, empty if the log level has no colors
+     */
+    constexpr std::string_view GetColorCode() const noexcept
+    {
+        return std::string_view(m_ColorCode.data(), m_ColorCodeLength);
+    }
+
 private:
     /**
      * Creates a new instance of the log configuration for the given log level
@@ -78,6 +74,46 @@ private:
     constexpr LogConfig(LogLevel level) noexcept :
         m_Level(level) {}
 
+    /**
+     * Renders the escape sequence for the current colors
+     */
+    constexpr void RenderColorCode() noexcept
+    {
+        m_ColorCodeLength = 0;
+        if (!m_Foreground && !m_Background)
+            return;
+
+        const auto append = [this](std::string_view text) {
+            for (const char c : text)
+                m_ColorCode[m_ColorCodeLength++] = c;
+        };
+        const auto appendColor = [this, &append](Color color) {
+            for (const uint8_t channel : { color.r, color.g, color.b })
+            {
+                if (channel >= 100)
+                    m_ColorCode[m_ColorCodeLength++] = static_cast<char>('0' + channel / 100);
+                if (channel >= 10)
+                    m_ColorCode[m_ColorCodeLength++] = static_cast<char>('0' + channel / 10 % 10);
+                m_ColorCode[m_ColorCodeLength++] = static_cast<char>('0' + channel % 10);
+                append(";");
+            }
+            m_ColorCodeLength--;
+        };
+
+        append("\033[");
+        if (m_Foreground)
+        {
+            append("38;2;");
+            appendColor(*m_Foreground);
+        }
+        if (m_Background)
+        {
+            append(m_Foreground ? ";48;2;" : "48;2;");
+            appendColor(*m_Background);
+        }
+        append("m");
+    }
+
 private:
     /// The log level
     LogLevel m_Level{};
@@ -87,6 +123,10 @@ private:
     std::optional<Color> m_Background{};
     /// The tag for the log level
     std::optional<std::string_view> m_Tag{};
+    /// The rendered escape sequence for the colors
+    std::array<char, 40> m_ColorCode{};
+    /// The length of the rendered escape sequence
+    uint8_t m_ColorCodeLength{};
 
     friend class LogConfigBuilder;
 };
@@ -127,6 +167,7 @@ public:
     [[nodiscard]] constexpr LogConfigBuilder& SetForeground(Color color) noexcept
     {
         m_Config.m_Foreground = color;
+        m_Config.RenderColorCode();
         return *this;
     }
 
@@ -147,6 +188,7 @@ public:
     [[nodiscard]] constexpr LogConfigBuilder& SetForeground(uint8_t r, uint8_t g, uint8_t b) noexcept
     {
         m_Config.m_Foreground = Color(r, g, b);
+        m_Config.RenderColorCode();
         return *this;
     }
 
@@ -162,6 +204,7 @@ public:
     [[nodiscard]] constexpr LogConfigBuilder& SetBackground(Color color) noexcept
     {
         m_Config.m_Background = color;
+        m_Config.RenderColorCode();
         return *this;
     }
 
@@ -182,6 +225,7 @@ public:
     [[nodiscard]] constexpr LogConfigBuilder& SetBackground(uint8_t r, uint8_t g, uint8_t b) noexcept
     {
         m_Config.m_Background = Color(r, g, b);
+        m_Config.RenderColorCode();
         return *this;
     }
 
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Level.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace rklog {
+
+/**
+ * Enum describing when buffered log lines are handed to the operating system
+ */
+enum class FlushMode : uint8_t
+{
+    PER_RECORD, // After every record
+    WHEN_FULL,  // Only when the buffer runs out of room
+    INTERVAL,   // When the buffer is full, and periodically from a timer
+};
+
+/**
+ * Class describing how a file logger buffers and flushes its log lines
+ */
+class FlushPolicy final
+{
+public:
+    /**
+     * Gets when the buffer is flushed
+     *
+     * @return
+     *      The flush mode
+     */
+    constexpr FlushMode GetMode() const noexcept { return m_Mode; }
+
+    /**
+     * Gets the size of the buffer
+     *
+     * @return
+     *      The size of the buffer in bytes
+     */
+    constexpr size_t GetBufferSize() const noexcept { return m_BufferSize; }
+
+    /**
+     * Gets the period of the flush timer, used with `FlushMode::INTERVAL`
+     *
+     * @return
+     *      The period of the timer
+     */
+    constexpr std::chrono::milliseconds GetInterval() const noexcept { return m_Interval; }
+
+    /**
+     * Gets the log level from which records are flushed immediately
+     *
+     * @return
+     *      The log level, empty if no level flushes immediately
+     */
+    constexpr std::optional<LogLevel> GetFlushLevel() const noexcept { return m_FlushLevel; }
+
+    /**
+     * Checks whether a record has to be flushed as soon as it is written
+     *
+     * @param[in] level
+     *      The log level of the record
+     *
+     * @return
+     *      `true` if the buffer should be flushed after the record
+     */
+    constexpr bool FlushesImmediately(LogLevel level) const noexcept
+    {
+        return m_Mode == FlushMode::PER_RECORD || (m_FlushLevel && level >= *m_FlushLevel);
+    }
+
+private:
+    constexpr FlushPolicy() noexcept = default;
+
+private:
+    /// When the buffer is flushed
+    FlushMode m_Mode{FlushMode::WHEN_FULL};
+    /// The size of the buffer in bytes
+    size_t m_BufferSize{64 * 1024};
+    /// The period of the flush timer
+    std::chrono::milliseconds m_Interval{1000};
+    /// The log level from which records are flushed immediately
+    std::optional<LogLevel> m_FlushLevel{LogLevel::LOG_ERROR};
+
+    friend class FlushPolicyBuilder;
+};
+
+/**
+ * Class used for building flush policies
+ */
+class FlushPolicyBuilder final
+{
+public:
+    FlushPolicyBuilder(const FlushPolicyBuilder&) = delete;
+    FlushPolicyBuilder(FlushPolicyBuilder&&) = delete;
+
+    /**
+     * Sets when the buffer is flushed
+     *
+     * @param[in] mode
+     *      The flush mode
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr FlushPolicyBuilder& SetMode(FlushMode mode) noexcept
+    {
+        m_Policy.m_Mode = mode;
+        return *this;
+    }
+
+    /**
+     * Sets the size of the buffer. Records larger than the buffer are written
+     * directly
+     *
+     * @param[in] size
+     *      The size of the buffer in bytes
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr FlushPolicyBuilder& SetBufferSize(size_t size) noexcept
+    {
+        m_Policy.m_BufferSize = size;
+        return *this;
+    }
+
+    /**
+     * Sets the period of the flush timer and switches to
+     * `FlushMode::INTERVAL`
+     *
+     * @param[in] interval
+     *      The period of the timer
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr FlushPolicyBuilder& SetInterval(std::chrono::milliseconds interval) noexcept
+    {
+        m_Policy.m_Mode = FlushMode::INTERVAL;
+        m_Policy.m_Interval = interval;
+        return *this;
+    }
+
+    /**
+     * Sets the log level from which records are flushed immediately,
+     * regardless of the flush mode
+     *
+     * @param[in] level
+     *      The log level, or `std::nullopt` to only flush per the mode
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr FlushPolicyBuilder& SetFlushLevel(std::optional<LogLevel> level) noexcept
+    {
+        m_Policy.m_FlushLevel = level;
+        return *this;
+    }
+
+    /**
+     * Finalizes the build for the flush policy
+     *
+     * @return
+     *      The final flush policy
+     */
+    [[nodiscard]] constexpr FlushPolicy&& Build() noexcept { return std::move(m_Policy); }
+
+private:
+    constexpr FlushPolicyBuilder() noexcept = default;
+
+private:
+    /// The policy being built
+    FlushPolicy m_Policy{};
+
+    friend constexpr FlushPolicyBuilder InitBuildFlushPolicy() noexcept;
+};
+
+/**
+ * Initializes the building of a flush policy
+ *
+ * @return
+ *      An instance of the flush policy builder
+ */
+[[nodiscard]] constexpr FlushPolicyBuilder InitBuildFlushPolicy() noexcept
+{
+    return FlushPolicyBuilder();
+}
+
+}
+
+namespace rklog::defaults {
+
+constexpr FlushPolicy DEFAULT_FLUSH_POLICY = InitBuildFlushPolicy().Build();
+
+}
@@ -1,6 +1,25 @@
 #pragma once
 
+#include "../Core/Platform.hpp"
+
 #include <cstdint>
+#include <string_view>
+
+// --- compile time log level -------------------------------------------------
+
+#define RKLOG_LEVEL_DEBUG 0
+#define RKLOG_LEVEL_INFO 1
+#define RKLOG_LEVEL_WARNING 2
+#define RKLOG_LEVEL_ERROR 3
+#define RKLOG_LEVEL_FATAL 4
+#define RKLOG_LEVEL_OFF 5
+
+// Logs below this level are compiled out. Define it before including rklog,
+// or on the command line, to raise the floor (e.g. to RKLOG_LEVEL_INFO for
+// release builds)
+#if !defined(RKLOG_ACTIVE_LEVEL)
+#define RKLOG_ACTIVE_LEVEL RKLOG_LEVEL_DEBUG
+#endif
 
 namespace rklog {
 
@@ -16,4 +35,51 @@ enum class LogLevel : uint8_t
     LOG_FATAL,
 };
 
+/// The lowest log level that is compiled in
+constexpr int ACTIVE_LEVEL = RKLOG_ACTIVE_LEVEL;
+
+/**
+ * Checks whether logs of the given level are compiled in, based on
+ * `RKLOG_ACTIVE_LEVEL`
+ *
+ * @param[in] level
+ *      The log level to check
+ *
+ * @return
+ *      `true` if logs of the given level are compiled in
+ */
+constexpr bool IsLevelActive(LogLevel level) noexcept
+{
+    return static_cast<int>(level) >= ACTIVE_LEVEL;
+}
+
+/**
+ * Gets the name of a log level, e.g. for machine-readable output where the
+ * configured tags do not belong
+ *
+ * @param[in] level
+ *      The log level
+ *
+ * @return
+ *      The upper case name of the log level
+ */
+constexpr std::string_view GetLevelName(LogLevel level) noexcept
+{
+    switch (level)
+    {
+        case LogLevel::LOG_DEBUG:
+            return "DEBUG";
+        case LogLevel::LOG_INFO:
+            return "INFO";
+        case LogLevel::LOG_WARNING:
+            return "WARNING";
+        case LogLevel::LOG_ERROR:
+            return "ERROR";
+        case LogLevel::LOG_FATAL:
+            return "FATAL";
+    }
+
+    RKLOG_UNREACHABLE();
+}
+
 }
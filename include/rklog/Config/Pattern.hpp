@@ -0,0 +1,431 @@
+#pragma once
+
+#include "../Core/Time.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace rklog {
+
+/**
+ * Enum describing the kinds of segments a log pattern is compiled into
+ */
+enum class PatternToken : uint8_t
+{
+    LITERAL,  // Text copied as-is
+    TITLE,    // `{title}`: the title of the logger
+    TAG,      // `{tag}`: the tag of the log level
+    TIME,     // `{time}` or `{time:spec}`: the timestamp of the log
+    THREAD,   // `{thread}`: the id of the thread that made the log
+    FILE,     // `{file}`: the source file of the log call
+    LINE,     // `{line}`: the source line of the log call
+    FUNCTION, // `{func}`: the function the log call was made in
+    MESSAGE,  // `{msg}`: the formatted message, followed by its fields
+    COLOR,    // `{color}`: the color of the log level, if coloring
+    RESET,    // `{reset}`: resets the color, if a color was written
+    IF,       // `{if:field}`: skips to the matching `{endif}` if the field is empty
+    ENDIF,    // `{endif}`: ends an `{if:field}` block
+};
+
+/**
+ * Struct describing a single compiled segment of a log pattern
+ */
+struct PatternSegment final
+{
+public:
+    PatternToken token{};       // What the segment writes
+    PatternToken condition{};   // The field tested by an `IF` segment
+    uint8_t jump{};             // The index of the `ENDIF` matching an `IF` segment
+    bool hasTimeFormat{};       // Whether a `TIME` segment has its own format
+    TimeFormat timeFormat{};    // The format of a `TIME` segment
+    uint16_t offset{};          // The offset of the text of a `LITERAL` segment in the pattern
+    uint16_t length{};          // The length of the text of a `LITERAL` segment
+};
+
+/**
+ * Class containing a log pattern compiled into a flat list of segments
+ *
+ * Patterns are plain text with fields in braces: `{title}`, `{tag}`, `{time}`,
+ * `{thread}`, `{file}`, `{line}`, `{func}`, `{msg}`, `{color}` and `{reset}`.
+ * The time takes the same specification as `rklog::TimeStamp` (e.g.
+ * `{time:ui.3}`) and falls back to the time format of the style without one.
+ * `{if:field}` ... `{endif}` only writes its contents if the field is not
+ * empty, and `{{`/`}}` write literal braces. Unknown fields are written as-is
+ *
+ * The text of the pattern is copied into the compiled pattern, so it does not
+ * have to outlive it. Patterns longer than `MAX_LENGTH` characters, or that
+ * compile into more than `MAX_SEGMENTS` segments, are not compiled at all and
+ * report themselves as invalid
+ */
+class LogPattern final
+{
+public:
+    /// The maximum number of segments a pattern can be compiled into
+    static constexpr size_t MAX_SEGMENTS = 32;
+    /// The maximum number of characters of a pattern
+    static constexpr size_t MAX_LENGTH = 256;
+
+public:
+    /**
+     * Compiles a log pattern
+     *
+     * @param[in] pattern
+     *      The text of the pattern
+     */
+    constexpr LogPattern(std::string_view pattern) noexcept
+    {
+        if (pattern.size() > MAX_LENGTH)
+        {
+            m_Valid = false;
+            return;
+        }
+
+        for (size_t i = 0; i < pattern.size(); i++)
+            m_Text[i] = pattern[i];
+        m_Length = pattern.size();
+
+        std::array<uint8_t, MAX_DEPTH> openIfs{};
+        size_t depth{};
+
+        size_t idx{};
+        while (idx < pattern.size() && m_Valid)
+        {
+            const char c = pattern[idx];
+            if ((c == '{' || c == '}') && idx + 1 < pattern.size() && pattern[idx + 1] == c)
+            {
+                AddLiteral(idx, 1);
+                idx += 2;
+                continue;
+            }
+
+            const size_t close = c == '{' ? pattern.find('}', idx) : std::string_view::npos;
+            if (close == std::string_view::npos)
+            {
+                const size_t next = pattern.find_first_of("{}", idx + 1);
+                const size_t end = next == std::string_view::npos ? pattern.size() : next;
+                AddLiteral(idx, end - idx);
+                idx = end;
+                continue;
+            }
+
+            const std::string_view field = pattern.substr(idx + 1, close - idx - 1);
+            const std::string_view name = field.substr(0, field.find(':'));
+            const std::string_view spec = name.size() < field.size() ? field.substr(name.size() + 1) : std::string_view();
+
+            if (m_Count == MAX_SEGMENTS)
+            {
+                m_Valid = false;
+                break;
+            }
+
+            PatternSegment segment{};
+            if (name == "if" && depth < MAX_DEPTH && ParseField(spec, segment.condition))
+            {
+                segment.token = PatternToken::IF;
+                openIfs[depth++] = static_cast<uint8_t>(m_Count);
+            }
+            else if (field == "endif" && depth > 0)
+            {
+                segment.token = PatternToken::ENDIF;
+                m_Segments[openIfs[--depth]].jump = static_cast<uint8_t>(m_Count);
+            }
+            else if (name == "time" && ParseTimeFormat(spec, segment.timeFormat))
+            {
+                segment.token = PatternToken::TIME;
+                segment.hasTimeFormat = !spec.empty();
+            }
+            else if (spec.empty() && ParseField(name, segment.token))
+            {
+            }
+            else
+            {
+                segment.token = PatternToken::LITERAL;
+                segment.offset = static_cast<uint16_t>(idx);
+                segment.length = static_cast<uint16_t>(close - idx + 1);
+            }
+
+            m_Segments[m_Count++] = segment;
+            idx = close + 1;
+        }
+
+        if (!m_Valid)
+        {
+            m_Count = 0;
+            return;
+        }
+
+        // Blocks left open run to the end of the pattern
+        while (depth > 0)
+            m_Segments[openIfs[--depth]].jump = static_cast<uint8_t>(m_Count);
+    }
+
+    /**
+     * Checks whether the pattern fit into `MAX_LENGTH` characters and
+     * `MAX_SEGMENTS` segments and was compiled
+     *
+     * @return
+     *      `true` if the pattern was compiled
+     */
+    constexpr bool IsValid() const noexcept { return m_Valid; }
+
+    /**
+     * Gets the text the pattern was compiled from
+     *
+     * @return
+     *      The text of the pattern
+     */
+    constexpr std::string_view GetSource() const noexcept { return std::string_view(m_Text.data(), m_Length); }
+
+    /**
+     * Gets the number of compiled segments
+     *
+     * @return
+     *      The number of segments
+     */
+    constexpr size_t Size() const noexcept { return m_Count; }
+
+    /**
+     * Gets a compiled segment
+     *
+     * @param[in] idx
+     *      The index of the segment
+     *
+     * @return
+     *      The segment at the given index
+     */
+    constexpr const PatternSegment& operator[](size_t idx) const noexcept { return m_Segments[idx]; }
+
+    /**
+     * Gets the text of a literal segment
+     *
+     * @param[in] segment
+     *      The literal segment
+     *
+     * @return
+     *      The text of the segment
+     */
+    constexpr std::string_view GetLiteral(const PatternSegment& segment) const noexcept
+    {
+        return std::string_view(m_Text.data() + segment.offset, segment.length);
+    }
+
+private:
+    /// The maximum nesting of `{if:field}` blocks
+    static constexpr size_t MAX_DEPTH = 4;
+
+private:
+    /**
+     * Appends a literal segment, merging it with a preceding literal when the
+     * text is adjacent in the pattern
+     *
+     * @param[in] offset
+     *      The offset of the text of the literal in the pattern
+     * @param[in] length
+     *      The length of the text
+     */
+    constexpr void AddLiteral(size_t offset, size_t length) noexcept
+    {
+        if (m_Count > 0)
+        {
+            PatternSegment& last = m_Segments[m_Count - 1];
+            if (last.token == PatternToken::LITERAL && last.offset + last.length == offset)
+            {
+                last.length = static_cast<uint16_t>(last.length + length);
+                return;
+            }
+        }
+
+        if (m_Count == MAX_SEGMENTS)
+        {
+            m_Valid = false;
+            return;
+        }
+
+        PatternSegment segment{};
+        segment.token = PatternToken::LITERAL;
+        segment.offset = static_cast<uint16_t>(offset);
+        segment.length = static_cast<uint16_t>(length);
+        m_Segments[m_Count++] = segment;
+    }
+
+    /**
+     * Parses the name of a field without arguments
+     *
+     * @param[in] name
+     *      The name of the field
+     * @param[out] token
+     *      The token of the field
+     *
+     * @return
+     *      `true` if the name is a known field
+     */
+    static constexpr bool ParseField(std::string_view name, PatternToken& token) noexcept
+    {
+        constexpr std::array<std::pair<std::string_view, PatternToken>, 10> FIELDS = {{
+            { "title", PatternToken::TITLE },
+            { "tag", PatternToken::TAG },
+            { "time", PatternToken::TIME },
+            { "thread", PatternToken::THREAD },
+            { "file", PatternToken::FILE },
+            { "line", PatternToken::LINE },
+            { "func", PatternToken::FUNCTION },
+            { "msg", PatternToken::MESSAGE },
+            { "color", PatternToken::COLOR },
+            { "reset", PatternToken::RESET },
+        }};
+
+        for (const auto& [fieldName, fieldToken] : FIELDS)
+        {
+            if (fieldName == name)
+            {
+                token = fieldToken;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Parses the specification of a time field, see `rklog::TimeStamp`
+     *
+     * @param[in] spec
+     *      The specification
+     * @param[out] format
+     *      The parsed time format
+     *
+     * @return
+     *      `true` if the specification is valid
+     */
+    static constexpr bool ParseTimeFormat(std::string_view spec, TimeFormat& format) noexcept
+    {
+        if (spec.starts_with('u'))
+        {
+            format.utc = true;
+            spec.remove_prefix(1);
+        }
+        if (spec.starts_with('i'))
+        {
+            format.iso8601 = true;
+            spec.remove_prefix(1);
+        }
+
+        if (spec.empty())
+            return true;
+        else if (spec == ".3")
+            format.precision = TimePrecision::MILLISECONDS;
+        else if (spec == ".6")
+            format.precision = TimePrecision::MICROSECONDS;
+        else if (spec == ".9")
+            format.precision = TimePrecision::NANOSECONDS;
+        else
+            return false;
+
+        return true;
+    }
+
+private:
+    /// The text of the pattern, referenced by the literal segments
+    std::array<char, MAX_LENGTH> m_Text{};
+    /// The number of characters of the pattern
+    size_t m_Length{};
+    /// The compiled segments
+    std::array<PatternSegment, MAX_SEGMENTS> m_Segments{};
+    /// The number of compiled segments
+    size_t m_Count{};
+    /// A flag indicating whether the pattern fit and was compiled
+    bool m_Valid{true};
+};
+
+/// The escape sequence resetting the color of the terminal
+constexpr std::string_view ANSI_RESET = "\033[0m";
+
+/**
+ * Enum describing the kinds of decorations marked in a rendered log line
+ */
+enum class ColorMarkKind : uint8_t
+{
+    COLOR,         // `{color}`: the color of the log level starts here
+    RESET,         // `{reset}`: the color is reset here
+    BEGIN_COLORED, // `{if:color}`: text only written when coloring starts here
+    END_COLORED,   // `{endif}` of an `{if:color}` block
+};
+
+/**
+ * Struct describing a single decoration of a rendered log line
+ */
+struct ColorMark final
+{
+public:
+    uint32_t offset{};    // The offset into the line the decoration applies at
+    ColorMarkKind kind{}; // The kind of the decoration
+};
+
+/**
+ * Class containing the decorations of a log line rendered without color, so
+ * that the same line can be written both with and without color
+ */
+class ColorMarks final
+{
+public:
+    /**
+     * Adds a decoration
+     *
+     * @param[in] offset
+     *      The offset into the line the decoration applies at
+     * @param[in] kind
+     *      The kind of the decoration
+     */
+    constexpr void Add(size_t offset, ColorMarkKind kind) noexcept
+    {
+        if (m_Count < m_Marks.size())
+            m_Marks[m_Count++] = ColorMark{static_cast<uint32_t>(offset), kind};
+
+        m_HasColoredText |= kind == ColorMarkKind::BEGIN_COLORED;
+    }
+
+    /**
+     * Gets the number of decorations
+     *
+     * @return
+     *      The number of decorations
+     */
+    constexpr size_t Size() const noexcept { return m_Count; }
+
+    /**
+     * Checks whether the line contains text only written when coloring
+     *
+     * @return
+     *      `true` if an `{if:color}` block was rendered
+     */
+    constexpr bool HasColoredText() const noexcept { return m_HasColoredText; }
+
+    /**
+     * Gets a decoration
+     *
+     * @param[in] idx
+     *      The index of the decoration
+     *
+     * @return
+     *      The decoration at the given index
+     */
+    constexpr const ColorMark& operator[](size_t idx) const noexcept { return m_Marks[idx]; }
+
+private:
+    /// The decorations, at most one per segment of the pattern
+    std::array<ColorMark, LogPattern::MAX_SEGMENTS> m_Marks{};
+    /// The number of decorations
+    size_t m_Count{};
+    /// A flag indicating whether an `{if:color}` block was rendered
+    bool m_HasColoredText{};
+};
+
+}
+
+namespace rklog::defaults {
+
+constexpr std::string_view DEFAULT_PATTERN = "{color}{if:title}[{title}]:{endif}[{tag}]:[{time}]: {msg}{reset}";
+
+}
@@ -0,0 +1,404 @@
+#pragma once
+
+#include "Level.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace rklog {
+
+/**
+ * Enum describing what a caller does when the queue of an asynchronous logger
+ * is full
+ */
+enum class OverflowPolicy : uint8_t
+{
+    BLOCK,           // Waits for the background thread to make room
+    SPIN_THEN_BLOCK, // Spins for a while before waiting, for short spikes
+    DROP_NEWEST,     // Drops the record being logged
+    DROP_OLDEST,     // Drops the oldest queued record to make room
+};
+
+/**
+ * Enum describing how the callers of an asynchronous logger share its queue
+ */
+enum class QueueMode : uint8_t
+{
+    SHARED,     // Every thread pushes onto one queue
+    PER_THREAD, // Every thread pushes onto a queue of its own
+};
+
+/**
+ * Class describing how an asynchronous logger queues its records. Records at
+ * or above the priority level go through a lane of their own which always
+ * blocks when full, so they are never dropped and their callers never wait for
+ * room behind a backlog of less severe records. They are still written in the
+ * order they were logged, after any older record of the other lane, as long
+ * as they reach their lane within the merge window
+ */
+class QueuePolicy final
+{
+public:
+    /**
+     * Gets the number of records the queue can hold
+     *
+     * @return
+     *      The capacity of the queue
+     */
+    constexpr size_t GetCapacity() const noexcept { return m_Capacity; }
+
+    /**
+     * Gets what a caller does when the queue is full
+     *
+     * @return
+     *      The overflow policy
+     */
+    constexpr OverflowPolicy GetOverflow() const noexcept { return m_Overflow; }
+
+    /**
+     * Gets the number of times a caller retries a full queue before waiting,
+     * used with `OverflowPolicy::SPIN_THEN_BLOCK` and by the priority lane
+     *
+     * @return
+     *      The number of retries
+     */
+    constexpr uint32_t GetSpinCount() const noexcept { return m_SpinCount; }
+
+    /**
+     * Gets the number of records the priority lane can hold
+     *
+     * @return
+     *      The capacity of the priority lane
+     */
+    constexpr size_t GetPriorityCapacity() const noexcept { return m_PriorityCapacity; }
+
+    /**
+     * Gets the log level from which records go through the priority lane
+     *
+     * @return
+     *      The log level
+     */
+    constexpr LogLevel GetPriorityLevel() const noexcept { return m_PriorityLevel; }
+
+    /**
+     * Checks whether a record goes through the priority lane, which never
+     * drops it
+     *
+     * @param[in] level
+     *      The log level of the record
+     *
+     * @return
+     *      `true` if the record goes through the priority lane
+     */
+    constexpr bool IsPriority(LogLevel level) const noexcept { return level >= m_PriorityLevel; }
+
+    /**
+     * Gets how the callers share the queue
+     *
+     * @return
+     *      The queue mode
+     */
+    constexpr QueueMode GetMode() const noexcept { return m_Mode; }
+
+    /**
+     * Gets the number of records the queue of each thread can hold, used with
+     * `QueueMode::PER_THREAD`
+     *
+     * @return
+     *      The capacity of the queue of each thread
+     */
+    constexpr size_t GetThreadCapacity() const noexcept { return m_ThreadCapacity; }
+
+    /**
+     * Gets the most threads that get a queue of their own at the same time,
+     * used with `QueueMode::PER_THREAD`. Any further threads share the queue
+     *
+     * @return
+     *      The number of per-thread queues
+     */
+    constexpr size_t GetMaxThreads() const noexcept { return m_MaxThreads; }
+
+    /**
+     * Gets how long the background thread holds back the oldest record while
+     * a lane has nothing queued, in case an older record of that lane is
+     * still being pushed
+     *
+     * @return
+     *      The merge window
+     */
+    constexpr std::chrono::microseconds GetMergeWindow() const noexcept { return m_MergeWindow; }
+
+    /**
+     * Gets the CPU the background thread is pinned to, if any
+     *
+     * @return
+     *      The index of the CPU
+     */
+    constexpr std::optional<uint32_t> GetConsumerCpu() const noexcept { return m_ConsumerCpu; }
+
+    /**
+     * Gets the NUMA node the background thread is pinned to, if any. It may
+     * run on any CPU of the node
+     *
+     * @return
+     *      The index of the NUMA node
+     */
+    constexpr std::optional<uint32_t> GetConsumerNode() const noexcept { return m_ConsumerNode; }
+
+private:
+    constexpr QueuePolicy() noexcept = default;
+
+private:
+    /// The number of records the queue can hold
+    size_t m_Capacity{8192};
+    /// What a caller does when the queue is full
+    OverflowPolicy m_Overflow{OverflowPolicy::SPIN_THEN_BLOCK};
+    /// The number of times a caller retries a full queue before waiting
+    uint32_t m_SpinCount{1024};
+    /// The number of records the priority lane can hold
+    size_t m_PriorityCapacity{1024};
+    /// The log level from which records go through the priority lane
+    LogLevel m_PriorityLevel{LogLevel::LOG_ERROR};
+    /// How the callers share the queue
+    QueueMode m_Mode{QueueMode::SHARED};
+    /// The number of records the queue of each thread can hold
+    size_t m_ThreadCapacity{1024};
+    /// The most threads that get a queue of their own at the same time
+    size_t m_MaxThreads{64};
+    /// How long the oldest record is held back while a lane is empty
+    std::chrono::microseconds m_MergeWindow{50};
+    /// The CPU the background thread is pinned to, if any
+    std::optional<uint32_t> m_ConsumerCpu{};
+    /// The NUMA node the background thread is pinned to, if any
+    std::optional<uint32_t> m_ConsumerNode{};
+
+    friend class QueuePolicyBuilder;
+};
+
+/**
+ * Class used for building queue policies
+ */
+class QueuePolicyBuilder final
+{
+public:
+    QueuePolicyBuilder(const QueuePolicyBuilder&) = delete;
+    QueuePolicyBuilder(QueuePolicyBuilder&&) = delete;
+
+    /**
+     * Sets the number of records the queue can hold, rounded up to the next
+     * power of two
+     *
+     * @param[in] capacity
+     *      The capacity of the queue
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetCapacity(size_t capacity) noexcept
+    {
+        m_Policy.m_Capacity = capacity;
+        return *this;
+    }
+
+    /**
+     * Sets what a caller does when the queue is full
+     *
+     * @param[in] overflow
+     *      The overflow policy
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetOverflow(OverflowPolicy overflow) noexcept
+    {
+        m_Policy.m_Overflow = overflow;
+        return *this;
+    }
+
+    /**
+     * Sets the number of times a caller retries a full queue before waiting
+     *
+     * @param[in] count
+     *      The number of retries
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetSpinCount(uint32_t count) noexcept
+    {
+        m_Policy.m_SpinCount = count;
+        return *this;
+    }
+
+    /**
+     * Sets the number of records the priority lane can hold, rounded up to
+     * the next power of two
+     *
+     * @param[in] capacity
+     *      The capacity of the priority lane
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetPriorityCapacity(size_t capacity) noexcept
+    {
+        m_Policy.m_PriorityCapacity = capacity;
+        return *this;
+    }
+
+    /**
+     * Sets the log level from which records go through the priority lane
+     *
+     * @param[in] level
+     *      The log level
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetPriorityLevel(LogLevel level) noexcept
+    {
+        m_Policy.m_PriorityLevel = level;
+        return *this;
+    }
+
+    /**
+     * Sets how the callers share the queue. With `QueueMode::PER_THREAD`,
+     * every thread gets a queue of its own the first time it logs, which it
+     * gives up again when it exits, and the background thread merges the
+     * queues in the order the records were logged. Only the background thread
+     * pops from those queues, so both drop policies drop the newest record
+     *
+     * @param[in] mode
+     *      The queue mode
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetMode(QueueMode mode) noexcept
+    {
+        m_Policy.m_Mode = mode;
+        return *this;
+    }
+
+    /**
+     * Sets the number of records the queue of each thread can hold, rounded
+     * up to the next power of two
+     *
+     * @param[in] capacity
+     *      The capacity of the queue of each thread
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetThreadCapacity(size_t capacity) noexcept
+    {
+        m_Policy.m_ThreadCapacity = capacity;
+        return *this;
+    }
+
+    /**
+     * Sets the most threads that get a queue of their own at the same time
+     *
+     * @param[in] count
+     *      The number of per-thread queues
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetMaxThreads(size_t count) noexcept
+    {
+        m_Policy.m_MaxThreads = count;
+        return *this;
+    }
+
+    /**
+     * Sets how long the background thread holds back the oldest record while
+     * a lane has nothing queued. A record is written once every lane has one
+     * queued or once it is that old, so records logged by different threads
+     * come out in order unless pushing one takes longer than the window. The
+     * background thread yields meanwhile, and a window of zero writes each
+     * record as soon as it is the oldest one queued
+     *
+     * @param[in] window
+     *      The merge window
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetMergeWindow(std::chrono::microseconds window) noexcept
+    {
+        m_Policy.m_MergeWindow = window;
+        return *this;
+    }
+
+    /**
+     * Sets the CPU the background thread is pinned to
+     *
+     * @param[in] cpu
+     *      The index of the CPU, or `std::nullopt` to let it run anywhere
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetConsumerCpu(std::optional<uint32_t> cpu) noexcept
+    {
+        m_Policy.m_ConsumerCpu = cpu;
+        return *this;
+    }
+
+    /**
+     * Sets the NUMA node the background thread is pinned to. Ignored if a
+     * CPU is set as well
+     *
+     * @param[in] node
+     *      The index of the NUMA node, or `std::nullopt` to let it run
+     *      anywhere
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr QueuePolicyBuilder& SetConsumerNode(std::optional<uint32_t> node) noexcept
+    {
+        m_Policy.m_ConsumerNode = node;
+        return *this;
+    }
+
+    /**
+     * Finalizes the build for the queue policy
+     *
+     * @return
+     *      The final queue policy
+     */
+    [[nodiscard]] constexpr QueuePolicy&& Build() noexcept { return std::move(m_Policy); }
+
+private:
+    constexpr QueuePolicyBuilder() noexcept = default;
+
+private:
+    /// The policy being built
+    QueuePolicy m_Policy{};
+
+    friend constexpr QueuePolicyBuilder InitBuildQueuePolicy() noexcept;
+};
+
+/**
+ * Initializes the building of a queue policy
+ *
+ * @return
+ *      An instance of the queue policy builder
+ */
+[[nodiscard]] constexpr QueuePolicyBuilder InitBuildQueuePolicy() noexcept
+{
+    return QueuePolicyBuilder();
+}
+
+}
+
+namespace rklog::defaults {
+
+constexpr QueuePolicy DEFAULT_QUEUE_POLICY = InitBuildQueuePolicy().Build();
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace rklog {
+
+/**
+ * Class describing when a file logger moves on to a new file and what happens
+ * to the files it rotated away from
+ */
+class RotationPolicy final
+{
+public:
+    /**
+     * Gets the size after which the file is rotated
+     *
+     * @return
+     *      The maximum size of a file in bytes, zero if unlimited
+     */
+    constexpr uint64_t GetMaxSize() const noexcept { return m_MaxSize; }
+
+    /**
+     * Gets the wall-clock interval at which the file is rotated
+     *
+     * @return
+     *      The interval, zero if the file is not rotated by time
+     */
+    constexpr std::chrono::seconds GetInterval() const noexcept { return m_Interval; }
+
+    /**
+     * Gets the number of rotated files that are kept
+     *
+     * @return
+     *      The number of files, zero if every file is kept
+     */
+    constexpr uint32_t GetMaxFiles() const noexcept { return m_MaxFiles; }
+
+    /**
+     * Checks whether rotated files are compressed
+     *
+     * @return
+     *      `true` if rotated files are compressed with gzip
+     */
+    constexpr bool IsCompressing() const noexcept { return m_Compress; }
+
+    /**
+     * Checks whether the file is ever rotated
+     *
+     * @return
+     *      `true` if a size or an interval is set
+     */
+    constexpr bool IsEnabled() const noexcept { return m_MaxSize > 0 || m_Interval.count() > 0; }
+
+private:
+    constexpr RotationPolicy() noexcept = default;
+
+private:
+    /// The maximum size of a file in bytes
+    uint64_t m_MaxSize{};
+    /// The wall-clock interval at which the file is rotated
+    std::chrono::seconds m_Interval{};
+    /// The number of rotated files that are kept
+    uint32_t m_MaxFiles{};
+    /// Whether rotated files are compressed
+    bool m_Compress{};
+
+    friend class RotationPolicyBuilder;
+};
+
+/**
+ * Class used for building rotation policies
+ */
+class RotationPolicyBuilder final
+{
+public:
+    RotationPolicyBuilder(const RotationPolicyBuilder&) = delete;
+    RotationPolicyBuilder(RotationPolicyBuilder&&) = delete;
+
+    /**
+     * Sets the size after which the file is rotated. A record is never split
+     * across files, so a file can exceed the size by less than one record
+     *
+     * @param[in] size
+     *      The maximum size of a file in bytes
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr RotationPolicyBuilder& SetMaxSize(uint64_t size) noexcept
+    {
+        m_Policy.m_MaxSize = size;
+        return *this;
+    }
+
+    /**
+     * Sets the wall-clock interval at which the file is rotated. Rotations are
+     * aligned to multiples of the interval since the Unix epoch, so an hourly
+     * interval rotates on the hour and a daily one at midnight UTC
+     *
+     * @param[in] interval
+     *      The interval
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr RotationPolicyBuilder& SetInterval(std::chrono::seconds interval) noexcept
+    {
+        m_Policy.m_Interval = interval;
+        return *this;
+    }
+
+    /**
+     * Sets the number of rotated files that are kept, the oldest ones are
+     * deleted beyond it
+     *
+     * @param[in] count
+     *      The number of files
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr RotationPolicyBuilder& SetMaxFiles(uint32_t count) noexcept
+    {
+        m_Policy.m_MaxFiles = count;
+        return *this;
+    }
+
+    /**
+     * Sets whether rotated files are compressed with gzip. Compression runs
+     * on a background thread
+     *
+     * @param[in] compress
+     *      Whether to compress rotated files
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr RotationPolicyBuilder& SetCompression(bool compress) noexcept
+    {
+        m_Policy.m_Compress = compress;
+        return *this;
+    }
+
+    /**
+     * Finalizes the build for the rotation policy
+     *
+     * @return
+     *      The final rotation policy
+     */
+    [[nodiscard]] constexpr RotationPolicy&& Build() noexcept { return std::move(m_Policy); }
+
+private:
+    constexpr RotationPolicyBuilder() noexcept = default;
+
+private:
+    /// The policy being built
+    RotationPolicy m_Policy{};
+
+    friend constexpr RotationPolicyBuilder InitBuildRotationPolicy() noexcept;
+};
+
+/**
+ * Initializes the building of a rotation policy
+ *
+ * @return
+ *      An instance of the rotation policy builder
+ */
+[[nodiscard]] constexpr RotationPolicyBuilder InitBuildRotationPolicy() noexcept
+{
+    return RotationPolicyBuilder();
+}
+
+}
+
+namespace rklog::defaults {
+
+constexpr RotationPolicy DEFAULT_ROTATION_POLICY = InitBuildRotationPolicy().Build();
+
+}
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "Config.hpp"
+#include "Pattern.hpp"
 
 #include "../Core/Platform.hpp"
+#include "../Core/Record.hpp"
+#include "../Core/Time.hpp"
+
+#include <optional>
+#include <string>
 
 namespace rklog {
 
@@ -35,9 +41,68 @@ public:
         RKLOG_UNREACHABLE();
     }
 
+    /**
+     * Gets the format of the timestamps
+     *
+     * @return
+     *      The format of the timestamps
+     */
+    constexpr TimeFormat GetTimeFormat() const noexcept { return m_TimeFormat; }
+
+    /**
+     * Gets the clock that timestamps are taken from
+     *
+     * @return
+     *      The clock source of the timestamps
+     */
+    constexpr ClockSource GetClockSource() const noexcept { return m_ClockSource; }
+
+    /**
+     * Gets the compiled pattern of the log lines
+     *
+     * @return
+     *      The compiled pattern
+     */
+    constexpr const LogPattern& GetPattern() const noexcept { return m_Pattern; }
+
+    /**
+     * Writes a log line for the record by walking the compiled pattern
+     *
+     * @param[out] out
+     *      The string to append the log line to
+     * @param[in] record
+     *      The record to write
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] color
+     *      Whether the `{color}` field should write the color of the level
+     */
+    void FormatTo(std::string& out, const LogRecord& record, const std::optional<std::string>& title, bool color) const;
+
+    /**
+     * Writes a log line for the record without color, marking where the
+     * color of the level would go instead. The line can then be written both
+     * with and without color without walking the pattern twice
+     *
+     * @param[out] out
+     *      The string to append the log line to
+     * @param[in] record
+     *      The record to write
+     * @param[in] title
+     *      The title of the logger
+     * @param[out] marks
+     *      The decorations of the line, with offsets into `out`
+     */
+    void FormatTo(std::string& out, const LogRecord& record, const std::optional<std::string>& title, ColorMarks& marks) const;
+
 private:
     constexpr LogStyle() = default;
 
+    /**
+     * Walks the compiled pattern, see `FormatTo()`
+     */
+    void Render(std::string& out, const LogRecord& record, const std::optional<std::string>& title, bool color, ColorMarks* marks) const;
+
 private:
     /// The configuration for debug logs
     LogConfig m_CfgDebug{defaults::DEBUG_CFG};
@@ -49,6 +114,16 @@ private:
     LogConfig m_CfgError{defaults::ERROR_CFG};
     /// The configuration for fatal logs
     LogConfig m_CfgFatal{defaults::FATAL_CFG};
+    /// The format of the timestamps
+    TimeFormat m_TimeFormat{};
+    /// The compiled pattern of the log lines
+    LogPattern m_Pattern{defaults::DEFAULT_PATTERN};
+    /// The clock that timestamps are taken from
+#if defined(RKLOG_USE_TSC_CLOCK)
+    ClockSource m_ClockSource{ClockSource::TSC};
+#else
+    ClockSource m_ClockSource{ClockSource::SYSTEM};
+#endif
 
     friend class LogStyleBuilder;
 };
@@ -95,6 +170,60 @@ public:
         RKLOG_UNREACHABLE();
     }
 
+    /**
+     * Sets the format of the timestamps
+     *
+     * @param[in] format
+     *      The format of the timestamps
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr LogStyleBuilder& SetTimeFormat(TimeFormat format) noexcept
+    {
+        m_Style.m_TimeFormat = format;
+        return *this;
+    }
+
+    /**
+     * Sets the pattern of the log lines. The pattern is compiled right away,
+     * see `rklog::LogPattern` for its syntax. A pattern that does not fit is
+     * rejected and the previous pattern is kept, which `IsValid()` of a
+     * `rklog::LogPattern` compiled from the same text tells beforehand
+     *
+     * @param[in] pattern
+     *      The pattern of the log lines, copied into the style
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr LogStyleBuilder& SetPattern(std::string_view pattern) noexcept
+    {
+        const LogPattern compiled(pattern);
+        if (compiled.IsValid())
+            m_Style.m_Pattern = compiled;
+
+        return *this;
+    }
+
+    /**
+     * Sets the clock that timestamps are taken from. The cycle counter is
+     * the cheapest to read but assumes an invariant TSC, which holds on any
+     * recent x86 CPU. Defaults to the system clock, unless
+     * `RKLOG_USE_TSC_CLOCK` is defined
+     *
+     * @param[in] source
+     *      The clock source of the timestamps
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr LogStyleBuilder& SetClockSource(ClockSource source) noexcept
+    {
+        m_Style.m_ClockSource = source;
+        return *this;
+    }
+
     /**
      * Finalizes the build for the style
      *
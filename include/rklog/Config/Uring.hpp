@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace rklog {
+
+/**
+ * Enum describing how durable a write is once it completes
+ */
+enum class SyncMode : uint8_t
+{
+    NONE, // Completes once the data is in the page cache
+    DATA, // Followed by `fdatasync()`, the data and the size reach the disk
+    FULL, // Followed by `fsync()`, the metadata reaches the disk as well
+};
+
+/**
+ * Class describing how a `rklog::UringFileSink` hands its buffers to the
+ * kernel
+ */
+class UringPolicy final
+{
+public:
+    /**
+     * Gets the number of buffers, each the size given by the flush policy.
+     * One of them is filled while the others are being written
+     *
+     * @return
+     *      The number of buffers
+     */
+    constexpr size_t GetBufferCount() const noexcept { return m_BufferCount; }
+
+    /**
+     * Gets how durable a write is once it completes
+     *
+     * @return
+     *      The sync mode
+     */
+    constexpr SyncMode GetSyncMode() const noexcept { return m_SyncMode; }
+
+    /**
+     * Checks whether io_uring is used when the kernel supports it, rather
+     * than always falling back to `writev()`
+     *
+     * @return
+     *      `true` if io_uring is used when available
+     */
+    constexpr bool IsUringEnabled() const noexcept { return m_UringEnabled; }
+
+private:
+    constexpr UringPolicy() noexcept = default;
+
+private:
+    /// The number of buffers
+    size_t m_BufferCount{8};
+    /// How durable a write is once it completes
+    SyncMode m_SyncMode{SyncMode::NONE};
+    /// Whether io_uring is used when available
+    bool m_UringEnabled{true};
+
+    friend class UringPolicyBuilder;
+};
+
+/**
+ * Class used for building io_uring policies
+ */
+class UringPolicyBuilder final
+{
+public:
+    UringPolicyBuilder(const UringPolicyBuilder&) = delete;
+    UringPolicyBuilder(UringPolicyBuilder&&) = delete;
+
+    /**
+     * Sets the number of buffers, at least two are used
+     *
+     * @param[in] count
+     *      The number of buffers
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr UringPolicyBuilder& SetBufferCount(size_t count) noexcept
+    {
+        m_Policy.m_BufferCount = count;
+        return *this;
+    }
+
+    /**
+     * Sets how durable a write is once it completes
+     *
+     * @param[in] mode
+     *      The sync mode
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr UringPolicyBuilder& SetSyncMode(SyncMode mode) noexcept
+    {
+        m_Policy.m_SyncMode = mode;
+        return *this;
+    }
+
+    /**
+     * Sets whether io_uring is used when the kernel supports it
+     *
+     * @param[in] enabled
+     *      `false` to always write with `writev()`
+     *
+     * @return
+     *      This instance of the builder
+     */
+    [[nodiscard]] constexpr UringPolicyBuilder& SetUringEnabled(bool enabled) noexcept
+    {
+        m_Policy.m_UringEnabled = enabled;
+        return *this;
+    }
+
+    /**
+     * Finalizes the build for the io_uring policy
+     *
+     * @return
+     *      The final io_uring policy
+     */
+    [[nodiscard]] constexpr UringPolicy&& Build() noexcept { return std::move(m_Policy); }
+
+private:
+    constexpr UringPolicyBuilder() noexcept = default;
+
+private:
+    /// The policy being built
+    UringPolicy m_Policy{};
+
+    friend constexpr UringPolicyBuilder InitBuildUringPolicy() noexcept;
+};
+
+/**
+ * Initializes the building of an io_uring policy
+ *
+ * @return
+ *      An instance of the io_uring policy builder
+ */
+[[nodiscard]] constexpr UringPolicyBuilder InitBuildUringPolicy() noexcept
+{
+    return UringPolicyBuilder();
+}
+
+}
+
+namespace rklog::defaults {
+
+constexpr UringPolicy DEFAULT_URING_POLICY = InitBuildUringPolicy().Build();
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../Config/Rotation.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rklog {
+
+/**
+ * Class taking care of the files a file logger rotated away from. Rotated
+ * files are named after the log file with an increasing sequence number
+ * appended (e.g. `app.log.7`), and are compressed and pruned according to the
+ * rotation policy on a background thread
+ */
+class FileArchiver final
+{
+public:
+    /**
+     * Creates an archiver for a log file. The sequence numbers continue after
+     * the rotated files already next to the log file
+     *
+     * @param[in] filePath
+     *      The path to the log file
+     * @param[in] policy
+     *      The rotation policy of the log file
+     */
+    FileArchiver(const std::filesystem::path& filePath, RotationPolicy policy) noexcept;
+
+    FileArchiver(const FileArchiver&) = delete;
+    FileArchiver(FileArchiver&&) = delete;
+
+    /**
+     * Finishes the pending work and stops the background thread
+     */
+    ~FileArchiver() noexcept;
+
+    /**
+     * Gets the path to rotate the log file to
+     *
+     * @return
+     *      The path with the next sequence number
+     */
+    std::filesystem::path NextPath() noexcept;
+
+    /**
+     * Hands a rotated file to the background thread for compression and
+     * pruning. Returns right away
+     *
+     * @param[in] rotatedPath
+     *      The path the log file was rotated to
+     */
+    void Submit(std::filesystem::path rotatedPath) noexcept;
+
+private:
+    /**
+     * The loop of the background thread
+     */
+    void Run() noexcept;
+
+    /**
+     * Compresses a rotated file, replacing it with a `.gz` file
+     *
+     * @param[in] rotatedPath
+     *      The path to the rotated file
+     */
+    void Compress(const std::filesystem::path& rotatedPath) const noexcept;
+
+    /**
+     * Deletes the oldest rotated files beyond the retention count
+     */
+    void Prune() const noexcept;
+
+    /**
+     * Parses the sequence number of a rotated file
+     *
+     * @param[in] fileName
+     *      The name of a file next to the log file
+     * @param[out] sequence
+     *      The sequence number of the rotated file
+     *
+     * @return
+     *      `true` if the file is a rotated log file
+     */
+    bool ParseSequence(const std::filesystem::path& fileName, uint64_t& sequence) const noexcept;
+
+private:
+    /// The path to the log file
+    std::filesystem::path m_Path;
+    /// The rotation policy of the log file
+    RotationPolicy m_Policy;
+    /// The sequence number of the last rotated file
+    uint64_t m_Sequence{};
+    /// Protects the pending files
+    std::mutex m_Mutex{};
+    /// Wakes the background thread
+    std::condition_variable m_Signal{};
+    /// The rotated files waiting for the background thread
+    std::vector<std::filesystem::path> m_Pending{};
+    /// A flag indicating whether the background thread should stop
+    bool m_Stop{};
+    /// The background thread, started on the first rotation
+    std::thread m_Worker{};
+};
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// --- binary log format ------------------------------------------------------
+//
+// A binary log starts with a header, followed by a stream of entries that each
+// start with a tag byte. Integers are LEB128 varints, signed ones zigzag
+// encoded first, and strings are a varint length followed by the characters
+//
+// header:  "RKLOGBIN", version (1 byte), title flag (1 byte), title, pattern,
+//          time precision, UTC flag, ISO-8601 flag (1 byte each), the five
+//          level tags from debug to fatal, start time (signed nanoseconds
+//          since the epoch)
+// format:  FORMAT_TAG, format string, source file, source line, function,
+//          argument count, argument types (1 byte each, see `ArgType`)
+// record:  RECORD_TAG + level, format id, time delta to the previous record
+//          (signed nanoseconds), thread id, arguments
+//
+// Formats are numbered in the order they appear, starting at zero. Arguments
+// are written per type: integers and pointers as varints, `char` and `bool`
+// as a single byte, floating points as their little endian bytes
+
+namespace rklog::binary {
+
+/// The bytes every binary log starts with
+constexpr std::string_view MAGIC = "RKLOGBIN";
+/// The version of the format
+constexpr uint8_t VERSION = 1;
+/// The tag of an entry defining a format
+constexpr uint8_t FORMAT_TAG = 0x01;
+/// The tag of a record entry, plus its log level
+constexpr uint8_t RECORD_TAG = 0x10;
+
+/**
+ * Appends an unsigned integer as a varint
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] value
+ *      The value to write
+ */
+inline void WriteVarint(std::string& out, uint64_t value) noexcept
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Appends a signed integer as a zigzag encoded varint
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] value
+ *      The value to write
+ */
+inline void WriteSignedVarint(std::string& out, int64_t value) noexcept
+{
+    WriteVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+/**
+ * Appends a string prefixed with its length
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] value
+ *      The string to write
+ */
+inline void WriteString(std::string& out, std::string_view value) noexcept
+{
+    WriteVarint(out, value.size());
+    out.append(value);
+}
+
+/**
+ * Reads a varint
+ *
+ * @param[in,out] data
+ *      The data to read from, advanced past the varint
+ * @param[out] value
+ *      The value read
+ *
+ * @return
+ *      `false` if the data ends before the varint does
+ */
+inline bool ReadVarint(std::string_view& data, uint64_t& value) noexcept
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64 && !data.empty(); shift += 7)
+    {
+        const auto byte = static_cast<uint8_t>(data.front());
+        data.remove_prefix(1);
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Reads a zigzag encoded varint
+ *
+ * @param[in,out] data
+ *      The data to read from, advanced past the varint
+ * @param[out] value
+ *      The value read
+ *
+ * @return
+ *      `false` if the data ends before the varint does
+ */
+inline bool ReadSignedVarint(std::string_view& data, int64_t& value) noexcept
+{
+    uint64_t raw{};
+    if (!ReadVarint(data, raw))
+        return false;
+
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+}
+
+/**
+ * Reads a string prefixed with its length
+ *
+ * @param[in,out] data
+ *      The data to read from, advanced past the string
+ * @param[out] value
+ *      The string read, pointing into the data
+ *
+ * @return
+ *      `false` if the data ends before the string does
+ */
+inline bool ReadString(std::string_view& data, std::string_view& value) noexcept
+{
+    uint64_t length{};
+    if (!ReadVarint(data, length) || length > data.size())
+        return false;
+
+    value = data.substr(0, length);
+    data.remove_prefix(length);
+    return true;
+}
+
+}
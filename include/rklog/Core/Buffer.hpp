@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace rklog {
+
+/**
+ * Class lending out one of the reusable format buffers of the calling thread.
+ * The buffers keep their capacity between logs, so once they have grown to
+ * the size of the largest log line, formatting into them no longer allocates
+ *
+ * Buffers are lent out in a stack, so a formatter that logs itself gets a
+ * buffer of its own. Past `MAX_DEPTH` nested logs a local string is used
+ */
+class FormatBuffer final
+{
+public:
+    /// The number of buffers each thread keeps
+    static constexpr size_t MAX_DEPTH = 4;
+    /// Buffers that have grown beyond this capacity are released on return
+    static constexpr size_t MAX_RETAINED_CAPACITY = 64 * 1024;
+
+public:
+    /**
+     * Borrows an empty buffer from the calling thread
+     */
+    FormatBuffer() noexcept
+    {
+        Pool& pool = GetPool();
+        m_Buffer = pool.depth < MAX_DEPTH ? &pool.buffers[pool.depth++] : &m_Fallback;
+        m_Buffer->clear();
+    }
+
+    FormatBuffer(const FormatBuffer&) = delete;
+    FormatBuffer& operator=(const FormatBuffer&) = delete;
+
+    /**
+     * Returns the buffer to the calling thread
+     */
+    ~FormatBuffer() noexcept
+    {
+        if (m_Buffer == &m_Fallback)
+            return;
+
+        if (m_Buffer->capacity() > MAX_RETAINED_CAPACITY)
+            std::string().swap(*m_Buffer);
+
+        GetPool().depth--;
+    }
+
+    /**
+     * Gets the borrowed buffer
+     *
+     * @return
+     *      The buffer
+     */
+    inline std::string& operator*() noexcept { return *m_Buffer; }
+
+    /**
+     * Gets the borrowed buffer
+     *
+     * @return
+     *      The buffer
+     */
+    inline std::string* operator->() noexcept { return m_Buffer; }
+
+private:
+    /**
+     * Struct containing the buffers of a thread
+     */
+    struct Pool
+    {
+        /// The buffers of the thread
+        std::array<std::string, MAX_DEPTH> buffers{};
+        /// The number of buffers currently lent out
+        size_t depth{};
+    };
+
+private:
+    /**
+     * Gets the buffers of the calling thread
+     *
+     * @return
+     *      The buffers of the calling thread
+     */
+    static Pool& GetPool() noexcept
+    {
+        thread_local Pool pool{};
+        return pool;
+    }
+
+private:
+    /// The borrowed buffer
+    std::string* m_Buffer{};
+    /// The buffer used when every buffer of the thread is lent out
+    std::string m_Fallback{};
+};
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include <cstdint>
+
+#if defined(RKLOG_COMPILER_MSVC)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace rklog {
+
+/**
+ * Enum describing the clock that timestamps are taken from
+ */
+enum class ClockSource : uint8_t
+{
+    SYSTEM, // The portable system clock
+    TSC,    // The CPU cycle counter, converted to wall time when formatted
+};
+
+/**
+ * Struct describing how cycle counter ticks are mapped to wall time
+ */
+struct TscCalibration final
+{
+public:
+    double ticksPerSecond{};    // The measured frequency of the cycle counter
+    int64_t errorNanoseconds{}; // The offset from `system_clock` at the last calibration
+};
+
+/**
+ * Clock reading the CPU cycle counter. A background thread periodically maps
+ * the counter onto `std::chrono::system_clock`, so that reading the clock
+ * only costs a single instruction and the conversion to wall time is deferred
+ * until the timestamp is formatted
+ */
+class TscClock final
+{
+public:
+    TscClock() = delete;
+
+    /**
+     * Checks whether the cycle counter can be read on this platform
+     *
+     * @return
+     *      `true` if the cycle counter is available
+     */
+    static constexpr bool IsSupported() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Reads the cycle counter
+     *
+     * @return
+     *      The current value of the cycle counter
+     */
+    static inline uint64_t Ticks() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * Converts a value of the cycle counter to nanoseconds since the Unix
+     * epoch. Starts the calibration on first use
+     *
+     * @param[in] ticks
+     *      The value of the cycle counter
+     *
+     * @return
+     *      The nanoseconds since the epoch
+     */
+    static int64_t ToNanoseconds(uint64_t ticks) noexcept;
+
+    /**
+     * Starts the calibration if it has not been started yet. Calling this
+     * up front avoids the short initial measurement on the first conversion
+     */
+    static void Calibrate() noexcept;
+
+    /**
+     * Gets the current calibration of the clock
+     *
+     * @return
+     *      The calibration, including its error relative to `system_clock`
+     */
+    static TscCalibration GetCalibration() noexcept;
+};
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace rklog {
+
+/// The default time a crash handler waits for queued records to be written
+constexpr std::chrono::milliseconds DEFAULT_CRASH_DRAIN_TIMEOUT{1000};
+
+/**
+ * Enum describing when a crash hook runs. Queues are drained before buffers,
+ * so that the records they hand on end up in the buffers drained after them
+ */
+enum class CrashStage : uint8_t
+{
+    QUEUE,  // Waits for queued records to be written, polled until done
+    BUFFER, // Writes a buffer out to its file descriptor, run once
+};
+
+/**
+ * Drains something holding records when the process is about to die. Runs in
+ * a signal handler, so it must only make async-signal-safe calls: atomics,
+ * `write()` and the like, but no locks, allocations or formatting
+ *
+ * @param[in] context
+ *      The pointer the hook was registered with
+ *
+ * @return
+ *      `true` once there is nothing left to drain
+ */
+using CrashHook = bool (*)(void* context) noexcept;
+
+/**
+ * Registers a hook run when the process crashes, see
+ * `rklog::InstallCrashHandler()`. Hooks are kept in a fixed table, so that
+ * the crash handler can walk it without locking
+ *
+ * @param[in] stage
+ *      When the hook runs
+ * @param[in] hook
+ *      The hook
+ * @param[in] context
+ *      The pointer passed to the hook
+ *
+ * @return
+ *      The slot of the hook, `SIZE_MAX` if the table is full
+ */
+size_t RegisterCrashHook(CrashStage stage, CrashHook hook, void* context) noexcept;
+
+/**
+ * Unregisters a crash hook
+ *
+ * @param[in] slot
+ *      The slot returned by `rklog::RegisterCrashHook()`, `SIZE_MAX` is
+ *      ignored
+ */
+void UnregisterCrashHook(size_t slot) noexcept;
+
+/**
+ * Runs every crash hook: waits for the queues to drain, up to the timeout
+ * given to `rklog::InstallCrashHandler()`, then writes out the buffers.
+ * Async-signal-safe
+ */
+void DrainOnCrash() noexcept;
+
+/**
+ * Installs handlers for fatal signals (`SIGSEGV`, `SIGBUS`, `SIGFPE`,
+ * `SIGILL` and `SIGABRT`) and for `std::terminate()` that drain the records
+ * held by asynchronous loggers and file buffers before the process dies. The
+ * previous handlers run afterwards, so the process still dies the way it
+ * would have, core dump included
+ *
+ * Other threads keep running while the handler drains. A buffer that is being
+ * written to at the same moment may lose or repeat a line
+ *
+ * The handler runs on a stack of its own only on threads that have one, which
+ * the calling thread gets here. A stack overflow on any other thread runs the
+ * handler on the exhausted stack, so the process dies without draining unless
+ * that thread called `rklog::InstallCrashStack()`
+ *
+ * @param[in] drainTimeout
+ *      How long to wait for queued records to be written
+ */
+void InstallCrashHandler(std::chrono::milliseconds drainTimeout = DEFAULT_CRASH_DRAIN_TIMEOUT) noexcept;
+
+/**
+ * Gives the calling thread a stack of its own to run the crash handler on,
+ * so that records are still drained when that thread overflows its stack.
+ * Meant to be called at the start of worker threads. Does nothing if the
+ * thread already has an alternate signal stack, and is not supported on
+ * Windows
+ *
+ * @return
+ *      `true` if the thread has an alternate signal stack
+ */
+bool InstallCrashStack() noexcept;
+
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace rklog {
+
+/**
+ * Customization point describing how an argument is copied into a deferred
+ * message and how it is read back when the message is finally formatted
+ *
+ * A specialization has to provide:
+ *
+ * - `Decoded`: a formattable type that is produced when reading it back
+ * - `static size_t Size(const T&)`: the number of bytes needed to store it
+ * - `static void Encode(std::byte* dst, const T&)`: writes `Size()` bytes
+ * - `static Decoded Decode(const std::byte*& src)`: reads it back and
+ *   advances `src` past the bytes that were written by `Encode()`
+ *
+ * Strings, arithmetic types, enums and pointers, which are formatted as their
+ * address, are supported out of the box. Other trivially copyable types can
+ * be copied by value by specializing `rklog::DEFER_BY_VALUE`, as long as they
+ * do not merely point to their data, which may be gone by the time the
+ * message is formatted
+ */
+template<typename T>
+struct ArgCodec;
+
+/**
+ * Opts a trivially copyable type into being captured by copying its bytes.
+ * Must only be set for types that own everything they format, never for
+ * views, spans or types holding pointers to their data
+ */
+template<typename T>
+inline constexpr bool DEFER_BY_VALUE = std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+    std::is_pointer_v<T> || std::is_null_pointer_v<T>;
+
+/**
+ * Concept for types that are treated as strings by the deferred formatting
+ */
+template<typename T>
+concept DeferredString = std::same_as<T, std::string> || std::same_as<T, std::string_view> ||
+    std::same_as<T, const char*> || std::same_as<T, char*>;
+
+/**
+ * The codec used for an argument of the given type. Arrays, such as string
+ * literals, are stored as pointers to const
+ */
+template<typename T>
+using ArgCodecOf = ArgCodec<std::decay_t<const std::remove_reference_t<T>>>;
+
+/**
+ * Concept for types that have a codec and can thus be deferred
+ */
+template<typename T>
+concept DeferrableArg = requires { sizeof(ArgCodecOf<T>); };
+
+/**
+ * Enum describing the type of a captured argument, for readers of the raw
+ * bytes that cannot see the codec. Arguments of other types are `CUSTOM`
+ */
+enum class ArgType : uint8_t
+{
+    CUSTOM,
+    BOOL,
+    CHAR,
+    INT8,
+    INT16,
+    INT32,
+    INT64,
+    UINT8,
+    UINT16,
+    UINT32,
+    UINT64,
+    FLOAT,
+    DOUBLE,
+    STRING,  // A `uint32_t` length followed by the characters
+    POINTER,
+};
+
+/**
+ * Gets the type of a captured argument of the given type
+ *
+ * @return
+ *      The type as seen by readers of the raw bytes
+ */
+template<typename T>
+consteval ArgType ArgTypeOf() noexcept
+{
+    using Stored = std::decay_t<const std::remove_reference_t<T>>;
+    if constexpr (DeferredString<Stored>)
+        return ArgType::STRING;
+    else if constexpr (std::same_as<Stored, bool>)
+        return ArgType::BOOL;
+    else if constexpr (std::same_as<Stored, char>)
+        return ArgType::CHAR;
+    else if constexpr (std::same_as<Stored, float>)
+        return ArgType::FLOAT;
+    else if constexpr (std::same_as<Stored, double>)
+        return ArgType::DOUBLE;
+    else if constexpr (std::is_pointer_v<Stored> || std::is_null_pointer_v<Stored>)
+        return ArgType::POINTER;
+    else if constexpr (std::is_integral_v<Stored> && sizeof(Stored) <= sizeof(uint64_t))
+    {
+        constexpr size_t SIZE_INDEX = std::bit_width(sizeof(Stored)) - 1;
+        constexpr ArgType SIGNED[] = { ArgType::INT8, ArgType::INT16, ArgType::INT32, ArgType::INT64 };
+        constexpr ArgType UNSIGNED[] = { ArgType::UINT8, ArgType::UINT16, ArgType::UINT32, ArgType::UINT64 };
+        return std::is_signed_v<Stored> ? SIGNED[SIZE_INDEX] : UNSIGNED[SIZE_INDEX];
+    }
+    else
+        return ArgType::CUSTOM;
+}
+
+/**
+ * The types of the captured arguments of a call. Padded by one element so
+ * that each list of types has a distinct address, even an empty one
+ */
+template<typename ... Args>
+inline constexpr std::array<ArgType, sizeof...(Args) + 1> ARG_SIGNATURE{ArgTypeOf<Args>()..., ArgType::CUSTOM};
+
+/**
+ * Codec for types that are captured by value, see `rklog::DEFER_BY_VALUE`.
+ * The bytes of the value are copied as-is
+ */
+template<typename T>
+    requires (DEFER_BY_VALUE<T> && std::is_trivially_copyable_v<T> && !DeferredString<T>)
+struct ArgCodec<T>
+{
+    using Decoded = T;
+
+    static constexpr size_t Size(const T&) noexcept { return sizeof(T); }
+
+    static void Encode(std::byte* dst, const T& value) noexcept
+    {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+
+    static Decoded Decode(const std::byte*& src) noexcept
+    {
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), src, sizeof(T));
+        src += sizeof(T);
+
+        return std::bit_cast<T>(raw);
+    }
+};
+
+/**
+ * Codec for strings. The characters are copied after their length, so the
+ * string does not need to outlive the call
+ */
+template<DeferredString T>
+struct ArgCodec<T>
+{
+    using Decoded = std::string_view;
+
+    static size_t Size(const T& value) noexcept { return sizeof(uint32_t) + std::string_view(value).size(); }
+
+    static void Encode(std::byte* dst, const T& value) noexcept
+    {
+        const std::string_view str(value);
+        const auto length = static_cast<uint32_t>(str.size());
+
+        std::memcpy(dst, &length, sizeof(length));
+        std::memcpy(dst + sizeof(length), str.data(), str.size());
+    }
+
+    static Decoded Decode(const std::byte*& src) noexcept
+    {
+        uint32_t length{};
+        std::memcpy(&length, src, sizeof(length));
+
+        const auto* const str = reinterpret_cast<const char*>(src + sizeof(length));
+        src += sizeof(length) + length;
+
+        return std::string_view(str, length);
+    }
+};
+
+/**
+ * Class containing a format string together with a binary snapshot of its
+ * arguments, so that the actual formatting can happen later and on another
+ * thread
+ */
+class DeferredMessage final
+{
+public:
+    /// The number of bytes available for the arguments
+    static constexpr size_t CAPACITY = 192;
+
+public:
+    constexpr DeferredMessage() noexcept = default;
+
+    /**
+     * Captures the format string and the arguments of a log call
+     *
+     * @param[in] fmt
+     *      The format of the message. Assumed to have been checked against the
+     *      arguments at compile time and to have static storage duration
+     * @param[in] args
+     *      The arguments for the format
+     *
+     * @return
+     *      `true` if the arguments fit into the message, `false` if the caller
+     *      has to format the message itself
+     */
+    template<typename ... Args>
+        requires (DeferrableArg<Args> && ...)
+    bool Capture(std::string_view fmt, const Args& ... args) noexcept
+    {
+        const std::array<size_t, sizeof...(Args)> sizes{ArgCodecOf<Args>::Size(args)...};
+
+        size_t total{};
+        for (const size_t size : sizes)
+            total += size;
+
+        if (total > CAPACITY)
+            return false;
+
+        [[maybe_unused]] std::byte* dst = m_Args.data();
+        [[maybe_unused]] size_t idx{};
+        ((ArgCodecOf<Args>::Encode(dst, args), dst += sizes[idx++]), ...);
+
+        m_Format = fmt;
+        m_Formatter = &FormatArgs<ArgCodecOf<Args>...>;
+        m_Signature = std::span<const ArgType>(ARG_SIGNATURE<Args...>.data(), sizeof...(Args));
+        m_Size = total;
+        return true;
+    }
+
+    /**
+     * Formats the captured message and appends it to the output
+     *
+     * @param[out] out
+     *      The string to append the formatted message to
+     */
+    void FormatTo(std::string& out) const
+    {
+        m_Formatter(out, m_Format, m_Args.data());
+    }
+
+    /**
+     * Gets the captured format
+     *
+     * @return
+     *      The format of the message
+     */
+    constexpr std::string_view GetFormat() const noexcept { return m_Format; }
+
+    /**
+     * Gets the types of the captured arguments. The address of the list is
+     * the same for every message captured with the same types
+     *
+     * @return
+     *      The types of the arguments, in order
+     */
+    constexpr std::span<const ArgType> GetSignature() const noexcept { return m_Signature; }
+
+    /**
+     * Gets the encoded arguments. Arguments with a type other than `CUSTOM`
+     * are stored as their raw bytes, strings as described by `ArgType`
+     *
+     * @return
+     *      The bytes of the arguments
+     */
+    constexpr std::span<const std::byte> GetArgs() const noexcept { return std::span(m_Args.data(), m_Size); }
+
+    /**
+     * Checks whether a message has been captured
+     *
+     * @return
+     *      `true` if nothing has been captured
+     */
+    constexpr bool Empty() const noexcept { return m_Formatter == nullptr; }
+
+    /**
+     * Clears the captured message
+     */
+    constexpr void Reset() noexcept { m_Formatter = nullptr; }
+
+private:
+    /// Signature of the function that decodes and formats the arguments
+    using FormatFn = void(*)(std::string&, std::string_view, const std::byte*);
+
+private:
+    /**
+     * Decodes the arguments and formats the message
+     *
+     * @param[out] out
+     *      The string to append the formatted message to
+     * @param[in] fmt
+     *      The format of the message
+     * @param[in] src
+     *      The encoded arguments
+     */
+    template<typename ... Codecs>
+    static void FormatArgs(std::string& out, std::string_view fmt, [[maybe_unused]] const std::byte* src)
+    {
+        // Braced initialization guarantees that the arguments are decoded in order
+        std::tuple<typename Codecs::Decoded...> decoded{Codecs::Decode(src)...};
+        std::apply([&](auto& ... decodedArgs) {
+            std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(decodedArgs...));
+        }, decoded);
+    }
+
+private:
+    /// The format of the message
+    std::string_view m_Format{};
+    /// The function that formats the message with the captured arguments
+    FormatFn m_Formatter{};
+    /// The types of the captured arguments
+    std::span<const ArgType> m_Signature{};
+    /// The number of bytes used by the encoded arguments
+    size_t m_Size{};
+    /// The encoded arguments
+    alignas(std::max_align_t) std::array<std::byte, CAPACITY> m_Args{};
+};
+
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "Deferred.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace rklog {
+
+/**
+ * Enum describing the type of the value of a structured field
+ */
+enum class FieldKind : uint8_t
+{
+    BOOL,   // A boolean
+    INT,    // A signed integer
+    UINT,   // An unsigned integer
+    FLOAT,  // A floating point number
+    STRING, // A string
+    CUSTOM, // Any other formattable type, written as a string
+};
+
+/**
+ * Class containing a key and a typed value logged alongside a message, see
+ * `rklog::kv()`. A field only refers to its key and value, so it must not
+ * outlive the log call it is passed to
+ */
+class Field final
+{
+public:
+    /// Writes the value of a custom field to a string
+    using Formatter = void (*)(std::string& out, const void* value);
+
+public:
+    constexpr Field() noexcept = default;
+
+    /**
+     * Creates a boolean field
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     */
+    constexpr Field(std::string_view key, bool value) noexcept :
+        m_Key(key), m_Kind(FieldKind::BOOL), m_Value{.boolean = value} {}
+
+    /**
+     * Creates a signed integer field
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     */
+    constexpr Field(std::string_view key, int64_t value) noexcept :
+        m_Key(key), m_Kind(FieldKind::INT), m_Value{.integer = value} {}
+
+    /**
+     * Creates an unsigned integer field
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     */
+    constexpr Field(std::string_view key, uint64_t value) noexcept :
+        m_Key(key), m_Kind(FieldKind::UINT), m_Value{.unsignedInteger = value} {}
+
+    /**
+     * Creates a floating point field
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     */
+    constexpr Field(std::string_view key, double value) noexcept :
+        m_Key(key), m_Kind(FieldKind::FLOAT), m_Value{.floating = value} {}
+
+    /**
+     * Creates a string field
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     */
+    constexpr Field(std::string_view key, std::string_view value) noexcept :
+        m_Key(key), m_Kind(FieldKind::STRING), m_String(value) {}
+
+    /**
+     * Creates a field of any other type, formatted when it is written
+     *
+     * @param[in] key
+     *      The key of the field
+     * @param[in] value
+     *      The value of the field
+     * @param[in] formatter
+     *      Writes the value to a string
+     */
+    constexpr Field(std::string_view key, const void* value, Formatter formatter) noexcept :
+        m_Key(key), m_Kind(FieldKind::CUSTOM), m_Value{.custom = value}, m_Formatter(formatter) {}
+
+    /**
+     * Gets the key of the field
+     *
+     * @return
+     *      The key
+     */
+    constexpr std::string_view GetKey() const noexcept { return m_Key; }
+
+    /**
+     * Gets the type of the value of the field
+     *
+     * @return
+     *      The type of the value
+     */
+    constexpr FieldKind GetKind() const noexcept { return m_Kind; }
+
+    /**
+     * Gets the value of a `FieldKind::BOOL` field
+     *
+     * @return
+     *      The value
+     */
+    constexpr bool GetBool() const noexcept { return m_Value.boolean; }
+
+    /**
+     * Gets the value of a `FieldKind::INT` field
+     *
+     * @return
+     *      The value
+     */
+    constexpr int64_t GetInt() const noexcept { return m_Value.integer; }
+
+    /**
+     * Gets the value of a `FieldKind::UINT` field
+     *
+     * @return
+     *      The value
+     */
+    constexpr uint64_t GetUInt() const noexcept { return m_Value.unsignedInteger; }
+
+    /**
+     * Gets the value of a `FieldKind::FLOAT` field
+     *
+     * @return
+     *      The value
+     */
+    constexpr double GetFloat() const noexcept { return m_Value.floating; }
+
+    /**
+     * Gets the value of a `FieldKind::STRING` field
+     *
+     * @return
+     *      The value
+     */
+    constexpr std::string_view GetString() const noexcept { return m_String; }
+
+    /**
+     * Writes the value of a `FieldKind::CUSTOM` field to a string
+     *
+     * @param[out] out
+     *      The string to append the value to
+     */
+    inline void FormatCustom(std::string& out) const { m_Formatter(out, m_Value.custom); }
+
+private:
+    /**
+     * Union containing the value of a field that is not a string
+     */
+    union Value
+    {
+        bool boolean;
+        int64_t integer;
+        uint64_t unsignedInteger;
+        double floating;
+        const void* custom;
+    };
+
+private:
+    /// The key of the field
+    std::string_view m_Key{};
+    /// The type of the value of the field
+    FieldKind m_Kind{FieldKind::STRING};
+    /// The value of the field, unless it is a string
+    Value m_Value{.integer = 0};
+    /// The value of a string field
+    std::string_view m_String{};
+    /// Writes the value of a custom field
+    Formatter m_Formatter{};
+};
+
+/**
+ * Fields refer to the data of the caller, so a log with fields is never
+ * deferred
+ */
+template<>
+struct ArgCodec<Field>;
+
+/**
+ * Creates a structured field, e.g. `logger.Info("done", rklog::kv("ms", t))`.
+ * Booleans, integers, floating point numbers and strings keep their type;
+ * any other formattable value is formatted to a string when it is written
+ *
+ * @param[in] key
+ *      The key of the field
+ * @param[in] value
+ *      The value of the field, which must outlive the log call
+ *
+ * @return
+ *      The field
+ */
+template<typename T>
+constexpr Field kv(std::string_view key, const T& value) noexcept
+{
+    if constexpr (std::same_as<T, bool>)
+        return Field(key, value);
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        return Field(key, std::string_view(value));
+    else if constexpr (std::is_integral_v<T> && !std::same_as<T, char> && std::is_signed_v<T>)
+        return Field(key, static_cast<int64_t>(value));
+    else if constexpr (std::is_integral_v<T> && !std::same_as<T, char>)
+        return Field(key, static_cast<uint64_t>(value));
+    else if constexpr (std::is_floating_point_v<T>)
+        return Field(key, static_cast<double>(value));
+    else
+    {
+        return Field(key, &value, [](std::string& out, const void* ptr) {
+            std::format_to(std::back_inserter(out), "{}", *static_cast<const T*>(ptr));
+        });
+    }
+}
+
+/**
+ * Concept for the arguments of a log call that are structured fields
+ */
+template<typename T>
+concept FieldArg = std::same_as<std::remove_cvref_t<T>, Field>;
+
+/**
+ * Collects the structured fields among the arguments of a log call
+ *
+ * @param[in] args
+ *      The arguments of the log call
+ *
+ * @return
+ *      The fields, in the order they were passed
+ */
+template<typename ... Args>
+constexpr auto CollectFields(const Args& ... args) noexcept
+{
+    std::array<Field, (size_t{FieldArg<Args>} + ... + 0)> fields{};
+    [[maybe_unused]] size_t count{};
+    ([&] {
+        if constexpr (FieldArg<Args>)
+            fields[count++] = args;
+    }(), ...);
+
+    return fields;
+}
+
+/**
+ * Class containing a copy of structured fields that outlives the log call,
+ * e.g. while a record waits in a queue. Custom values are formatted to
+ * strings when they are copied
+ */
+class FieldStore final
+{
+public:
+    /**
+     * Copies fields into the store, replacing its contents
+     *
+     * @param[in] fields
+     *      The fields to copy
+     */
+    void Assign(std::span<const Field> fields) noexcept;
+
+    /**
+     * Gets the copied fields. Moving the store keeps them valid
+     *
+     * @return
+     *      The copied fields
+     */
+    inline std::span<const Field> Get() const noexcept { return m_Fields; }
+
+private:
+    /// The copied fields, referring to `m_Text`
+    std::vector<Field> m_Fields{};
+    /// The keys and string values of the fields
+    std::vector<char> m_Text{};
+};
+
+/**
+ * Writes a field as `key=value`. Strings are quoted if they are empty or
+ * contain spaces, quotes, `=` or control characters
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] field
+ *      The field to write
+ */
+void AppendFieldText(std::string& out, const Field& field) noexcept;
+
+/**
+ * Writes a field as a JSON object member, `"key":value`
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] field
+ *      The field to write
+ * @param[in] keyPrefix
+ *      Text written before the key, e.g. to keep it apart from the members
+ *      written by a sink
+ */
+void AppendFieldJson(std::string& out, const Field& field, std::string_view keyPrefix = {}) noexcept;
+
+}
+
+// --- custom formatting implementation of the field --------------------------
+//
+// Fields are passed to the format string of a log call with the rest of its
+// arguments. They are not used by it unless referred to, in which case they
+// are written as `key=value`
+
+template<>
+struct std::formatter<rklog::Field>
+{
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    auto format(const rklog::Field& field, std::format_context& ctx) const
+    {
+        std::string text{};
+        rklog::AppendFieldText(text, field);
+        return std::copy(text.begin(), text.end(), ctx.out());
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Stats.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Class writing to a raw file descriptor through a user-space buffer. Writes
+ * are copied into the buffer and only reach the operating system when the
+ * buffer is flushed or runs out of room
+ *
+ * The writer is not synchronized, the owner has to serialize access to it.
+ * Only its statistics may be read from any thread. The buffer is written out
+ * by the crash handler as well, see `rklog::InstallCrashHandler()`
+ */
+class FileWriter final
+{
+public:
+    /**
+     * Opens a file for writing, truncating it if it exists unless appending
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] bufferSize
+     *      The size of the buffer in bytes. Writes are not buffered if zero
+     * @param[in] append
+     *      Whether to append to the file rather than truncate it
+     */
+    FileWriter(const std::filesystem::path& filePath, size_t bufferSize, bool append = false) noexcept;
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter(FileWriter&&) = delete;
+
+    /**
+     * Flushes the buffer and closes the file
+     */
+    ~FileWriter() noexcept;
+
+    /**
+     * Flushes the buffer and closes the file, if open, then opens another one
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] append
+     *      Whether to append to the file rather than truncate it
+     *
+     * @return
+     *      `true` if the file was opened
+     */
+    bool Open(const std::filesystem::path& filePath, bool append = false) noexcept;
+
+    /**
+     * Flushes the buffer and closes the file
+     */
+    void Close() noexcept;
+
+    /**
+     * Checks whether the file was opened successfully
+     *
+     * @return
+     *      `true` if the file is open
+     */
+    constexpr bool IsOpen() const noexcept { return m_Handle >= 0; }
+
+    /**
+     * Appends data to the buffer, flushing it first if the data does not fit.
+     * Data larger than the whole buffer is written directly
+     *
+     * @param[in] data
+     *      The data to write
+     */
+    void Write(std::string_view data) noexcept;
+
+    /**
+     * Hands the contents of the buffer to the operating system
+     */
+    void Flush() noexcept;
+
+    /**
+     * Gets the I/O statistics of the writer. May be called from any thread
+     *
+     * @return
+     *      The statistics
+     */
+    FileStats GetStats() const noexcept;
+
+private:
+    /**
+     * Writes data to the file, retrying until all of it is written
+     *
+     * @param[in] data
+     *      The data to write
+     */
+    void WriteAll(std::string_view data) noexcept;
+
+    /**
+     * Writes the buffer out when the process crashes, skipping the statistics
+     *
+     * @param[in] context
+     *      The writer
+     *
+     * @return
+     *      `true`, the buffer is written out in one go
+     */
+    static bool DrainOnCrash(void* context) noexcept;
+
+private:
+    /// The file descriptor, negative if the file could not be opened
+    int m_Handle{-1};
+    /// The buffer
+    std::unique_ptr<char[]> m_Buffer{};
+    /// The size of the buffer
+    size_t m_Capacity{};
+    /// The number of bytes in the buffer
+    size_t m_Size{};
+    /// The number of bytes handed to the operating system
+    StatCounter m_BytesWritten{};
+    /// The number of write system calls made
+    StatCounter m_WriteCalls{};
+    /// The time spent in write system calls
+    StatCounter m_WriteNanos{};
+    /// The number of write system calls that failed
+    StatCounter m_WriteErrors{};
+    /// The number of times the buffer was handed over
+    StatCounter m_Flushes{};
+    /// The durations of the write system calls
+    LatencyRecorder m_WriteLatency{};
+    /// The slot of the crash hook of the writer
+    size_t m_CrashSlot{SIZE_MAX};
+};
+
+/**
+ * Writes data to the standard error stream, bypassing the buffering of the C
+ * library. Each write system call is atomic with respect to writes of other
+ * threads, so a short line written this way is never interleaved with others
+ *
+ * @param[in] data
+ *      The data to write
+ * @param[in] counters
+ *      The counters the write is counted in, if any
+ */
+void WriteToStdErr(std::string_view data, LogCounters* counters = nullptr) noexcept;
+
+}
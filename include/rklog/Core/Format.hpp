@@ -0,0 +1,73 @@
+#pragma once
+
+#include <concepts>
+#include <format>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+
+namespace rklog {
+
+/**
+ * Class wrapping a format string checked at compile time together with the
+ * source location of the call it was passed to
+ */
+template<typename ... Args>
+class BasicFormatString final
+{
+public:
+    /**
+     * Creates a format string from a string literal, capturing the location
+     * of the caller
+     *
+     * @param[in] fmt
+     *      The format string, checked against the arguments at compile time
+     * @param[in] location
+     *      The source location of the call
+     */
+    template<typename T>
+        requires std::convertible_to<const T&, std::string_view>
+    consteval BasicFormatString(const T& fmt, std::source_location location = std::source_location::current()) :
+        m_Format(fmt), m_Location(location) {}
+
+    /**
+     * Creates a format string from an already checked format string
+     *
+     * @param[in] fmt
+     *      The format string
+     * @param[in] location
+     *      The source location of the call
+     */
+    constexpr BasicFormatString(std::format_string<Args...> fmt, std::source_location location = std::source_location::current()) noexcept :
+        m_Format(fmt), m_Location(location) {}
+
+    /**
+     * Gets the checked format string
+     *
+     * @return
+     *      The format string
+     */
+    constexpr std::format_string<Args...> Get() const noexcept { return m_Format; }
+
+    /**
+     * Gets the source location of the call
+     *
+     * @return
+     *      The source location
+     */
+    constexpr std::source_location GetLocation() const noexcept { return m_Location; }
+
+private:
+    /// The checked format string
+    std::format_string<Args...> m_Format;
+    /// The source location of the call
+    std::source_location m_Location;
+};
+
+/**
+ * Format string for log calls, capturing the source location of the call
+ */
+template<typename ... Args>
+using FormatString = BasicFormatString<std::type_identity_t<Args>...>;
+
+}
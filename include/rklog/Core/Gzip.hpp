@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+
+namespace rklog {
+
+/**
+ * Compresses a file into the gzip format. Uses a small bundled deflate
+ * encoder (LZ77 with the fixed Huffman codes), which trades some compression
+ * ratio for speed and for not depending on an external library. Log files,
+ * being highly repetitive, still compress well
+ *
+ * @param[in] source
+ *      The path to the file to compress
+ * @param[in] destination
+ *      The path to write the compressed file to
+ *
+ * @return
+ *      `true` if the file was compressed, otherwise the destination may
+ *      contain a partial file
+ */
+bool CompressFile(const std::filesystem::path& source, const std::filesystem::path& destination) noexcept;
+
+}
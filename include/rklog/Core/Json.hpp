@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Appends text to a JSON string, escaping quotes, backslashes and control
+ * characters. The text is scanned 32 bytes at a time with AVX2 or 16 bytes at
+ * a time with SSE2 where the CPU supports it, so runs of text that need no
+ * escaping are copied as a whole. Other bytes, including UTF-8 sequences, are
+ * copied as-is
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] text
+ *      The text to escape
+ */
+void EscapeJson(std::string& out, std::string_view text) noexcept;
+
+/**
+ * Appends text as a quoted and escaped JSON string
+ *
+ * @param[out] out
+ *      The string to append to
+ * @param[in] text
+ *      The text to write
+ */
+inline void AppendJsonString(std::string& out, std::string_view text) noexcept
+{
+    out.push_back('"');
+    EscapeJson(out, text);
+    out.push_back('"');
+}
+
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+namespace rklog {
+
+/**
+ * Class limiting how often a call site logs, as a token bucket refilling at a
+ * fixed rate. The bucket is kept as the time at which it will next be full
+ * (the generic cell rate algorithm), so it fits in a single atomic and a
+ * dropped log costs a clock read, a load and an increment
+ */
+class RateLimiter final
+{
+public:
+    /**
+     * Creates a rate limiter with a full bucket
+     *
+     * @param[in] perSecond
+     *      The number of logs let through per second in the long run
+     * @param[in] burst
+     *      The number of logs let through at once after a quiet period
+     */
+    constexpr RateLimiter(uint32_t perSecond, uint32_t burst) noexcept :
+        m_Interval(1'000'000'000 / std::max<uint32_t>(perSecond, 1)),
+        m_Tolerance(m_Interval * (std::max<uint32_t>(burst, 1) - 1)) {}
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * Takes a token from the bucket if there is one
+     *
+     * @param[out] suppressed
+     *      The number of logs dropped since the last one let through, only set
+     *      if this one is let through
+     *
+     * @return
+     *      `true` if the log should be written
+     */
+    inline bool TryAcquire(uint64_t& suppressed) noexcept
+    {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        int64_t full = m_Full.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const int64_t start = std::max(full, now);
+            if (start - now > m_Tolerance)
+            {
+                m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (m_Full.compare_exchange_weak(full, start + m_Interval, std::memory_order_relaxed))
+                break;
+        }
+
+        suppressed = m_Suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    /// The time it takes to refill a single token
+    int64_t m_Interval;
+    /// How far ahead of the present the bucket may be emptied
+    int64_t m_Tolerance;
+    /// The time at which every token taken so far has been refilled
+    std::atomic<int64_t> m_Full{};
+    /// The number of logs dropped since the last one let through
+    std::atomic<uint64_t> m_Suppressed{};
+};
+
+/**
+ * Class collapsing identical consecutive logs of a call site. Logs are
+ * compared by a hash of their arguments, so nothing is formatted to find out
+ * that a log is a repeat. A repeat is dropped until the window after the last
+ * written log closes
+ */
+class Deduplicator final
+{
+public:
+    /**
+     * Creates a deduplicator
+     *
+     * @param[in] window
+     *      How long repeats of the last written log are dropped for
+     */
+    constexpr explicit Deduplicator(std::chrono::nanoseconds window) noexcept :
+        m_Window(window.count()) {}
+
+    Deduplicator(const Deduplicator&) = delete;
+    Deduplicator& operator=(const Deduplicator&) = delete;
+
+    /**
+     * Checks whether a log repeats the last one written
+     *
+     * @param[in] hash
+     *      The hash of the arguments of the log
+     * @param[out] repeated
+     *      The number of repeats dropped since the last written log, only set
+     *      if this one should be written
+     *
+     * @return
+     *      `true` if the log should be written
+     */
+    inline bool Check(size_t hash, uint64_t& repeated) noexcept
+    {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        const size_t last = m_Last.exchange(hash, std::memory_order_relaxed);
+        if (last == hash && now < m_WindowEnd.load(std::memory_order_relaxed))
+        {
+            m_Repeated.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_WindowEnd.store(now + m_Window, std::memory_order_relaxed);
+        repeated = m_Repeated.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    /// How long repeats are dropped for
+    int64_t m_Window;
+    /// The hash of the arguments of the last log
+    std::atomic<size_t> m_Last{};
+    /// The time at which repeats stop being dropped
+    std::atomic<int64_t> m_WindowEnd{};
+    /// The number of repeats dropped since the last written log
+    std::atomic<uint64_t> m_Repeated{};
+};
+
+/**
+ * Concept for log arguments a `rklog::Deduplicator` can compare
+ */
+template<typename T>
+concept HashableArg = std::is_convertible_v<const T&, std::string_view> ||
+    requires(const T& value) { std::hash<T>{}(value); };
+
+/**
+ * Hashes the arguments of a log
+ *
+ * @param[out] hash
+ *      The combined hash of the arguments
+ * @param[in] args
+ *      The arguments of the log
+ *
+ * @return
+ *      `false` if an argument cannot be hashed, in which case logs cannot be
+ *      compared
+ */
+template<typename ... Args>
+bool HashArgs(size_t& hash, const Args& ... args) noexcept
+{
+    if constexpr ((HashableArg<Args> && ...))
+    {
+        hash = 0;
+        const auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+        (combine([&args] {
+            if constexpr (std::is_convertible_v<const Args&, std::string_view>)
+                return std::hash<std::string_view>{}(std::string_view(args));
+            else
+                return std::hash<Args>{}(args);
+        }()), ...);
+
+        return true;
+    }
+    else
+        return false;
+}
+
+}
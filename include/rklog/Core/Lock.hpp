@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace rklog {
+
+/**
+ * Enum describing how a logger serializes the final write of each log line
+ */
+enum class LockPolicy : uint8_t
+{
+    NONE,         // No locking, for loggers used by a single thread only,
+                  // a mutex where a thread of the library shares the lock
+    MUTEX,        // A mutex, sleeping under contention
+    SPIN,         // A spinlock that yields to the scheduler after a while
+    ATOMIC_WRITE, // No locking where each line is a single write system call,
+                  // a mutex for loggers that keep buffers or other state
+};
+
+/**
+ * Class locking the final write of a logger according to its lock policy.
+ * Formatting happens before the lock is taken, so only the write itself is
+ * serialized
+ */
+class WriteLock final
+{
+public:
+    constexpr WriteLock() noexcept = default;
+
+    WriteLock(const WriteLock&) = delete;
+    WriteLock& operator=(const WriteLock&) = delete;
+
+    /**
+     * Gets the lock policy
+     *
+     * @return
+     *      The lock policy
+     */
+    constexpr LockPolicy GetPolicy() const noexcept { return m_Policy; }
+
+    /**
+     * Sets the lock policy. Must not be called while the lock is in use
+     *
+     * @param[in] policy
+     *      The new lock policy
+     */
+    constexpr void SetPolicy(LockPolicy policy) noexcept { m_Policy = policy; }
+
+    /**
+     * Marks the lock as shared with a thread of the library, such as a flush
+     * timer, which `LockPolicy::NONE` then locks against. Must be set before
+     * that thread starts
+     *
+     * @param[in] shared
+     *      Whether a thread of the library takes the lock as well
+     */
+    constexpr void SetShared(bool shared) noexcept { m_Shared = shared; }
+
+    /**
+     * Takes the lock
+     *
+     * @param[in] atomicWrite
+     *      Whether the guarded region is a single write system call, which
+     *      `LockPolicy::ATOMIC_WRITE` does not lock
+     *
+     * @return
+     *      `true` if the lock was taken and has to be released
+     */
+    inline bool Lock(bool atomicWrite) noexcept
+    {
+        switch (m_Policy)
+        {
+            case LockPolicy::NONE:
+                if (!m_Shared)
+                    return false;
+
+                m_Mutex.lock();
+                return true;
+            case LockPolicy::ATOMIC_WRITE:
+                if (atomicWrite)
+                    return false;
+                [[fallthrough]];
+            case LockPolicy::MUTEX:
+                m_Mutex.lock();
+                return true;
+            case LockPolicy::SPIN:
+                LockSpin();
+                return true;
+        }
+
+        RKLOG_UNREACHABLE();
+    }
+
+    /**
+     * Releases the lock
+     */
+    inline void Unlock() noexcept
+    {
+        if (m_Policy == LockPolicy::SPIN)
+            m_Spin.store(false, std::memory_order_release);
+        else
+            m_Mutex.unlock();
+    }
+
+private:
+    /// The number of times the spinlock is polled before yielding
+    static constexpr uint32_t SPIN_LIMIT = 128;
+
+private:
+    /**
+     * Takes the spinlock, polling a read-only copy of the flag so that the
+     * waiting threads do not bounce its cache line between them
+     */
+    void LockSpin() noexcept
+    {
+        uint32_t spins{};
+        while (m_Spin.exchange(true, std::memory_order_acquire))
+        {
+            while (m_Spin.load(std::memory_order_relaxed))
+            {
+                if (++spins < SPIN_LIMIT)
+                    RKLOG_CPU_PAUSE();
+                else
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    /// The lock policy
+    LockPolicy m_Policy{LockPolicy::MUTEX};
+    /// Whether a thread of the library takes the lock as well
+    bool m_Shared{};
+    /// The flag of the spinlock
+    std::atomic<bool> m_Spin{};
+    /// The mutex
+    std::mutex m_Mutex{};
+};
+
+/**
+ * Class holding a write lock for the duration of a scope
+ */
+class WriteGuard final
+{
+public:
+    /**
+     * Takes the lock
+     *
+     * @param[in] lock
+     *      The lock to take
+     * @param[in] atomicWrite
+     *      Whether the guarded region is a single write system call
+     */
+    explicit WriteGuard(WriteLock& lock, bool atomicWrite = false) noexcept :
+        m_Lock(lock), m_Locked(lock.Lock(atomicWrite)) {}
+
+    WriteGuard(const WriteGuard&) = delete;
+    WriteGuard& operator=(const WriteGuard&) = delete;
+
+    /**
+     * Releases the lock
+     */
+    ~WriteGuard() noexcept
+    {
+        if (m_Locked)
+            m_Lock.Unlock();
+    }
+
+private:
+    /// The lock held
+    WriteLock& m_Lock;
+    /// Whether the lock was actually taken
+    bool m_Locked;
+};
+
+}
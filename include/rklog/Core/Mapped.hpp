@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+
+namespace rklog {
+
+/**
+ * Class appending to a file through memory mappings. The file is grown one
+ * preallocated segment at a time and the current segment is mapped, so that
+ * appending is a plain copy into the page cache. System calls are only made
+ * when moving on to the next segment
+ *
+ * Since the pages belong to the kernel, everything written survives a crash of
+ * the process. The file is truncated to the data actually written when it is
+ * closed; after a crash, the unused tail of the last segment reads as zeros
+ *
+ * The file is not synchronized, the owner has to serialize access to it
+ */
+class MappedFile final
+{
+public:
+    /**
+     * Opens a file for appending, truncating it if it exists, and maps its
+     * first segment
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] segmentSize
+     *      The size of each segment in bytes, rounded up to the page size
+     */
+    MappedFile(const std::filesystem::path& filePath, size_t segmentSize) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+
+    /**
+     * Unmaps the current segment, truncates the file to its length and closes
+     * it
+     */
+    ~MappedFile() noexcept;
+
+    /**
+     * Checks whether the file was opened and mapped successfully
+     *
+     * @return
+     *      `true` if the file can be written to
+     */
+    constexpr bool IsOpen() const noexcept { return m_Mapping != nullptr; }
+
+    /**
+     * Appends data to the file, moving on to the next segment whenever the
+     * current one is full
+     *
+     * @param[in] data
+     *      The data to append
+     */
+    void Write(std::string_view data) noexcept;
+
+    /**
+     * Blocks until everything written so far has reached the disk
+     */
+    void Sync() noexcept;
+
+    /**
+     * Gets the number of bytes written to the file
+     *
+     * @return
+     *      The length of the file's contents
+     */
+    constexpr uint64_t Size() const noexcept { return m_SegmentOffset + m_Used; }
+
+private:
+    /**
+     * Unmaps the current segment, if any, then preallocates and maps the
+     * segment at the given offset
+     *
+     * @param[in] offset
+     *      The offset of the segment in the file
+     *
+     * @return
+     *      `true` if the segment was mapped
+     */
+    bool MapSegment(uint64_t offset) noexcept;
+
+private:
+    /// The file descriptor
+    int m_Handle{-1};
+    /// The size of each segment
+    size_t m_SegmentSize{};
+    /// The mapping of the current segment
+    char* m_Mapping{};
+    /// The offset of the current segment in the file
+    uint64_t m_SegmentOffset{};
+    /// The number of bytes written to the current segment
+    size_t m_Used{};
+};
+
+}
+
+#endif
@@ -41,3 +41,21 @@
 #else
 #define RKLOG_CURR_FUNC __func__
 #endif
+
+
+// --- cache line size --------------------------------------------------------
+
+#define RKLOG_CACHE_LINE_SIZE 64
+
+// --- spin wait hint ---------------------------------------------------------
+
+#if defined(RKLOG_COMPILER_MSVC)
+#include <intrin.h>
+#define RKLOG_CPU_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#define RKLOG_CPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define RKLOG_CPU_PAUSE() asm volatile("yield")
+#else
+#define RKLOG_CPU_PAUSE() ((void)0)
+#endif
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rklog {
+
+/**
+ * Bounded, lock-free, multi-producer multi-consumer queue
+ *
+ * Every cell carries a sequence number which tells producers whether the cell
+ * is free for the current lap of the ring, and tells consumers whether the
+ * value in it has been published. Producers only contend on a single atomic
+ * increment of the enqueue position, and consumers on one of the dequeue
+ * position. A single consumer never contends, but producers may pop as well,
+ * e.g. to drop the oldest value when the queue is full.
+ */
+template<typename T>
+class MPMCQueue final
+{
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+        "MPMCQueue requires nothrow movable values");
+
+public:
+    /**
+     * Creates a new queue with room for at least `capacity` values. The
+     * capacity is rounded up to the next power of two
+     *
+     * @param[in] capacity
+     *      The minimum number of values the queue can hold
+     */
+    explicit MPMCQueue(size_t capacity) :
+        m_Mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+        m_Cells(std::make_unique<Cell[]>(m_Mask + 1))
+    {
+        for (size_t i = 0; i <= m_Mask; i++)
+            m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /**
+     * Attempts to push a value onto the queue. May be called from any thread
+     *
+     * @param[in] value
+     *      The value to push. Only moved from if the push succeeds
+     *
+     * @return
+     *      `true` if the value was pushed, `false` if the queue was full
+     */
+    bool TryPush(T&& value) noexcept
+    {
+        size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_Cells[pos & m_Mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Attempts to pop a value from the queue. May be called from any thread
+     *
+     * @param[out] value
+     *      The value that was popped
+     *
+     * @return
+     *      `true` if a value was popped, `false` if the queue was empty
+     */
+    bool TryPop(T& value) noexcept
+    {
+        size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_Cells[pos & m_Mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + m_Mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_DequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Checks whether the next value to pop has been published
+     *
+     * @return
+     *      `true` if there is nothing to pop
+     */
+    bool Empty() const noexcept
+    {
+        const size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+        const Cell& cell = m_Cells[pos & m_Mask];
+        return cell.sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    /**
+     * Gets the number of values claimed by producers but not yet popped. Only
+     * a snapshot while other threads use the queue
+     *
+     * @return
+     *      The number of values in the queue
+     */
+    inline size_t Size() const noexcept
+    {
+        const size_t dequeued = m_DequeuePos.load(std::memory_order_relaxed);
+        const size_t enqueued = m_EnqueuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /**
+     * Gets the number of slots that have been claimed by producers so far.
+     * Every value pushed before this call has a position below the returned
+     * value
+     *
+     * @return
+     *      The enqueue position of the queue
+     */
+    inline uint64_t EnqueuePosition() const noexcept { return m_EnqueuePos.load(std::memory_order_acquire); }
+
+    /**
+     * Gets the maximum number of values the queue can hold
+     *
+     * @return
+     *      The capacity of the queue
+     */
+    inline size_t Capacity() const noexcept { return m_Mask + 1; }
+
+private:
+    /**
+     * A single slot in the ring
+     */
+    struct Cell
+    {
+        /// The sequence number of the cell
+        std::atomic<size_t> sequence{};
+        /// The value stored in the cell
+        T value{};
+    };
+
+private:
+    /// The mask used to wrap positions into the ring
+    const size_t m_Mask;
+    /// The ring of cells
+    std::unique_ptr<Cell[]> m_Cells;
+    /// The position producers claim their next cell from
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<size_t> m_EnqueuePos{};
+    /// The position consumers read their next cell from
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<size_t> m_DequeuePos{};
+};
+
+/**
+ * Bounded, lock-free, single-producer single-consumer queue
+ *
+ * The producer only writes the tail and the consumer only writes the head, so
+ * neither ever contends. Each side keeps a cached copy of the other side's
+ * position and only reads the shared one again once the cached copy says the
+ * queue is full or empty, which keeps the cache line of the other side from
+ * bouncing between cores on every value
+ */
+template<typename T>
+class SPSCQueue final
+{
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+        "SPSCQueue requires nothrow movable values");
+
+public:
+    /**
+     * Creates a new queue with room for at least `capacity` values. The
+     * capacity is rounded up to the next power of two. A queue whose memory
+     * could not be allocated has a capacity of zero and must not be used
+     *
+     * @param[in] capacity
+     *      The minimum number of values the queue can hold
+     */
+    explicit SPSCQueue(size_t capacity) noexcept :
+        m_Mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+        m_Values(new (std::nothrow) T[m_Mask + 1]) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /**
+     * Attempts to push a value onto the queue. Must only be called from the
+     * producer thread
+     *
+     * @param[in] value
+     *      The value to push. Only moved from if the push succeeds
+     *
+     * @return
+     *      `true` if the value was pushed, `false` if the queue was full
+     */
+    bool TryPush(T&& value) noexcept
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_CachedHead > m_Mask)
+        {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead > m_Mask)
+                return false;
+        }
+
+        m_Values[tail & m_Mask] = std::move(value);
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Attempts to pop a value from the queue. Must only be called from the
+     * consumer thread
+     *
+     * @param[out] value
+     *      The value that was popped
+     *
+     * @return
+     *      `true` if a value was popped, `false` if the queue was empty
+     */
+    bool TryPop(T& value) noexcept
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_CachedTail)
+        {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head == m_CachedTail)
+                return false;
+        }
+
+        value = std::move(m_Values[head & m_Mask]);
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Checks whether the queue is empty. Only a snapshot while the producer
+     * uses the queue
+     *
+     * @return
+     *      `true` if there is nothing to pop
+     */
+    inline bool Empty() const noexcept
+    {
+        return m_Head.load(std::memory_order_relaxed) == m_Tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Gets the number of values pushed but not yet popped. Only a snapshot
+     * while the queue is used
+     *
+     * @return
+     *      The number of values in the queue
+     */
+    inline size_t Size() const noexcept
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * Gets the number of values pushed so far. Every value pushed before this
+     * call has a position below the returned value
+     *
+     * @return
+     *      The enqueue position of the queue
+     */
+    inline uint64_t EnqueuePosition() const noexcept { return m_Tail.load(std::memory_order_acquire); }
+
+    /**
+     * Gets the maximum number of values the queue can hold
+     *
+     * @return
+     *      The capacity of the queue, zero if it could not be allocated
+     */
+    inline size_t Capacity() const noexcept { return m_Values ? m_Mask + 1 : 0; }
+
+private:
+    /// The mask used to wrap positions into the ring
+    const size_t m_Mask;
+    /// The ring of values
+    std::unique_ptr<T[]> m_Values;
+    /// The position the producer writes its next value to
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<size_t> m_Tail{};
+    /// The head as last seen by the producer
+    size_t m_CachedHead{};
+    /// The position the consumer reads its next value from
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<size_t> m_Head{};
+    /// The tail as last seen by the consumer
+    size_t m_CachedTail{};
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Field.hpp"
+#include "Time.hpp"
+
+#include "../Config/Level.hpp"
+
+#include <cstdint>
+#include <source_location>
+#include <span>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Struct describing where a log call was made. Unlike `std::source_location`
+ * it can be filled in by hand, e.g. when reading records back from a file
+ */
+struct SourceLocation final
+{
+public:
+    const char* file{""};     // The source file of the log call
+    uint32_t line{};          // The source line of the log call
+    const char* function{""}; // The function the log call was made in
+
+public:
+    constexpr SourceLocation() noexcept = default;
+
+    /**
+     * Creates a source location from the one captured by the compiler
+     *
+     * @param[in] location
+     *      The captured source location
+     */
+    constexpr SourceLocation(std::source_location location) noexcept :
+        file(location.file_name()), line(location.line()), function(location.function_name()) {}
+
+    /**
+     * Creates a source location from its parts
+     *
+     * @param[in] fileName
+     *      The source file
+     * @param[in] lineNumber
+     *      The source line
+     * @param[in] functionName
+     *      The function name
+     */
+    constexpr SourceLocation(const char* fileName, uint32_t lineNumber, const char* functionName) noexcept :
+        file(fileName), line(lineNumber), function(functionName) {}
+};
+
+/**
+ * Struct containing everything a logger needs to write a single log
+ */
+struct LogRecord final
+{
+public:
+    std::string_view message{};      // The already formatted message
+    LogLevel level{};                // The severity of the log
+    TimeStamp time{};                // The time at which the log was made
+    SourceLocation location{};       // The source location of the log call
+    uint64_t threadId{};             // The id of the thread that made the log
+    std::span<const Field> fields{}; // The structured fields of the log
+};
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace rklog {
+
+/**
+ * Class letting every n-th log of a call site through, starting with the
+ * first
+ */
+class EveryNSampler final
+{
+public:
+    /**
+     * Creates a sampler
+     *
+     * @param[in] n
+     *      The distance between the logs let through
+     */
+    constexpr explicit EveryNSampler(uint64_t n) noexcept :
+        m_N(n > 0 ? n : 1) {}
+
+    EveryNSampler(const EveryNSampler&) = delete;
+    EveryNSampler& operator=(const EveryNSampler&) = delete;
+
+    /**
+     * Counts a log
+     *
+     * @return
+     *      `true` if the log should be written
+     */
+    inline bool Check() noexcept { return m_Count.fetch_add(1, std::memory_order_relaxed) % m_N == 0; }
+
+private:
+    /// The distance between the logs let through
+    uint64_t m_N;
+    /// The number of logs counted so far
+    std::atomic<uint64_t> m_Count{};
+};
+
+/**
+ * Class letting the first n logs of a call site through
+ */
+class FirstNSampler final
+{
+public:
+    /**
+     * Creates a sampler
+     *
+     * @param[in] n
+     *      The number of logs let through
+     */
+    constexpr explicit FirstNSampler(uint64_t n) noexcept :
+        m_N(n) {}
+
+    FirstNSampler(const FirstNSampler&) = delete;
+    FirstNSampler& operator=(const FirstNSampler&) = delete;
+
+    /**
+     * Counts a log
+     *
+     * @return
+     *      `true` if the log should be written
+     */
+    inline bool Check() noexcept
+    {
+        // Once the budget is spent the count is only read, so the cache line
+        // stays shared between the threads logging here
+        if (m_Count.load(std::memory_order_relaxed) >= m_N)
+            return false;
+
+        return m_Count.fetch_add(1, std::memory_order_relaxed) < m_N;
+    }
+
+private:
+    /// The number of logs let through
+    uint64_t m_N;
+    /// The number of logs counted so far
+    std::atomic<uint64_t> m_Count{};
+};
+
+/**
+ * Class letting a fraction of the logs of a call site through. Instead of a
+ * random number generator, the n-th log is let through if the fractional part
+ * of n times the golden ratio is below the fraction. The sequence is spread
+ * evenly, so the share of logs let through matches the fraction closely even
+ * over short runs, and it only needs a counter
+ */
+class ProbabilitySampler final
+{
+public:
+    /**
+     * Creates a sampler
+     *
+     * @param[in] probability
+     *      The fraction of logs let through, between 0 and 1
+     */
+    constexpr explicit ProbabilitySampler(double probability) noexcept :
+        m_Threshold(ToThreshold(probability)), m_All(probability >= 1.0) {}
+
+    ProbabilitySampler(const ProbabilitySampler&) = delete;
+    ProbabilitySampler& operator=(const ProbabilitySampler&) = delete;
+
+    /**
+     * Counts a log
+     *
+     * @return
+     *      `true` if the log should be written
+     */
+    inline bool Check() noexcept
+    {
+        constexpr uint64_t GOLDEN_RATIO = 0x9e3779b97f4a7c15;
+        return m_All || m_Count.fetch_add(1, std::memory_order_relaxed) * GOLDEN_RATIO < m_Threshold;
+    }
+
+private:
+    /**
+     * Scales a probability to the range of a 64-bit integer
+     */
+    static constexpr uint64_t ToThreshold(double probability) noexcept
+    {
+        if (!(probability > 0.0))
+            return 0;
+        else if (probability >= 1.0)
+            return UINT64_MAX;
+
+        return static_cast<uint64_t>(probability * 18446744073709551616.0);
+    }
+
+private:
+    /// The fraction of logs let through, scaled to the range of the counter
+    uint64_t m_Threshold;
+    /// A flag indicating whether every log is let through
+    bool m_All;
+    /// The number of logs counted so far
+    std::atomic<uint64_t> m_Count{};
+};
+
+}
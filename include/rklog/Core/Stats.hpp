@@ -0,0 +1,362 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include "../Config/Level.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace rklog {
+
+/// The number of log levels records are counted for
+constexpr size_t LEVEL_COUNT = static_cast<size_t>(LogLevel::LOG_FATAL) + 1;
+
+/**
+ * Class counting events from a single thread, e.g. under the lock of a
+ * writer, while any thread reads it. Updates are a plain load and store, so
+ * they never contend
+ */
+class StatCounter final
+{
+public:
+    constexpr StatCounter() noexcept = default;
+
+    StatCounter(const StatCounter&) = delete;
+    StatCounter& operator=(const StatCounter&) = delete;
+
+    /**
+     * Adds to the counter. Must only be called from one thread at a time
+     *
+     * @param[in] value
+     *      The amount to add
+     */
+    inline void Add(uint64_t value) noexcept
+    {
+        m_Value.store(m_Value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Raises the counter to a value if it is lower. Must only be called from
+     * one thread at a time
+     *
+     * @param[in] value
+     *      The value to raise the counter to
+     */
+    inline void Max(uint64_t value) noexcept
+    {
+        if (value > m_Value.load(std::memory_order_relaxed))
+            m_Value.store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Gets the value of the counter. May be called from any thread
+     *
+     * @return
+     *      The value
+     */
+    inline uint64_t Get() const noexcept { return m_Value.load(std::memory_order_relaxed); }
+
+private:
+    /// The value of the counter
+    std::atomic<uint64_t> m_Value{};
+};
+
+/**
+ * Struct containing a histogram of durations in power-of-two buckets of
+ * nanoseconds. Bucket `i` counts the durations in `[2^i, 2^(i+1))`, bucket 0
+ * also counts zero
+ */
+struct LatencyHistogram final
+{
+public:
+    /// The number of buckets, enough for any 64-bit duration
+    static constexpr size_t BUCKET_COUNT = 64;
+
+public:
+    std::array<uint64_t, BUCKET_COUNT> buckets{}; // The number of durations per bucket
+
+public:
+    /**
+     * Gets the bucket a duration is counted in
+     *
+     * @param[in] nanos
+     *      The duration in nanoseconds
+     *
+     * @return
+     *      The index of the bucket
+     */
+    static constexpr size_t GetBucket(uint64_t nanos) noexcept
+    {
+        return nanos == 0 ? 0 : static_cast<size_t>(std::bit_width(nanos)) - 1;
+    }
+
+    /**
+     * Gets the number of durations in the histogram
+     *
+     * @return
+     *      The sum of the buckets
+     */
+    uint64_t Count() const noexcept;
+
+    /**
+     * Gets an upper bound of a percentile of the durations, accurate to a
+     * factor of two
+     *
+     * @param[in] percentile
+     *      The percentile, from 0 to 100
+     *
+     * @return
+     *      The upper bound of the bucket the percentile falls in, in
+     *      nanoseconds, or zero if the histogram is empty
+     */
+    uint64_t Percentile(double percentile) const noexcept;
+
+    /**
+     * Adds the counts of another histogram to this one
+     *
+     * @param[in] other
+     *      The histogram to add
+     *
+     * @return
+     *      This histogram
+     */
+    LatencyHistogram& operator+=(const LatencyHistogram& other) noexcept;
+};
+
+/**
+ * Class recording durations into a histogram from a single thread while any
+ * thread reads it, see `rklog::StatCounter`
+ */
+class LatencyRecorder final
+{
+public:
+    constexpr LatencyRecorder() noexcept = default;
+
+    /**
+     * Records a duration. Must only be called from one thread at a time
+     *
+     * @param[in] nanos
+     *      The duration in nanoseconds
+     */
+    inline void Record(uint64_t nanos) noexcept { m_Buckets[LatencyHistogram::GetBucket(nanos)].Add(1); }
+
+    /**
+     * Takes a snapshot of the histogram. May be called from any thread
+     *
+     * @return
+     *      The histogram
+     */
+    LatencyHistogram Get() const noexcept;
+
+private:
+    /// The number of durations per bucket
+    std::array<StatCounter, LatencyHistogram::BUCKET_COUNT> m_Buckets{};
+};
+
+/**
+ * Struct containing the I/O statistics of a file writer
+ */
+struct FileStats final
+{
+public:
+    uint64_t bytesWritten{};       // The number of bytes handed to the operating system
+    uint64_t writeCalls{};         // The number of write system calls made
+    uint64_t writeNanos{};         // The time spent in write system calls
+    uint64_t writeErrors{};        // The number of write system calls that failed
+    uint64_t flushes{};            // The number of times a buffer was handed over
+    LatencyHistogram writeLatency; // The durations of the write system calls
+};
+
+/**
+ * Struct containing a snapshot of the statistics of a logger or a sink. The
+ * counters are read one at a time while other threads keep logging, so they
+ * are not taken at exactly the same instant
+ */
+struct LogStats final
+{
+public:
+    std::array<uint64_t, LEVEL_COUNT> records{}; // The number of records logged per level
+    uint64_t suppressed{};                        // Records dropped by rate limits and deduplication
+    std::array<uint64_t, LEVEL_COUNT> dropped{}; // Records lost to a full queue per level
+    uint64_t bytesWritten{};                      // The number of bytes written
+    uint64_t writeCalls{};                        // The number of write system calls made
+    uint64_t writeNanos{};                        // The time spent in write system calls
+    uint64_t writeErrors{};                       // The number of write system calls that failed
+    uint64_t flushes{};                           // The number of times a buffer was handed over
+    uint64_t queueHighWater{};                    // The most records ever waiting in the queue
+    LatencyHistogram writeLatency;                // The durations of the write system calls
+    LatencyHistogram queueLatency;                // The time from logging a record to writing it
+
+public:
+    /**
+     * Gets the number of records logged at any level
+     *
+     * @return
+     *      The sum of the records per level
+     */
+    uint64_t TotalRecords() const noexcept;
+
+    /**
+     * Gets the number of records lost at any level
+     *
+     * @return
+     *      The sum of the dropped records per level
+     */
+    uint64_t TotalDropped() const noexcept;
+
+    /**
+     * Adds the output statistics of something written to, e.g. a sink or a
+     * backend, leaving the record counts alone
+     *
+     * @param[in] output
+     *      The statistics to add
+     */
+    void AddOutput(const LogStats& output) noexcept;
+
+    /**
+     * Adds the statistics of a file writer
+     *
+     * @param[in] file
+     *      The statistics to add
+     */
+    void AddOutput(const FileStats& file) noexcept;
+};
+
+/**
+ * Class counting the records of a logger or a sink from any number of threads.
+ * The counts are spread over cache-line sized shards picked by the calling
+ * thread, so threads logging at the same time rarely touch the same line
+ */
+class LogCounters final
+{
+public:
+    /// The number of shards, threads beyond it share them
+    static constexpr size_t SHARD_COUNT = 16;
+
+public:
+    constexpr LogCounters() noexcept = default;
+
+    LogCounters(const LogCounters&) = delete;
+    LogCounters& operator=(const LogCounters&) = delete;
+
+    /**
+     * Counts a record
+     *
+     * @param[in] level
+     *      The log level of the record
+     */
+    inline void CountRecord(LogLevel level) noexcept
+    {
+        GetShard().records[static_cast<size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts records dropped by a rate limit or a deduplicator
+     *
+     * @param[in] count
+     *      The number of records
+     */
+    inline void CountSuppressed(uint64_t count) noexcept
+    {
+        GetShard().suppressed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts records that were lost
+     *
+     * @param[in] level
+     *      The log level of the records
+     * @param[in] count
+     *      The number of records
+     */
+    inline void CountDropped(LogLevel level, uint64_t count) noexcept
+    {
+        GetShard().dropped[static_cast<size_t>(level)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts data written to the output
+     *
+     * @param[in] bytes
+     *      The number of bytes written
+     * @param[in] calls
+     *      The number of write system calls made
+     * @param[in] nanos
+     *      The time spent in them
+     * @param[in] errors
+     *      The number of them that failed
+     */
+    inline void CountWrite(uint64_t bytes, uint64_t calls, uint64_t nanos, uint64_t errors) noexcept
+    {
+        Shard& shard = GetShard();
+        shard.bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+        shard.writeCalls.fetch_add(calls, std::memory_order_relaxed);
+        shard.writeNanos.fetch_add(nanos, std::memory_order_relaxed);
+        if (errors > 0)
+            shard.writeErrors.fetch_add(errors, std::memory_order_relaxed);
+    }
+
+    /**
+     * Sums the shards
+     *
+     * @return
+     *      The statistics counted so far
+     */
+    LogStats Get() const noexcept;
+
+private:
+    /**
+     * Struct containing the counts of the threads sharing a shard
+     */
+    struct alignas(RKLOG_CACHE_LINE_SIZE) Shard
+    {
+    public:
+        std::array<std::atomic<uint64_t>, LEVEL_COUNT> records{}; // The number of records per level
+        std::atomic<uint64_t> suppressed{};                        // The number of suppressed records
+        std::array<std::atomic<uint64_t>, LEVEL_COUNT> dropped{}; // The number of lost records per level
+        std::atomic<uint64_t> bytesWritten{};                      // The number of bytes written
+        std::atomic<uint64_t> writeCalls{};                        // The number of write system calls
+        std::atomic<uint64_t> writeNanos{};                        // The time spent in them
+        std::atomic<uint64_t> writeErrors{};                       // The number of them that failed
+    };
+
+private:
+    /**
+     * Gets the shard of the calling thread
+     *
+     * @return
+     *      The shard
+     */
+    inline Shard& GetShard() noexcept { return m_Shards[GetShardIndex()]; }
+
+    /**
+     * Gets the index of the shard of the calling thread. The index is only
+     * handed out once per thread
+     *
+     * @return
+     *      The index of the shard
+     */
+    static inline size_t GetShardIndex() noexcept
+    {
+        thread_local const size_t index = NextShardIndex();
+        return index;
+    }
+
+    /**
+     * Hands out shard indices round robin
+     *
+     * @return
+     *      The index of the next shard
+     */
+    static size_t NextShardIndex() noexcept;
+
+private:
+    /// The shards
+    std::array<Shard, SHARD_COUNT> m_Shards{};
+};
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rklog {
+
+/**
+ * Queries the operating system for the id of the calling thread
+ *
+ * @return
+ *      The id of the calling thread
+ */
+uint64_t QueryThreadId() noexcept;
+
+/**
+ * Gets the id of the calling thread. The id is only queried from the
+ * operating system once per thread
+ *
+ * @return
+ *      The id of the calling thread
+ */
+inline uint64_t GetThreadId() noexcept
+{
+    thread_local const uint64_t threadId = QueryThreadId();
+    return threadId;
+}
+
+/**
+ * Pins the calling thread to a single CPU. Not supported on macOS, which has
+ * no way to bind a thread to a CPU
+ *
+ * @param[in] cpu
+ *      The index of the CPU
+ *
+ * @return
+ *      `true` if the thread was pinned
+ */
+bool PinThreadToCpu(uint32_t cpu) noexcept;
+
+/**
+ * Pins the calling thread to the CPUs of a NUMA node, so that it may run on
+ * any of them. Not supported on macOS
+ *
+ * @param[in] node
+ *      The index of the NUMA node
+ *
+ * @return
+ *      `true` if the thread was pinned
+ */
+bool PinThreadToNode(uint32_t node) noexcept;
+
+}
@@ -1,60 +1,115 @@
 #pragma once
 
+#include "Clock.hpp"
 #include "Platform.hpp"
 
+#include <algorithm>
 #include <format>
 #include <cstdint>
 #include <chrono>
+#include <string_view>
 
 namespace rklog {
 
+/**
+ * Enum describing the precision of the fractional seconds of a timestamp
+ */
+enum class TimePrecision : uint8_t
+{
+    SECONDS,
+    MILLISECONDS,
+    MICROSECONDS,
+    NANOSECONDS,
+};
+
+/**
+ * Struct describing how a timestamp is written
+ */
+struct TimeFormat final
+{
+public:
+    TimePrecision precision{}; // The precision of the fractional seconds
+    bool utc{};                // Whether to write UTC rather than local time
+    bool iso8601{};            // Whether to write the full ISO-8601 date and time
+};
+
 /**
  * Class containing the timestamp data of each log
  */
 class TimeStamp final
 {
+public:
+    /// The maximum number of characters a formatted timestamp takes up
+    static constexpr size_t MAX_LENGTH = 32;
+
 public:
     /**
-     * Queries the system clock for the current time
+     * Queries the given clock for the current time. Falls back to the system
+     * clock if the cycle counter is not supported
+     *
+     * @param[in] source
+     *      The clock to query
      *
      * @return
      *      The current time
      */
-    static TimeStamp Now() noexcept
+    static TimeStamp Now(ClockSource source = ClockSource::SYSTEM) noexcept
     {
-        const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-        const std::time_t cNow = std::chrono::system_clock::to_time_t(now);
-
-#if defined(RKLOG_PLATFORM_WINDOWS)
-        std::tm localTime;
-        const ::errno_t err = ::localtime_s(&localTime, &cNow);
-        if (err == 0)
+        if constexpr (TscClock::IsSupported())
         {
-            return TimeStamp(static_cast<uint32_t>(localTime.tm_hour), static_cast<uint32_t>(localTime.tm_min), static_cast<uint32_t>(localTime.tm_sec));
+            if (source == ClockSource::TSC)
+                return TimeStamp(TscClock::Ticks(), ClockSource::TSC);
         }
 
-        return TimeStamp();
-#else
-    const std::tm* const localTime = std::localtime(&cNow);
-    return TimeStamp(static_cast<uint32_t>(localTime->tm_hour), static_cast<uint32_t>(localTime->tm_min), static_cast<uint32_t>(localTime->tm_sec));
-#endif
+        return TimeStamp(std::chrono::system_clock::now());
     }
 
+    constexpr TimeStamp() noexcept = default;
+
     /**
-     * Gets the hours from the timestamp
+     * Creates a new instance of a timestamp from a point in time
+     *
+     * @param[in] time
+     *      The point in time of the timestamp
+     */
+    constexpr explicit TimeStamp(std::chrono::system_clock::time_point time) noexcept :
+        m_Value(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count()) {}
+
+    /**
+     * Gets the number of nanoseconds since the Unix epoch. Timestamps taken
+     * from the cycle counter are converted here
+     *
+     * @return
+     *      The nanoseconds since the epoch
+     */
+    inline int64_t SinceEpoch() const noexcept
+    {
+        return m_Source == ClockSource::TSC ? TscClock::ToNanoseconds(static_cast<uint64_t>(m_Value)) : m_Value;
+    }
+
+    /**
+     * Gets the clock the timestamp was taken from
+     *
+     * @return
+     *      The clock source of the timestamp
+     */
+    constexpr ClockSource GetSource() const noexcept { return m_Source; }
+
+    /**
+     * Gets the hours from the timestamp in local time
      *
      * @return
      *      The number of hours
      */
-    inline uint32_t Hours() const noexcept { return m_Hours; }
+    uint32_t Hours() const noexcept;
 
     /**
-     * Gets the minutes from the timestamp
+     * Gets the minutes from the timestamp in local time
      *
      * @return
      *      The number of minutes
      */
-    inline uint32_t Minutes() const noexcept { return m_Minutes; }
+    uint32_t Minutes() const noexcept;
 
     /**
      * Gets the seconds from the timestamp
@@ -62,47 +117,150 @@ public:
      * @return
      *      The number of seconds
      */
-    inline uint32_t Seconds() const noexcept { return m_Seconds; }
+    uint32_t Seconds() const noexcept;
+
+    /**
+     * Gets the fraction of the current second of the timestamp
+     *
+     * @return
+     *      The number of nanoseconds into the current second
+     */
+    inline uint32_t Subseconds() const noexcept
+    {
+        const int64_t sub = SinceEpoch() % NANOS_PER_SECOND;
+        return static_cast<uint32_t>(sub < 0 ? sub + NANOS_PER_SECOND : sub);
+    }
+
+    /**
+     * Writes the timestamp to an output iterator
+     *
+     * @param[in] out
+     *      The iterator to write to
+     * @param[in] format
+     *      How the timestamp should be written
+     *
+     * @return
+     *      The iterator past the last character written
+     */
+    template<typename Out>
+    Out FormatTo(Out out, TimeFormat format) const
+    {
+        const int64_t nanoseconds = SinceEpoch();
+        const std::string_view prefix = CachedText(nanoseconds, format.utc, format.iso8601);
+        out = std::copy(prefix.begin(), prefix.end(), out);
+
+        if (format.precision != TimePrecision::SECONDS)
+        {
+            const int digits = 3 * static_cast<int>(format.precision);
+            const int64_t sub = nanoseconds % NANOS_PER_SECOND;
+            auto fraction = static_cast<uint32_t>(sub < 0 ? sub + NANOS_PER_SECOND : sub);
+            for (int i = digits; i < 9; i++)
+                fraction /= 10;
+
+            char buffer[10] = {'.'};
+            for (int i = digits; i > 0; i--)
+            {
+                buffer[i] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+
+            out = std::copy(buffer, buffer + digits + 1, out);
+        }
+
+        if (format.utc && format.iso8601)
+            *out++ = 'Z';
+
+        return out;
+    }
 
 private:
-    constexpr TimeStamp() noexcept = default;
+    /// The number of nanoseconds in a second
+    static constexpr int64_t NANOS_PER_SECOND = 1'000'000'000;
 
+private:
     /**
-     * Creates a new instance of a timestamp
+     * Creates a new instance of a timestamp from a raw clock value
      *
-     * @param[in] hours
-     *      The hours of the timestamp
-     * @param[in] minutes
-     *      The minutes of the timestamp
-     * @param[in] seconds
-     *      The seconds of the timestamp
+     * @param[in] value
+     *      The value read from the clock
+     * @param[in] source
+     *      The clock the value was read from
      */
-    constexpr explicit TimeStamp(uint32_t hours, uint32_t minutes, uint32_t seconds) noexcept :
-        m_Hours(hours), m_Minutes(minutes), m_Seconds(seconds) {}
+    constexpr explicit TimeStamp(uint64_t value, ClockSource source) noexcept :
+        m_Value(static_cast<int64_t>(value)), m_Source(source) {}
+
+    /**
+     * Gets the text of a time up to and including its whole seconds. The
+     * text is cached per thread and only rebuilt when the second changes
+     *
+     * @param[in] nanoseconds
+     *      The nanoseconds since the epoch of the time
+     * @param[in] utc
+     *      Whether to get the text in UTC rather than local time
+     * @param[in] iso8601
+     *      Whether to get the full ISO-8601 date and time
+     *
+     * @return
+     *      The cached text, valid until the thread formats another second
+     */
+    static std::string_view CachedText(int64_t nanoseconds, bool utc, bool iso8601) noexcept;
 
 private:
-    /// The number of hours
-    const uint32_t m_Hours{};
-    /// The number of minutes
-    const uint32_t m_Minutes{};
-    /// The number of seconds
-    const uint32_t m_Seconds{};
+    /// The nanoseconds since the Unix epoch, or the cycle counter value
+    int64_t m_Value{};
+    /// The clock the value was read from
+    ClockSource m_Source{};
 };
 
 }
 
 // --- custom formatting implementation of the time stamp ---------------------
+//
+// The format specification is `[u][i][.3|.6|.9]`, where `u` writes UTC, `i`
+// writes the full ISO-8601 date and time and the precision adds milli-, micro-
+// or nanoseconds. An empty specification writes the local `HH:MM:SS`
 
 template<>
 struct std::formatter<rklog::TimeStamp>
 {
-    constexpr auto parse(std::format_parse_context& ctx) const
+    constexpr auto parse(std::format_parse_context& ctx)
     {
-        return ctx.begin();
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it == 'u')
+        {
+            m_Format.utc = true;
+            ++it;
+        }
+        if (it != ctx.end() && *it == 'i')
+        {
+            m_Format.iso8601 = true;
+            ++it;
+        }
+        if (it != ctx.end() && *it == '.')
+        {
+            ++it;
+            if (it == ctx.end())
+                throw std::format_error("missing timestamp precision");
+
+            switch (*it++)
+            {
+                case '3': m_Format.precision = rklog::TimePrecision::MILLISECONDS; break;
+                case '6': m_Format.precision = rklog::TimePrecision::MICROSECONDS; break;
+                case '9': m_Format.precision = rklog::TimePrecision::NANOSECONDS; break;
+                default: throw std::format_error("timestamp precision must be 3, 6 or 9");
+            }
+        }
+        if (it != ctx.end() && *it != '}')
+            throw std::format_error("invalid timestamp format specification");
+
+        return it;
     }
 
     auto format(const rklog::TimeStamp& timeStamp, std::format_context& ctx) const
     {
-        return std::format_to(ctx.out(), "{:02}:{:02}:{:02}", timeStamp.Hours(), timeStamp.Minutes(), timeStamp.Seconds());
+        return timeStamp.FormatTo(ctx.out(), m_Format);
     }
+
+private:
+    rklog::TimeFormat m_Format{};
 };
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "Stats.hpp"
+
+#include "../Config/Uring.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * The submission and completion rings shared with the kernel, only defined
+ * where io_uring is available
+ */
+struct UringRing;
+
+/**
+ * Class writing to a file through a set of buffers that are handed to the
+ * kernel as they fill up. On Linux the buffers are registered with an
+ * io_uring instance and written asynchronously, each write optionally linked
+ * to an `fsync()`, so the caller only waits when every buffer is still being
+ * written. Completions are reaped from the shared ring without a system call
+ *
+ * Where io_uring is unavailable, e.g. on older kernels, under seccomp
+ * filters or on other platforms, full buffers are instead collected and
+ * written together with a single `writev()` once they run out
+ *
+ * The writer is not synchronized, the owner has to serialize access to it.
+ * Only its statistics may be read from any thread
+ */
+class UringWriter final
+{
+public:
+    /**
+     * Opens a file for writing, truncating it if it exists
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] bufferSize
+     *      The size of each buffer in bytes
+     * @param[in] policy
+     *      The number of buffers and how durable the writes are
+     */
+    UringWriter(const std::filesystem::path& filePath, size_t bufferSize, UringPolicy policy) noexcept;
+
+    UringWriter(const UringWriter&) = delete;
+    UringWriter(UringWriter&&) = delete;
+
+    /**
+     * Waits for every buffer to be written and closes the file
+     */
+    ~UringWriter() noexcept;
+
+    /**
+     * Checks whether the file was opened successfully
+     *
+     * @return
+     *      `true` if the file is open
+     */
+    constexpr bool IsOpen() const noexcept { return m_Handle >= 0; }
+
+    /**
+     * Checks whether the buffers are written through io_uring
+     *
+     * @return
+     *      `true` if io_uring is used, `false` if `writev()` is
+     */
+    inline bool UsesUring() const noexcept { return m_Ring != nullptr; }
+
+    /**
+     * Appends data to the current buffer, handing it to the kernel and moving
+     * on to the next one whenever it fills up
+     *
+     * @param[in] data
+     *      The data to write
+     */
+    void Write(std::string_view data) noexcept;
+
+    /**
+     * Hands the current buffer to the kernel without waiting for it to be
+     * written, unless syncs are off, in which case the few bytes of a partly
+     * filled buffer are cheaper to write directly. Without io_uring every
+     * filled buffer is written right away
+     */
+    void Submit() noexcept;
+
+    /**
+     * Hands the current buffer to the kernel and waits until every buffer
+     * has been written, and synced if the policy asks for it
+     */
+    void Flush() noexcept;
+
+    /**
+     * Gets the I/O statistics of the writer. May be called from any thread
+     *
+     * @return
+     *      The statistics
+     */
+    FileStats GetStats() const noexcept;
+
+private:
+    /**
+     * Struct containing one of the buffers
+     */
+    struct Buffer
+    {
+    public:
+        char* data{};       // The memory of the buffer
+        size_t size{};      // The number of bytes in the buffer
+        size_t written{};   // The number of bytes of it that have been written
+        uint64_t offset{};  // The offset in the file the buffer is written to
+        uint32_t pending{}; // The number of requests on it in flight
+        bool writing{};     // Whether a write of it is in flight
+        bool resync{};      // Whether its sync was cancelled and is due again
+        bool filled{};      // Whether it is full and waits to be written
+    };
+
+private:
+    /**
+     * Sets up the io_uring instance and registers the buffers with it
+     *
+     * @return
+     *      `true` if io_uring can be used
+     */
+    bool SetUpRing() noexcept;
+
+    /**
+     * Hands a buffer to the kernel
+     *
+     * @param[in] index
+     *      The index of the buffer
+     */
+    void SubmitBuffer(size_t index) noexcept;
+
+    /**
+     * Queues the write of what remains of a buffer, linked to a sync if the
+     * policy asks for one, and submits it
+     *
+     * @param[in] index
+     *      The index of the buffer
+     * @param[in] write
+     *      `false` to queue only the sync
+     */
+    void QueueWrite(size_t index, bool write) noexcept;
+
+    /**
+     * Reaps the completions in the ring
+     *
+     * @param[in] wait
+     *      The number of operations to wait for at least
+     */
+    void Reap(uint32_t wait) noexcept;
+
+    /**
+     * Enters the ring to submit what is queued, dropping the ring if the
+     * kernel keeps refusing
+     *
+     * @param[in] wait
+     *      The number of operations to wait for at least
+     *
+     * @return
+     *      `true` if the ring is still used
+     */
+    bool EnterRing(uint32_t wait) noexcept;
+
+    /**
+     * Gives up on io_uring: writes out what the ring has not and goes on with
+     * `writev()`
+     */
+    void DropRing() noexcept;
+
+    /**
+     * Writes every filled buffer with one `writev()` call, used without
+     * io_uring
+     */
+    void WriteFilled() noexcept;
+
+    /**
+     * Moves on to the next buffer, waiting for it to be written if needed
+     */
+    void Advance() noexcept;
+
+    /**
+     * Counts a system call made to write
+     *
+     * @param[in] nanos
+     *      The time it took
+     * @param[in] failed
+     *      Whether it failed
+     */
+    void CountCall(uint64_t nanos, bool failed) noexcept;
+
+    /**
+     * Writes the current buffer out when the process crashes, waits a while
+     * for the ones in flight and writes whatever they left
+     *
+     * @param[in] context
+     *      The writer
+     *
+     * @return
+     *      `true`, everything is written in one go
+     */
+    static bool DrainOnCrash(void* context) noexcept;
+
+private:
+    /// The file descriptor, negative if the file could not be opened
+    int m_Handle{-1};
+    /// How the buffers are written
+    UringPolicy m_Policy;
+    /// The memory of every buffer
+    std::unique_ptr<char[]> m_Memory{};
+    /// The buffers
+    std::unique_ptr<Buffer[]> m_Buffers{};
+    /// The number of buffers
+    size_t m_BufferCount{};
+    /// The size of each buffer
+    size_t m_BufferSize{};
+    /// The index of the buffer being filled
+    size_t m_Current{};
+    /// The offset in the file of the next buffer
+    uint64_t m_Offset{};
+    /// The number of requests in flight
+    uint32_t m_InFlight{};
+    /// The number of times in a row the kernel refused to enter the ring
+    uint32_t m_EnterFailures{};
+    /// The io_uring instance, null when `writev()` is used
+    std::unique_ptr<UringRing> m_Ring{};
+    /// The number of bytes the kernel reported written
+    StatCounter m_BytesWritten{};
+    /// The number of system calls made to write
+    StatCounter m_WriteCalls{};
+    /// The time spent in those system calls
+    StatCounter m_WriteNanos{};
+    /// The number of writes and syncs that failed
+    StatCounter m_WriteErrors{};
+    /// The number of buffers handed to the kernel
+    StatCounter m_Flushes{};
+    /// The durations of the system calls
+    LatencyRecorder m_WriteLatency{};
+    /// The slot of the crash hook of the writer
+    size_t m_CrashSlot{SIZE_MAX};
+};
+
+}
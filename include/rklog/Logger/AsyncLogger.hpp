@@ -0,0 +1,332 @@
+#pragma once
+
+#include "Logger.hpp"
+
+#include "../Config/Queue.hpp"
+
+#include "../Core/Platform.hpp"
+#include "../Core/Queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace rklog {
+
+/**
+ * Class acting as an interface for asynchronous logging. Records are pushed
+ * onto a bounded lock-free queue by the calling threads and written to the
+ * backend logger by a single background thread. Whenever the arguments allow
+ * it, only a binary snapshot of them is queued and the message is formatted
+ * by the background thread
+ *
+ * What callers do when the queue is full is set by the queue policy. Records
+ * at or above its priority level, `LOG_ERROR` by default, go through a
+ * separate lane that is never dropped from, and the background thread writes
+ * both lanes in the order the records were logged
+ *
+ * With `QueueMode::PER_THREAD`, every thread gets a single-producer queue of
+ * its own the first time it logs, so callers never touch a cache line another
+ * caller writes to. The background thread merges the queues by timestamp.
+ * Threads beyond the configured maximum share the queue
+ *
+ * While a lane is empty, the oldest record is held back for the merge window
+ * of the policy in case an older one is still being pushed onto that lane. A
+ * record that takes longer than that to reach its lane, e.g. because its
+ * thread was preempted or waited for room, can still be written after newer
+ * records of other lanes
+ *
+ * Once `rklog::InstallCrashHandler()` is called, a crash waits for the
+ * background thread to write the queued records before the process dies
+ */
+class AsyncLogger final : public Logger
+{
+public:
+    /// The default number of records the queue can hold
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = defaults::DEFAULT_QUEUE_POLICY.GetCapacity();
+    /// The number of records written between samples of the queue depth
+    static constexpr uint64_t QUEUE_DEPTH_INTERVAL = 64;
+    /// The number of records written between wake-ups of threads waiting for
+    /// room or for a flush, while the background thread is busy
+    static constexpr uint64_t WAKE_INTERVAL = 32;
+
+public:
+    /**
+     * Creates an instance of an asynchronous logger
+     *
+     * @param[in] backend
+     *      The logger that the background thread writes the records to
+     * @param[in] capacity
+     *      The number of records the queue can hold before callers have to
+     *      wait for the background thread
+     */
+    explicit AsyncLogger(std::unique_ptr<Logger> backend, size_t capacity = DEFAULT_QUEUE_CAPACITY);
+
+    /**
+     * Creates an instance of an asynchronous logger with a queue policy
+     *
+     * @param[in] backend
+     *      The logger that the background thread writes the records to
+     * @param[in] policy
+     *      How the records are queued and what happens when the queue is full
+     */
+    AsyncLogger(std::unique_ptr<Logger> backend, QueuePolicy policy);
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger(AsyncLogger&&) = delete;
+
+    /**
+     * Writes every pending record to the backend and stops the background
+     * thread
+     */
+    ~AsyncLogger() noexcept;
+
+    /**
+     * Blocks until every record that was logged before this call has been
+     * written to the backend, then flushes the backend
+     */
+    virtual void Flush() noexcept override;
+
+    /**
+     * Gets a snapshot of the statistics of the logger, with the output of the
+     * backend added. The queue depth is sampled every `QUEUE_DEPTH_INTERVAL`
+     * records, so its high-water mark may be slightly low
+     *
+     * @return
+     *      The statistics counted since the logger was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
+protected:
+    virtual void LogInternal(const LogRecord& record) noexcept override;
+    virtual void LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept override;
+
+private:
+    /**
+     * Struct containing a record as it is stored in the queue
+     */
+    struct QueuedRecord
+    {
+        /// The formatted message, if it was formatted by the caller
+        std::string message{};
+        /// The captured message, if formatting was deferred
+        DeferredMessage deferred{};
+        /// The copied structured fields of the log
+        FieldStore fields{};
+        /// The record of the log, its message and fields are set when it is
+        /// written
+        LogRecord record{};
+    };
+
+    /**
+     * Struct containing the queue of a single thread. It is handed to
+     * another thread once its owner exits
+     */
+    struct ThreadQueue
+    {
+    public:
+        /**
+         * Creates the queue of a thread, owned by the calling thread
+         *
+         * @param[in] capacity
+         *      The number of records the queue can hold
+         */
+        explicit ThreadQueue(size_t capacity) noexcept : queue(capacity) {}
+
+        /**
+         * Drops a reference to the queue, deleting it with the last one
+         */
+        void Release() noexcept
+        {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        /// The pending records of the thread
+        SPSCQueue<QueuedRecord> queue;
+        /// A flag indicating whether a thread owns the queue
+        std::atomic<bool> owned{true};
+        /// The number of references to the queue, held by the logger and by
+        /// the thread that owns it, so that a thread outliving the logger can
+        /// still give it up
+        std::atomic<uint32_t> references{2};
+    };
+
+    /**
+     * Struct containing the queues the calling thread owns, given up when the
+     * thread exits
+     */
+    struct ThreadQueueList;
+
+private:
+    /**
+     * The loop of the background thread
+     */
+    void Run() noexcept;
+
+    /**
+     * Pushes a record onto its lane. What happens if the lane is full depends
+     * on the queue policy
+     *
+     * @param[in] queued
+     *      The record to push
+     */
+    void Push(QueuedRecord&& queued) noexcept;
+
+    /**
+     * Gets the queue of the calling thread, taking a free one or creating a
+     * new one the first time the thread logs
+     *
+     * @return
+     *      The queue of the thread, or null if the thread uses the shared
+     *      queue
+     */
+    ThreadQueue* GetThreadQueue() noexcept;
+
+    /**
+     * Takes a free queue for the calling thread or creates a new one
+     *
+     * @return
+     *      The queue with a reference for the thread, or null if every queue
+     *      is taken or there is no memory for a new one
+     */
+    ThreadQueue* AcquireThreadQueue() noexcept;
+
+    /**
+     * Pushes a record onto a lane, spinning and then waiting for room if it is
+     * full
+     *
+     * @param[in] lane
+     *      The lane to push to
+     * @param[in] queued
+     *      The record to push
+     * @param[in] spins
+     *      The number of times to retry before waiting
+     */
+    template<typename Lane>
+    void PushWaiting(Lane& lane, QueuedRecord& queued, uint32_t spins) noexcept;
+
+    /**
+     * Pops the next record of a lane. Lane 0 is the priority lane, lane 1 the
+     * shared queue and the others the queues of the threads
+     *
+     * @param[in] lane
+     *      The index of the lane
+     * @param[out] queued
+     *      The record that was popped
+     *
+     * @return
+     *      `true` if a record was popped
+     */
+    bool PopLane(size_t lane, QueuedRecord& queued) noexcept;
+
+    /**
+     * Gets the number of lanes, which grows as threads get queues of their
+     * own
+     *
+     * @return
+     *      The number of lanes
+     */
+    size_t GetLaneCount() const noexcept;
+
+    /**
+     * Gets the number of records pushed onto every lane so far
+     *
+     * @return
+     *      The total enqueue position of the lanes
+     */
+    uint64_t GetEnqueued() const noexcept;
+
+    /**
+     * Gets the number of records waiting in every lane
+     *
+     * @return
+     *      The number of pending records
+     */
+    size_t GetPending() const noexcept;
+
+    /**
+     * Checks whether every lane is empty
+     *
+     * @return
+     *      `true` if there is nothing to pop
+     */
+    bool IsDrained() const noexcept;
+
+    /**
+     * Writes a record to the backend
+     *
+     * @param[in] queued
+     *      The record to write
+     * @param[out] scratch
+     *      The string a deferred message is formatted into
+     */
+    void Write(QueuedRecord& queued, std::string& scratch) noexcept;
+
+    /**
+     * Counts a record as done, whether written or dropped, and wakes the
+     * threads waiting on it
+     *
+     * @param[in] wake
+     *      Whether waiting threads should be woken now rather than with the
+     *      next batch
+     */
+    void Complete(bool wake) noexcept;
+
+    /**
+     * Wakes the background thread if it is waiting for records
+     */
+    void Wake() noexcept;
+
+    /**
+     * Checks whether the queued records have been written when the process
+     * crashes. The background thread keeps running on its own meanwhile
+     *
+     * @param[in] context
+     *      The logger
+     *
+     * @return
+     *      `true` once the queues are drained, or if the background thread
+     *      itself crashed
+     */
+    static bool DrainOnCrash(void* context) noexcept;
+
+private:
+    /// The logger the records are written to
+    std::unique_ptr<Logger> m_Backend;
+    /// How the records are queued
+    QueuePolicy m_Policy;
+    /// The queue of pending records
+    MPMCQueue<QueuedRecord> m_Queue;
+    /// The queue of pending records at or above the priority level
+    MPMCQueue<QueuedRecord> m_Priority;
+    /// The queues of the threads, a slot is null until its queue is created.
+    /// The logger holds a reference to each of them
+    std::unique_ptr<std::atomic<ThreadQueue*>[]> m_ThreadQueues{};
+    /// The number of slots of thread queues in use
+    std::atomic<size_t> m_ThreadQueueCount{};
+    /// Set to `false` when the logger is destroyed, shared with the threads
+    /// that hold one of its queues
+    std::shared_ptr<std::atomic<bool>> m_Open{};
+    /// The number of records written to the backend or dropped from a queue
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<uint64_t> m_Written{};
+    /// The number of threads waiting in `Flush()` or for room in a queue
+    std::atomic<uint32_t> m_Waiters{};
+    /// The most records seen waiting in the queue
+    StatCounter m_QueueHighWater{};
+    /// The time from logging a record to writing it
+    LatencyRecorder m_QueueLatency{};
+    /// Counter the background thread waits on while the queue is empty
+    alignas(RKLOG_CACHE_LINE_SIZE) std::atomic<uint32_t> m_Signal{};
+    /// A flag indicating whether the background thread is waiting
+    std::atomic<bool> m_Sleeping{};
+    /// A flag indicating whether the background thread should keep running
+    std::atomic<bool> m_Running{true};
+    /// The background thread
+    std::thread m_Worker{};
+    /// The slot of the crash hook of the logger
+    size_t m_CrashSlot{SIZE_MAX};
+};
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "../Core/Buffer.hpp"
+#include "../Core/Deferred.hpp"
+#include "../Core/Record.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <utility>
+
+namespace rklog {
+
+/**
+ * Class keeping the most recent records that were below the level of a logger
+ * in a fixed ring, so that they can be written out once something goes wrong.
+ * Every slot is allocated up front and records are stored as a binary snapshot
+ * of their arguments, so storing one never allocates or makes a system call
+ *
+ * Storing is lock-free. A record that lands on a slot which is being read at
+ * that moment is dropped rather than waited for
+ */
+class BacktraceRing final
+{
+public:
+    /// The number of characters kept of a message that could not be stored as
+    /// a snapshot of its arguments
+    static constexpr size_t TEXT_CAPACITY = 256;
+
+public:
+    /**
+     * Creates an instance of a backtrace ring
+     *
+     * @param[in] capacity
+     *      The number of records to keep, rounded up to the next power of two
+     */
+    explicit BacktraceRing(size_t capacity) noexcept;
+
+    BacktraceRing(const BacktraceRing&) = delete;
+    BacktraceRing(BacktraceRing&&) = delete;
+
+    /**
+     * Gets the number of records the ring keeps
+     *
+     * @return
+     *      The capacity of the ring
+     */
+    constexpr size_t GetCapacity() const noexcept { return m_Capacity; }
+
+    /**
+     * Stores a record, overwriting the oldest one if the ring is full. The
+     * arguments are captured as a binary snapshot when they allow it, or else
+     * formatted and truncated to `TEXT_CAPACITY` characters. Structured fields
+     * are not kept
+     *
+     * @param[in] record
+     *      The record of the log, without its message
+     * @param[in] fmt
+     *      The format of the message
+     * @param[in] args
+     *      The arguments for the format
+     */
+    template<typename ... Args>
+    void Store(const LogRecord& record, std::format_string<Args...> fmt, Args&& ... args) noexcept
+    {
+        if (m_Capacity == 0)
+            return;
+
+        const uint64_t ticket = m_Next.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_Slots[ticket & (m_Capacity - 1)];
+        if (slot.busy.test_and_set(std::memory_order_acquire))
+            return;
+
+        Entry& entry = slot.entry;
+        entry.ticket = ticket;
+        entry.level = record.level;
+        entry.time = record.time;
+        entry.location = record.location;
+        entry.threadId = record.threadId;
+        entry.deferred.Reset();
+        entry.textSize = 0;
+
+        bool captured{};
+        if constexpr ((DeferrableArg<Args> && ...))
+            captured = entry.deferred.Capture(fmt.get(), args...);
+
+        if (!captured)
+        {
+            const auto result = std::format_to_n(entry.text.data(), TEXT_CAPACITY, fmt, std::forward<Args>(args)...);
+            entry.textSize = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(result.size), TEXT_CAPACITY));
+        }
+
+        slot.busy.clear(std::memory_order_release);
+    }
+
+    /**
+     * Takes every stored record out of the ring, oldest first, and passes it
+     * to a function. Records stored meanwhile are left for the next drain
+     *
+     * @param[in] write
+     *      The function called with each record
+     *
+     * @return
+     *      The number of records taken
+     */
+    template<typename Fn>
+    size_t Drain(Fn&& write) noexcept
+    {
+        const uint64_t end = m_Next.load(std::memory_order_acquire);
+        const uint64_t begin = end > m_Capacity ? end - m_Capacity : 0;
+
+        size_t taken{};
+        Entry entry{};
+        for (uint64_t ticket = begin; ticket < end; ticket++)
+        {
+            if (!Take(ticket, entry))
+                continue;
+
+            FormatBuffer message{};
+            if (entry.deferred.Empty())
+                (*message).assign(entry.text.data(), entry.textSize);
+            else
+                entry.deferred.FormatTo(*message);
+
+            write(LogRecord{*message, entry.level, entry.time, entry.location, entry.threadId, {}});
+            taken++;
+        }
+
+        return taken;
+    }
+
+private:
+    /**
+     * Struct containing a stored record
+     */
+    struct Entry
+    {
+    public:
+        uint64_t ticket{UINT64_MAX};              // The position of the record, `UINT64_MAX` once taken
+        LogLevel level{};                         // The severity of the log
+        TimeStamp time{};                         // The time at which the log was made
+        SourceLocation location{};                // The source location of the log call
+        uint64_t threadId{};                      // The id of the thread that made the log
+        DeferredMessage deferred{};               // The captured message, if it fit
+        uint32_t textSize{};                      // The length of the formatted message
+        std::array<char, TEXT_CAPACITY> text{};   // The formatted message, if it was not captured
+    };
+
+    /**
+     * Struct containing a slot of the ring
+     */
+    struct Slot
+    {
+    public:
+        std::atomic_flag busy{};                  // Set while the entry is written or read
+        Entry entry{};                            // The stored record
+    };
+
+private:
+    /**
+     * Copies a record out of its slot and marks it as taken
+     *
+     * @param[in] ticket
+     *      The position of the record
+     * @param[out] entry
+     *      The copy of the record
+     *
+     * @return
+     *      `true` if the slot still held the record
+     */
+    bool Take(uint64_t ticket, Entry& entry) noexcept;
+
+private:
+    /// The slots of the ring
+    std::unique_ptr<Slot[]> m_Slots{};
+    /// The number of slots, a power of two
+    size_t m_Capacity{};
+    /// The position of the next record stored
+    std::atomic<uint64_t> m_Next{};
+};
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Logger.hpp"
+
+#include "../Config/Style.hpp"
+
+#include "../Core/File.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace rklog {
+
+/**
+ * Class acting as an interface for logging to a compact binary file, see
+ * `Core/Binary.hpp` for the layout. The title, the pattern and the tags are
+ * written once in the header and every format string once per call site, so
+ * records only contain a format id, a timestamp delta and the raw arguments.
+ * Messages are never formatted by the logger; the `rklog-decode` tool turns
+ * the file back into the text the pattern of the style produces
+ *
+ * Arguments of types without a built-in `rklog::ArgType` are formatted by the
+ * caller and written as a string
+ */
+class BinaryLogger final : public Logger
+{
+public:
+    /// The default size of the write buffer
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+public:
+    /**
+     * Creates an instance of a binary logger
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] bufferSize
+     *      The size of the write buffer in bytes
+     */
+    BinaryLogger(const std::filesystem::path& filePath, size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept :
+        Logger(), m_Writer(filePath, bufferSize) { Start(); }
+
+    /**
+     * Creates an instance of a binary logger with a title
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] bufferSize
+     *      The size of the write buffer in bytes
+     */
+    BinaryLogger(const std::filesystem::path& filePath, std::string_view title, size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept :
+        Logger(title), m_Writer(filePath, bufferSize) { Start(); }
+
+    /**
+     * Creates an instance of a binary logger with a custom style
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] style
+     *      The custom style of the logger, used when decoding
+     * @param[in] bufferSize
+     *      The size of the write buffer in bytes
+     */
+    BinaryLogger(const std::filesystem::path& filePath, LogStyle style, size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept :
+        Logger(style), m_Writer(filePath, bufferSize) { Start(); }
+
+    /**
+     * Creates an instance of a binary logger with a title and a custom style
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] style
+     *      The custom style of the logger, used when decoding
+     * @param[in] bufferSize
+     *      The size of the write buffer in bytes
+     */
+    BinaryLogger(const std::filesystem::path& filePath, std::string_view title, LogStyle style, size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept :
+        Logger(title, style), m_Writer(filePath, bufferSize) { Start(); }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger(BinaryLogger&&) = delete;
+
+    /**
+     * Hands the buffered records to the operating system
+     */
+    virtual void Flush() noexcept override;
+
+    /**
+     * Gets a snapshot of the statistics of the logger, including the bytes
+     * written, write system calls made, time spent in them and flushes
+     *
+     * @return
+     *      The statistics counted since the logger was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
+protected:
+    virtual void LogInternal(const LogRecord& record) noexcept override;
+    virtual void LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept override;
+
+private:
+    /**
+     * Struct identifying a format entry: a format string, the types of its
+     * arguments and the call site it was used at
+     */
+    struct FormatKey
+    {
+    public:
+        const char* format{};       // The address of the format string
+        const ArgType* signature{}; // The address of the list of argument types
+        const char* file{};         // The address of the source file name
+        const char* function{};     // The address of the function name
+        uint32_t line{};            // The source line
+
+    public:
+        constexpr bool operator==(const FormatKey&) const noexcept = default;
+    };
+
+    /**
+     * Struct hashing format keys
+     */
+    struct FormatKeyHash
+    {
+    public:
+        size_t operator()(const FormatKey& key) const noexcept;
+    };
+
+private:
+    /**
+     * Enables deferred formatting and writes the header of the file
+     */
+    void Start() noexcept;
+
+    /**
+     * Writes the start of a record, preceded by its format entry if the
+     * format is new. The arguments have to follow
+     *
+     * @param[out] out
+     *      The string to append the entries to
+     * @param[in] format
+     *      The format string of the message
+     * @param[in] signature
+     *      The types of the arguments
+     * @param[in] record
+     *      The record of the log
+     */
+    void WriteRecordHeader(std::string& out, std::string_view format, std::span<const ArgType> signature, const LogRecord& record) noexcept;
+
+private:
+    /// The buffered writer of the file that this logger is logging to
+    FileWriter m_Writer;
+    /// The ids of the formats written so far
+    std::unordered_map<FormatKey, uint32_t, FormatKeyHash> m_Formats{};
+    /// The time of the last record in nanoseconds since the epoch
+    int64_t m_LastTime{};
+};
+
+}
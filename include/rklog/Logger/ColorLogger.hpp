@@ -45,7 +45,7 @@ public:
         Logger(title, style) {}
 
 protected:
-    virtual void LogInternal(std::string_view msg, LogLevel lvl) noexcept override;
+    virtual void LogInternal(const LogRecord& record) noexcept override;
 };
 
 }
\ No newline at end of file
@@ -1,16 +1,20 @@
 #pragma once
 
+#include "FileSink.hpp"
 #include "Logger.hpp"
+#include "Sink.hpp"
 
+#include "../Config/Flush.hpp"
+#include "../Config/Rotation.hpp"
 #include "../Config/Style.hpp"
 
-#include <fstream>
 #include <filesystem>
 
 namespace rklog {
 
 /**
- * Class acting as an interface for file logging
+ * Class acting as an interface for file logging, see `rklog::FileSink`. Each
+ * log line is rendered once, also when it is copied to `stderr`
  */
 class FileLogger final : public Logger
 {
@@ -20,9 +24,13 @@ public:
      *
      * @param[in] filePath
      *      The path to the file to log to
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
      */
-    FileLogger(const std::filesystem::path& filePath) noexcept :
-        Logger(), m_FileHandle(filePath) {}
+    FileLogger(const std::filesystem::path& filePath, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        Logger(), m_File(filePath, policy, rotation) {}
     
     /**
      * Creates an instance of a file logger with a title
@@ -31,9 +39,13 @@ public:
      *      The path to the file to log to
      * @param[in] title
      *      The title of the logger
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
      */
-    FileLogger(const std::filesystem::path& filePath, std::string_view title) noexcept :
-        Logger(title), m_FileHandle(filePath) {}
+    FileLogger(const std::filesystem::path& filePath, std::string_view title, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        Logger(title), m_File(filePath, policy, rotation) {}
     
     /**
      * Creates an instance of a file logger with a custom style
@@ -42,9 +54,13 @@ public:
      *      The path to the file to log to
      * @param[in] style
      *      The custom style of the logger
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
      */
-    FileLogger(const std::filesystem::path& filePath, LogStyle style) noexcept :
-        Logger(style), m_FileHandle(filePath) {}
+    FileLogger(const std::filesystem::path& filePath, LogStyle style, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        Logger(style), m_File(filePath, policy, rotation) {}
     
     /**
      * Creates an instance of a file logger with a title and a custom style
@@ -55,10 +71,47 @@ public:
      *      The title of the logger
      * @param[in] style
      *      The custom style of the logger
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
      */
-    FileLogger(const std::filesystem::path& filePath, std::string_view title, LogStyle style) noexcept :
-        Logger(title, style), m_FileHandle(filePath) {}
+    FileLogger(const std::filesystem::path& filePath, std::string_view title, LogStyle style, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        Logger(title, style), m_File(filePath, policy, rotation) {}
     
+    FileLogger(const FileLogger&) = delete;
+    FileLogger(FileLogger&&) = delete;
+
+    /**
+     * Hands the buffered log lines to the operating system. This does not
+     * wait for the data to reach the disk
+     */
+    virtual void Flush() noexcept override { m_File.Flush(); }
+
+    /**
+     * Sets how the logger serializes its writes, both to the file and to
+     * `stderr`. Must be set before the logger is shared between threads
+     *
+     * @param[in] policy
+     *      The new lock policy
+     */
+    virtual void SetLockPolicy(LockPolicy policy) noexcept override
+    {
+        Logger::SetLockPolicy(policy);
+        m_File.SetLockPolicy(policy);
+        m_StdErr.SetLockPolicy(policy);
+    }
+
+    /**
+     * Gets a snapshot of the statistics of the logger, including the bytes
+     * written, write system calls made, time spent in them and flushes of
+     * both the file and `stderr`
+     *
+     * @return
+     *      The statistics counted since the logger was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
     /**
      * Enables this logger to log to `stderr` as well
      */
@@ -70,11 +123,13 @@ public:
     constexpr void DisableWriteToStdErr() noexcept { m_WriteToStdErr = false; }
 
 protected:
-    virtual void LogInternal(std::string_view msg, LogLevel level) noexcept override;
+    virtual void LogInternal(const LogRecord& record) noexcept override;
 
 private:
-    /// The handle to the file that this logger is logging to
-    std::ofstream m_FileHandle{};
+    /// The sink writing to the file
+    FileSink m_File;
+    /// The sink writing the colored copy to `stderr`
+    StdErrSink m_StdErr{true};
     /// A flag indicating whether the logger should log to `stderr` too
     bool m_WriteToStdErr{};
 };
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Sink.hpp"
+
+#include "../Config/Flush.hpp"
+#include "../Config/Rotation.hpp"
+
+#include "../Core/Archive.hpp"
+#include "../Core/File.hpp"
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace rklog {
+
+/**
+ * Class acting as a sink writing to a file. Log lines are collected in a
+ * buffer and written to the file descriptor according to the flush policy.
+ * The file is rotated according to the rotation policy, in which case an
+ * existing file is appended to rather than truncated
+ */
+class FileSink : public Sink
+{
+public:
+    /**
+     * Creates a sink writing to a file
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
+     */
+    FileSink(const std::filesystem::path& filePath, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        Sink(false), m_Writer(filePath, policy.GetBufferSize(), rotation.IsEnabled()), m_Policy(policy),
+        m_Path(filePath), m_Rotation(rotation), m_Archiver(filePath, rotation) { Start(); }
+
+    /**
+     * Stops the flush timer and writes the remaining buffered log lines
+     */
+    ~FileSink() noexcept;
+
+    /**
+     * Gets a snapshot of the statistics of the sink, including the bytes
+     * written, write system calls made, time spent in them and flushes
+     *
+     * @return
+     *      The statistics counted since the sink was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
+protected:
+    virtual void WriteInternal(const LogLine& line) noexcept override;
+    virtual void FlushInternal() noexcept override;
+
+    /**
+     * Gets the text written to the file for a log line. By default the line
+     * as rendered by the logger, without color
+     *
+     * @param[in] line
+     *      The log line to write
+     * @param[out] scratch
+     *      The string the text can be written to, if it is not the line itself
+     *
+     * @return
+     *      A view of the text, including its line break
+     */
+    virtual std::string_view RenderLine(const LogLine& line, std::string& scratch) const noexcept;
+
+private:
+    /**
+     * Schedules the first rotation and, if the policy asks for a flush
+     * timer, makes the lock of the sink shared with it
+     */
+    void Start() noexcept;
+
+    /**
+     * Moves the current file aside and opens a new one in its place. The
+     * buffer is flushed to the old file first, so no record is lost or
+     * written twice
+     *
+     * @param[in] now
+     *      The nanoseconds since the epoch of the record causing the rotation
+     */
+    void Rotate(int64_t now) noexcept;
+
+    /**
+     * The loop of the flush timer
+     */
+    void RunFlushTimer() noexcept;
+
+private:
+    /// The buffered writer of the file that this sink is writing to
+    FileWriter m_Writer;
+    /// How log lines are buffered and flushed
+    FlushPolicy m_Policy;
+    /// The path to the file that this sink is writing to
+    std::filesystem::path m_Path;
+    /// When the file is rotated
+    RotationPolicy m_Rotation;
+    /// Compresses and prunes the rotated files
+    FileArchiver m_Archiver;
+    /// The number of bytes written to the current file
+    uint64_t m_FileSize{};
+    /// The nanoseconds since the epoch at which the file is next rotated
+    int64_t m_NextRotation{};
+    /// Protects the stop flag of the flush timer
+    std::mutex m_TimerMutex{};
+    /// Wakes the flush timer when the sink is destroyed
+    std::condition_variable m_TimerSignal{};
+    /// A flag indicating whether the flush timer should stop
+    bool m_StopTimer{};
+    /// The thread flushing the buffer periodically, started with the first
+    /// line written if the policy asks for one
+    std::thread m_Timer{};
+};
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "FileSink.hpp"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Class acting as a sink writing JSON Lines to a file: one object per log,
+ * holding the time in UTC, the level, the title of the logger, the message,
+ * the source location, the thread and the structured fields of the log, e.g.
+ *
+ * `{"time":"2024-05-01T12:00:00.000000Z","level":"INFO","logger":"net","msg":"request done","file":"server.cpp","line":42,"func":"void Serve()","thread":1,"latency_us":250}`
+ *
+ * A field named like one of these members is written with a `fields.` prefix,
+ * e.g. `"fields.msg"`, so that no key appears twice. The pattern of the
+ * logger is not used. Buffering, flushing and rotation work as they do for a
+ * `rklog::FileSink`
+ */
+class JsonSink final : public FileSink
+{
+public:
+    /**
+     * Creates a sink writing JSON Lines to a file
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] policy
+     *      How log lines are buffered and flushed
+     * @param[in] rotation
+     *      When the file is rotated and what happens to the rotated files
+     */
+    JsonSink(const std::filesystem::path& filePath, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, RotationPolicy rotation = defaults::DEFAULT_ROTATION_POLICY) noexcept :
+        FileSink(filePath, policy, rotation) {}
+
+protected:
+    virtual std::string_view RenderLine(const LogLine& line, std::string& scratch) const noexcept override;
+};
+
+}
@@ -1,10 +1,26 @@
 #pragma once
 
+#include "Backtrace.hpp"
+
 #include "../Config/Level.hpp"
 #include "../Config/Style.hpp"
 
+#include "../Core/Buffer.hpp"
+#include "../Core/Deferred.hpp"
+#include "../Core/Field.hpp"
+#include "../Core/Format.hpp"
+#include "../Core/Limit.hpp"
+#include "../Core/Lock.hpp"
+#include "../Core/Record.hpp"
+#include "../Core/Stats.hpp"
+#include "../Core/Thread.hpp"
+
+#include <atomic>
 #include <format>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace rklog {
@@ -14,6 +30,10 @@ namespace rklog {
  */
 class Logger
 {
+public:
+    /// The default number of records kept by the backtrace of a logger
+    static constexpr size_t DEFAULT_BACKTRACE_CAPACITY = 256;
+
 public:
     constexpr Logger() noexcept = default;
 
@@ -46,6 +66,189 @@ public:
     constexpr Logger(std::string_view title, LogStyle style) noexcept :
         m_Title(title), m_Style(style) {}
 
+    virtual ~Logger() = default;
+
+    /**
+     * Sets the minimum log level of the logger. Logs below this level are
+     * dropped before any formatting happens
+     *
+     * @param[in] level
+     *      The new minimum log level
+     */
+    inline void SetLevel(LogLevel level) noexcept { m_Level.store(level, std::memory_order_relaxed); }
+
+    /**
+     * Gets the minimum log level of the logger
+     *
+     * @return
+     *      The minimum log level
+     */
+    inline LogLevel GetLevel() const noexcept { return m_Level.load(std::memory_order_relaxed); }
+
+    /**
+     * Sets how the logger serializes the final write of each log line. The
+     * default is `LockPolicy::MUTEX`; `LockPolicy::NONE` is only safe if the
+     * logger is used by a single thread, and still locks against the flush
+     * timer of a logger flushed on an interval. Must be set before the logger
+     * is shared between threads
+     *
+     * @param[in] policy
+     *      The new lock policy
+     */
+    virtual void SetLockPolicy(LockPolicy policy) noexcept { m_Lock.SetPolicy(policy); }
+
+    /**
+     * Gets how the logger serializes the final write of each log line
+     *
+     * @return
+     *      The lock policy
+     */
+    constexpr LockPolicy GetLockPolicy() const noexcept { return m_Lock.GetPolicy(); }
+
+    /**
+     * Checks whether a log of the given level would be written by this logger
+     *
+     * @param[in] level
+     *      The log level to check
+     *
+     * @return
+     *      `true` if the log level is compiled in and not below the minimum
+     *      log level of the logger
+     */
+    inline bool IsEnabled(LogLevel level) const noexcept
+    {
+        return IsLevelActive(level) && level >= m_Level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Checks whether a log of the given level would be written by this logger
+     * or kept in its backtrace
+     *
+     * @param[in] level
+     *      The log level to check
+     *
+     * @return
+     *      `true` if the log level is compiled in and either not below the
+     *      minimum log level of the logger or the backtrace is enabled
+     */
+    inline bool IsCaptured(LogLevel level) const noexcept
+    {
+        return IsLevelActive(level) && (level >= m_Level.load(std::memory_order_relaxed) || m_Backtrace);
+    }
+
+    /**
+     * Starts keeping the most recent logs below the minimum log level in a
+     * ring, see `rklog::BacktraceRing`. The ring is written out before the
+     * next error or fatal log, or by `DumpBacktrace()`. Must be called before
+     * the logger is shared between threads
+     *
+     * @param[in] capacity
+     *      The number of logs to keep
+     */
+    void EnableBacktrace(size_t capacity = DEFAULT_BACKTRACE_CAPACITY) noexcept;
+
+    /**
+     * Stops keeping logs below the minimum log level, dropping the ones kept.
+     * Must not be called while other threads are logging
+     */
+    void DisableBacktrace() noexcept;
+
+    /**
+     * Writes out the logs kept in the backtrace, oldest first and with their
+     * original level and time, between a pair of notices
+     *
+     * @return
+     *      The number of logs written
+     */
+    size_t DumpBacktrace() noexcept;
+
+    /**
+     * Logs a message to `stderr` with the given log level. Arguments created
+     * with `rklog::kv()` are logged as structured fields rather than being
+     * formatted into the message
+     *
+     * @param[in] level
+     *      The log level severity to log the message with
+     * @param[in] fmt
+     *      The format of the message
+     * @param[in] args
+     *      Any variadic arguments passed to the function
+     */
+    template<typename ... Args>
+    void Log(LogLevel level, const FormatString<Args...> fmt, Args&& ... args) noexcept
+    {
+        if (!IsEnabled(level))
+        {
+            if (m_Backtrace && IsLevelActive(level))
+                m_Backtrace->Store(MakeRecord({}, level, fmt.GetLocation()), fmt.Get(), std::forward<Args>(args)...);
+
+            return;
+        }
+
+        // The context of an error is written before the error itself
+        if (level >= LogLevel::LOG_ERROR && m_Backtrace)
+            DumpBacktrace();
+
+        m_Counters.CountRecord(level);
+        if constexpr ((DeferrableArg<Args> && ...))
+        {
+            if (m_DeferFormatting)
+            {
+                DeferredMessage deferred{};
+                if (deferred.Capture(fmt.Get().get(), args...))
+                {
+                    LogDeferred(deferred, MakeRecord({}, level, fmt.GetLocation()));
+                    return;
+                }
+            }
+        }
+
+        const auto fields = CollectFields(args...);
+        FormatBuffer msg{};
+        std::format_to(std::back_inserter(*msg), fmt.Get(), std::forward<Args>(args)...);
+        LogInternal(MakeRecord(*msg, level, fmt.GetLocation(), fields));
+    }
+
+    /**
+     * Logs a message unless it repeats the last message the deduplicator let
+     * through within its window. Messages are compared by their arguments
+     * before anything is formatted; messages with arguments that cannot be
+     * hashed are always logged. The first message let through after repeats
+     * were dropped is preceded by a count of them
+     *
+     * @param[in] dedup
+     *      The deduplicator of the call site
+     * @param[in] level
+     *      The log level severity to log the message with
+     * @param[in] fmt
+     *      The format of the message
+     * @param[in] args
+     *      Any variadic arguments passed to the function
+     */
+    template<typename ... Args>
+    void LogDeduplicated(Deduplicator& dedup, LogLevel level, const FormatString<Args...> fmt, Args&& ... args) noexcept
+    {
+        if (!IsEnabled(level))
+            return;
+
+        size_t hash{};
+        uint64_t repeated{};
+        if (HashArgs(hash, args...) && !dedup.Check(hash, repeated))
+        {
+            m_Counters.CountSuppressed(1);
+            return;
+        }
+
+        if (repeated > 0)
+        {
+            FormatBuffer notice{};
+            std::format_to(std::back_inserter(*notice), "last message repeated {} times", repeated);
+            LogInternal(MakeRecord(*notice, level, fmt.GetLocation()));
+        }
+
+        Log(level, fmt, std::forward<Args>(args)...);
+    }
+
     /**
      * Logs a message to `stderr` with a debug log level
      *
@@ -55,10 +258,10 @@ public:
      *      Any variadic arguments passed to the function
      */
     template<typename ... Args>
-    void Debug(const std::format_string<Args...> fmt, Args&& ... args) noexcept
+    void Debug(const FormatString<Args...> fmt, Args&& ... args) noexcept
     {
-        const std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        LogInternal(msg, LogLevel::LOG_DEBUG);
+        if constexpr (IsLevelActive(LogLevel::LOG_DEBUG))
+            Log(LogLevel::LOG_DEBUG, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -70,10 +273,10 @@ public:
      *      Any variadic arguments passed to the function
      */
     template<typename ... Args>
-    void Info(const std::format_string<Args...> fmt, Args&& ... args) noexcept
+    void Info(const FormatString<Args...> fmt, Args&& ... args) noexcept
     {
-        const std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        LogInternal(msg, LogLevel::LOG_INFO);
+        if constexpr (IsLevelActive(LogLevel::LOG_INFO))
+            Log(LogLevel::LOG_INFO, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -85,10 +288,10 @@ public:
      *      Any variadic arguments passed to the function
      */
     template<typename ... Args>
-    void Warn(const std::format_string<Args...> fmt, Args&& ... args) noexcept
+    void Warn(const FormatString<Args...> fmt, Args&& ... args) noexcept
     {
-        const std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        LogInternal(msg, LogLevel::LOG_WARNING);
+        if constexpr (IsLevelActive(LogLevel::LOG_WARNING))
+            Log(LogLevel::LOG_WARNING, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -100,10 +303,10 @@ public:
      *      Any variadic arguments passed to the function
      */
     template<typename ... Args>
-    void Error(const std::format_string<Args...> fmt, Args&& ... args) noexcept
+    void Error(const FormatString<Args...> fmt, Args&& ... args) noexcept
     {
-        const std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        LogInternal(msg, LogLevel::LOG_ERROR);
+        if constexpr (IsLevelActive(LogLevel::LOG_ERROR))
+            Log(LogLevel::LOG_ERROR, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -115,28 +318,93 @@ public:
      *      Any variadic arguments passed to the function
      */
     template<typename ... Args>
-    void Fatal(const std::format_string<Args...> fmt, Args&& ... args) noexcept
+    void Fatal(const FormatString<Args...> fmt, Args&& ... args) noexcept
     {
-        const std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        LogInternal(msg, LogLevel::LOG_FATAL);
+        if constexpr (IsLevelActive(LogLevel::LOG_FATAL))
+            Log(LogLevel::LOG_FATAL, fmt, std::forward<Args>(args)...);
     }
 
+    /**
+     * Writes any records buffered by the logger to its output
+     */
+    virtual void Flush() noexcept {}
+
+    /**
+     * Gets a snapshot of the statistics of the logger: the records logged per
+     * level and suppressed, plus whatever its output counts, such as bytes
+     * written and the time spent writing. Never blocks logging threads
+     *
+     * @return
+     *      The statistics counted since the logger was created
+     */
+    virtual LogStats GetStats() const noexcept { return m_Counters.Get(); }
+
+    /**
+     * Counts records dropped before reaching the logger, e.g. by a rate limit
+     *
+     * @param[in] count
+     *      The number of records
+     */
+    inline void CountSuppressed(uint64_t count) noexcept { m_Counters.CountSuppressed(count); }
+
 protected:
     /**
      * Internal implementation of the logger
      *
+     * @param[in] record
+     *      The record to log. Its message is assumed to be already formatted
+     */
+    virtual void LogInternal(const LogRecord& record) noexcept = 0;
+
+    /**
+     * Logs a message whose formatting has been deferred. Only called when
+     * `m_DeferFormatting` is set. By default the message is formatted right
+     * away and passed on to `LogInternal()`
+     *
      * @param[in] msg
-     *      The message to log. Assumed to be already formatted
+     *      The captured format and arguments of the message
+     * @param[in] record
+     *      The record of the log, without its message
+     */
+    virtual void LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept;
+
+    /**
+     * Creates a record of a log made by the calling thread right now
+     *
+     * @param[in] msg
+     *      The formatted message
      * @param[in] level
-     *      The log level severity to log the message with
+     *      The log level severity of the log
+     * @param[in] location
+     *      The source location of the log call
+     * @param[in] fields
+     *      The structured fields of the log
+     *
+     * @return
+     *      The record of the log
      */
-    virtual void LogInternal(std::string_view msg, LogLevel level) noexcept = 0;
+    inline LogRecord MakeRecord(std::string_view msg, LogLevel level, std::source_location location, std::span<const Field> fields = {}) const noexcept
+    {
+        return LogRecord{msg, level, TimeStamp::Now(m_Style.GetClockSource()), location, GetThreadId(), fields};
+    }
 
 protected:
     /// The title of the logger
     std::optional<std::string> m_Title{};
     /// The styling of the logger
     LogStyle m_Style{defaults::DEFAULT_STYLE};
+    /// The minimum log level of the logger
+    std::atomic<LogLevel> m_Level{LogLevel::LOG_DEBUG};
+    /// A flag indicating whether formatting should be deferred to `LogDeferred()`
+    bool m_DeferFormatting{};
+    /// Serializes the final write of each log line
+    mutable WriteLock m_Lock{};
+    /// Counts the records of the logger
+    LogCounters m_Counters{};
+    /// The recent logs below the minimum log level, if enabled
+    std::unique_ptr<BacktraceRing> m_Backtrace{};
+
+    friend class AsyncLogger;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Logger.hpp"
+#include "Site.hpp"
+
+#include "../Config/Level.hpp"
+
+#include "../Core/Limit.hpp"
+#include "../Core/Sample.hpp"
+
+// --- level checked logging --------------------------------------------------
+//
+// Unlike calling the logger directly, these only evaluate their arguments if
+// the log level is enabled, and expand to nothing if the level is below
+// `RKLOG_ACTIVE_LEVEL`. Each statement of the level macros is also a call
+// site that can be switched off at runtime, see `rklog::CallSite`. Logs below
+// the level of the logger still reach its backtrace, if enabled
+
+#define RKLOG_LOG(logger, level, ...)                      \
+    do                                                     \
+    {                                                      \
+        ::rklog::Logger& rklogLogger_ = (logger);          \
+        if (rklogLogger_.IsCaptured(level))                \
+            rklogLogger_.Log((level), __VA_ARGS__);        \
+    } while (false)
+
+#if RKLOG_ACTIVE_LEVEL <= RKLOG_LEVEL_DEBUG
+#define RKLOG_DEBUG(logger, ...) RKLOG_LOG_SITE_(logger, ::rklog::LogLevel::LOG_DEBUG, __VA_ARGS__)
+#else
+#define RKLOG_DEBUG(logger, ...) ((void)0)
+#endif
+
+#if RKLOG_ACTIVE_LEVEL <= RKLOG_LEVEL_INFO
+#define RKLOG_INFO(logger, ...) RKLOG_LOG_SITE_(logger, ::rklog::LogLevel::LOG_INFO, __VA_ARGS__)
+#else
+#define RKLOG_INFO(logger, ...) ((void)0)
+#endif
+
+#if RKLOG_ACTIVE_LEVEL <= RKLOG_LEVEL_WARNING
+#define RKLOG_WARN(logger, ...) RKLOG_LOG_SITE_(logger, ::rklog::LogLevel::LOG_WARNING, __VA_ARGS__)
+#else
+#define RKLOG_WARN(logger, ...) ((void)0)
+#endif
+
+#if RKLOG_ACTIVE_LEVEL <= RKLOG_LEVEL_ERROR
+#define RKLOG_ERROR(logger, ...) RKLOG_LOG_SITE_(logger, ::rklog::LogLevel::LOG_ERROR, __VA_ARGS__)
+#else
+#define RKLOG_ERROR(logger, ...) ((void)0)
+#endif
+
+#if RKLOG_ACTIVE_LEVEL <= RKLOG_LEVEL_FATAL
+#define RKLOG_FATAL(logger, ...) RKLOG_LOG_SITE_(logger, ::rklog::LogLevel::LOG_FATAL, __VA_ARGS__)
+#else
+#define RKLOG_FATAL(logger, ...) ((void)0)
+#endif
+
+// --- rate limited logging ---------------------------------------------------
+//
+// Each call site gets its own token bucket letting `perSecond` logs through
+// per second, with bursts of up to `burst`. The bucket is checked before the
+// arguments are evaluated, and the first log let through after others were
+// dropped is preceded by a count of them. Nothing reports the count once the
+// call site goes quiet, so the logs dropped in a final burst only show up in
+// the suppressed counter of `rklog::Logger::GetStats()`
+
+#define RKLOG_LOG_LIMITED(logger, level, perSecond, burst, ...)                                       \
+    do                                                                                                \
+    {                                                                                                 \
+        ::rklog::Logger& rklogLogger_ = (logger);                                                     \
+        if (rklogLogger_.IsEnabled(level))                                                            \
+        {                                                                                             \
+            static ::rklog::RateLimiter rklogLimiter_{(perSecond), (burst)};                          \
+            uint64_t rklogDropped_{};                                                                 \
+            if (rklogLimiter_.TryAcquire(rklogDropped_))                                              \
+            {                                                                                         \
+                if (rklogDropped_ > 0)                                                                \
+                    rklogLogger_.Log((level), "{} logs suppressed by the rate limit", rklogDropped_); \
+                rklogLogger_.Log((level), __VA_ARGS__);                                               \
+            }                                                                                         \
+            else                                                                                      \
+            {                                                                                         \
+                rklogLogger_.CountSuppressed(1);                                                      \
+            }                                                                                         \
+        }                                                                                             \
+    } while (false)
+
+// --- deduplicated logging ---------------------------------------------------
+//
+// Drops logs of a call site that repeat the last one written within `window`
+// (a `std::chrono` duration), see `rklog::Logger::LogDeduplicated()`. As with
+// the rate limit, the repeats are only reported by the next log written, so
+// a final run of them only shows up in the stats of the logger
+
+#define RKLOG_LOG_DEDUP(logger, level, window, ...)                          \
+    do                                                                       \
+    {                                                                        \
+        ::rklog::Logger& rklogLogger_ = (logger);                            \
+        if (rklogLogger_.IsEnabled(level))                                   \
+        {                                                                    \
+            static ::rklog::Deduplicator rklogDedup_{(window)};              \
+            rklogLogger_.LogDeduplicated(rklogDedup_, (level), __VA_ARGS__); \
+        }                                                                    \
+    } while (false)
+
+// --- sampled logging --------------------------------------------------------
+//
+// Each call site keeps its own counter in a static. Logs that are not sampled
+// are dropped before their arguments are evaluated, and logs below the level
+// of the logger are not counted
+
+#define RKLOG_LOG_SAMPLED_(logger, level, sampler, ...) \
+    do                                                  \
+    {                                                   \
+        ::rklog::Logger& rklogLogger_ = (logger);       \
+        if (rklogLogger_.IsEnabled(level))              \
+        {                                               \
+            static auto rklogSampler_ = sampler;        \
+            if (rklogSampler_.Check())                  \
+                rklogLogger_.Log((level), __VA_ARGS__); \
+        }                                               \
+    } while (false)
+
+// Writes the 1st, (n+1)-th, (2n+1)-th, ... log of the call site
+#define RKLOG_LOG_EVERY_N(logger, level, n, ...) \
+    RKLOG_LOG_SAMPLED_(logger, level, ::rklog::EveryNSampler{(n)}, __VA_ARGS__)
+
+// Writes the first n logs of the call site
+#define RKLOG_LOG_FIRST_N(logger, level, n, ...) \
+    RKLOG_LOG_SAMPLED_(logger, level, ::rklog::FirstNSampler{(n)}, __VA_ARGS__)
+
+// Writes the given fraction (between 0 and 1) of the logs of the call site
+#define RKLOG_LOG_SAMPLED(logger, level, probability, ...) \
+    RKLOG_LOG_SAMPLED_(logger, level, ::rklog::ProbabilitySampler{(probability)}, __VA_ARGS__)
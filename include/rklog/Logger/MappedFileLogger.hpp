@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Logger.hpp"
+
+#include "../Config/Style.hpp"
+
+#include "../Core/Mapped.hpp"
+#include "../Core/Platform.hpp"
+
+#include <filesystem>
+
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+
+namespace rklog {
+
+/**
+ * Class acting as an interface for high-throughput file logging. Log lines
+ * are copied straight into a memory mapping of the file, see
+ * `rklog::MappedFile`, so no system calls are made until a segment fills up
+ */
+class MappedFileLogger final : public Logger
+{
+public:
+    /// The default size of each segment of the file
+    static constexpr size_t DEFAULT_SEGMENT_SIZE = 64 * 1024 * 1024;
+
+public:
+    /**
+     * Creates an instance of a memory-mapped file logger
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] segmentSize
+     *      The number of bytes preallocated and mapped at a time
+     */
+    MappedFileLogger(const std::filesystem::path& filePath, size_t segmentSize = DEFAULT_SEGMENT_SIZE) noexcept :
+        Logger(), m_File(filePath, segmentSize) {}
+
+    /**
+     * Creates an instance of a memory-mapped file logger with a title
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] segmentSize
+     *      The number of bytes preallocated and mapped at a time
+     */
+    MappedFileLogger(const std::filesystem::path& filePath, std::string_view title, size_t segmentSize = DEFAULT_SEGMENT_SIZE) noexcept :
+        Logger(title), m_File(filePath, segmentSize) {}
+
+    /**
+     * Creates an instance of a memory-mapped file logger with a custom style
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] style
+     *      The custom style of the logger
+     * @param[in] segmentSize
+     *      The number of bytes preallocated and mapped at a time
+     */
+    MappedFileLogger(const std::filesystem::path& filePath, LogStyle style, size_t segmentSize = DEFAULT_SEGMENT_SIZE) noexcept :
+        Logger(style), m_File(filePath, segmentSize) {}
+
+    /**
+     * Creates an instance of a memory-mapped file logger with a title and a
+     * custom style
+     *
+     * @param[in] filePath
+     *      The path to the file to log to
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] style
+     *      The custom style of the logger
+     * @param[in] segmentSize
+     *      The number of bytes preallocated and mapped at a time
+     */
+    MappedFileLogger(const std::filesystem::path& filePath, std::string_view title, LogStyle style, size_t segmentSize = DEFAULT_SEGMENT_SIZE) noexcept :
+        Logger(title, style), m_File(filePath, segmentSize) {}
+
+    MappedFileLogger(const MappedFileLogger&) = delete;
+    MappedFileLogger(MappedFileLogger&&) = delete;
+
+    /**
+     * Blocks until everything logged so far has reached the disk. Not needed
+     * to survive a crash of the process, only one of the machine
+     */
+    void Sync() noexcept;
+
+protected:
+    virtual void LogInternal(const LogRecord& record) noexcept override;
+
+private:
+    /// The mapped file that this logger is logging to
+    MappedFile m_File;
+};
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Logger.hpp"
+
+#include "../Config/Level.hpp"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rklog {
+
+/// Creates the logger for a name that has not been registered
+using LoggerFactory = std::function<std::shared_ptr<Logger>(std::string_view name)>;
+
+/**
+ * Class referring to a named logger of a `rklog::LoggerRegistry`. Stays valid
+ * for as long as the registry and follows the name if another logger is
+ * registered under it. Dereferencing it is a single atomic load
+ */
+class LoggerHandle final
+{
+public:
+    /**
+     * Creates a handle
+     *
+     * @param[in] logger
+     *      The slot of the registry holding the logger
+     */
+    constexpr explicit LoggerHandle(const std::atomic<Logger*>& logger) noexcept :
+        m_Logger(&logger) {}
+
+    /**
+     * Gets the logger
+     *
+     * @return
+     *      The logger currently registered under the name
+     */
+    inline Logger& operator*() const noexcept { return *m_Logger->load(std::memory_order_acquire); }
+
+    /**
+     * Gets the logger
+     *
+     * @return
+     *      The logger currently registered under the name
+     */
+    inline Logger* operator->() const noexcept { return m_Logger->load(std::memory_order_acquire); }
+
+private:
+    /// The slot of the registry holding the logger
+    const std::atomic<Logger*>* m_Logger;
+};
+
+/**
+ * Class containing loggers by dotted name, such as `net.http.client`. A level
+ * set on a name applies to every logger below it that has no level of its own,
+ * and is pushed to the loggers when it is set, so checking the level while
+ * logging costs the same as for any other logger
+ *
+ * Looking a logger up by name takes a lock; code that logs often should keep
+ * a `rklog::LoggerHandle`, see `RKLOG_LOGGER()`
+ */
+class LoggerRegistry final
+{
+public:
+    /**
+     * Creates an empty registry whose unregistered names get a color logger
+     * titled with the name
+     */
+    LoggerRegistry() noexcept;
+
+    LoggerRegistry(const LoggerRegistry&) = delete;
+    LoggerRegistry(LoggerRegistry&&) = delete;
+
+    /**
+     * Registers a logger under a name, replacing any logger registered under
+     * it before. The replaced logger is kept alive, since other threads may
+     * still be logging to it. The logger takes the level of the name if one
+     * was set on it or on a name above it
+     *
+     * @param[in] name
+     *      The dotted name of the logger
+     * @param[in] logger
+     *      The logger
+     */
+    void Register(std::string_view name, std::shared_ptr<Logger> logger) noexcept;
+
+    /**
+     * Gets a handle to the logger of a name, creating the logger through the
+     * factory if no logger was registered under it
+     *
+     * @param[in] name
+     *      The dotted name of the logger
+     *
+     * @return
+     *      The handle to the logger
+     */
+    LoggerHandle GetHandle(std::string_view name) noexcept;
+
+    /**
+     * Gets the logger of a name, creating it through the factory if no logger
+     * was registered under it
+     *
+     * @param[in] name
+     *      The dotted name of the logger
+     *
+     * @return
+     *      The logger
+     */
+    inline Logger& Get(std::string_view name) noexcept { return *GetHandle(name); }
+
+    /**
+     * Sets the minimum log level of a name and every name below it that has
+     * no level of its own. The empty name is the root of every name
+     *
+     * @param[in] name
+     *      The dotted name
+     * @param[in] level
+     *      The new minimum log level
+     */
+    void SetLevel(std::string_view name, LogLevel level) noexcept;
+
+    /**
+     * Sets how loggers are created for names that have not been registered.
+     * The factory must always return a logger. It is called while the
+     * registry is locked, so it must not use the registry itself
+     *
+     * @param[in] factory
+     *      The new factory
+     */
+    void SetFactory(LoggerFactory factory) noexcept;
+
+private:
+    /**
+     * Struct containing a registered logger
+     */
+    struct Entry
+    {
+    public:
+        std::atomic<Logger*> logger{};   // The logger handed out through handles
+        std::shared_ptr<Logger> owner{}; // Keeps the logger alive
+    };
+
+private:
+    /**
+     * Gets the level set on the nearest name at or above a name
+     *
+     * @param[in] name
+     *      The dotted name
+     *
+     * @return
+     *      The inherited level, if any name above sets one
+     */
+    std::optional<LogLevel> GetInheritedLevel(std::string_view name) const noexcept;
+
+private:
+    /// The registered loggers. Nodes of the map never move, so handles can
+    /// refer to their entries
+    std::map<std::string, Entry, std::less<>> m_Entries{};
+    /// The levels set on names
+    std::map<std::string, LogLevel, std::less<>> m_Levels{};
+    /// Loggers replaced by others, which may still be in use
+    std::vector<std::shared_ptr<Logger>> m_Replaced{};
+    /// Creates the loggers of unregistered names
+    LoggerFactory m_Factory;
+    /// Serializes changes to the registry
+    mutable std::mutex m_Mutex{};
+};
+
+/**
+ * Gets the global logger registry
+ *
+ * @return
+ *      The global registry
+ */
+LoggerRegistry& GetRegistry() noexcept;
+
+/**
+ * Gets a logger of the global registry by name, see `rklog::LoggerRegistry`
+ *
+ * @param[in] name
+ *      The dotted name of the logger
+ *
+ * @return
+ *      The logger
+ */
+inline Logger& GetLogger(std::string_view name) noexcept { return GetRegistry().Get(name); }
+
+}
+
+// --- call site logger handles -----------------------------------------------
+//
+// Expands to the logger of the global registry with the given name, looking
+// the name up once per call site and caching the handle in a static. The name
+// has to be a constant, e.g. `RKLOG_INFO(RKLOG_LOGGER("net.http"), "{}", x)`
+
+#define RKLOG_LOGGER(name)                                                       \
+    (*[]() noexcept -> const ::rklog::LoggerHandle&                              \
+    {                                                                            \
+        static const ::rklog::LoggerHandle rklogHandle_ =                        \
+            ::rklog::GetRegistry().GetHandle(name);                              \
+        return rklogHandle_;                                                     \
+    }())
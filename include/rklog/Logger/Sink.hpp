@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../Config/Level.hpp"
+#include "../Config/Pattern.hpp"
+
+#include "../Core/Lock.hpp"
+#include "../Core/Record.hpp"
+#include "../Core/Stats.hpp"
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Class containing a log line rendered once and shared between every sink it
+ * is written to. The text is rendered without color; the decorations that
+ * coloring adds are marked in it instead
+ */
+class LogLine final
+{
+public:
+    /**
+     * Creates a log line
+     *
+     * @param[in] record
+     *      The record the line was rendered from
+     * @param[in] title
+     *      The title of the logger, empty if it has none
+     * @param[in] text
+     *      The rendered line, including its line break
+     * @param[in] marks
+     *      The decorations of the line
+     * @param[in] colorCode
+     *      The color of the log level
+     */
+    constexpr LogLine(const LogRecord& record, std::string_view title, std::string_view text, const ColorMarks& marks, std::string_view colorCode) noexcept :
+        m_Record(record), m_Title(title), m_Text(text), m_Marks(marks), m_ColorCode(colorCode) {}
+
+    /**
+     * Gets the record the line was rendered from
+     *
+     * @return
+     *      The record of the log
+     */
+    constexpr const LogRecord& GetRecord() const noexcept { return m_Record; }
+
+    /**
+     * Gets the log level of the line
+     *
+     * @return
+     *      The log level
+     */
+    constexpr LogLevel GetLevel() const noexcept { return m_Record.level; }
+
+    /**
+     * Gets the title of the logger that made the line
+     *
+     * @return
+     *      The title, empty if the logger has none
+     */
+    constexpr std::string_view GetTitle() const noexcept { return m_Title; }
+
+    /**
+     * Gets the text of the line with or without color. Without color the
+     * shared text is usually returned as-is; otherwise the decorations are
+     * applied to a copy
+     *
+     * @param[in] color
+     *      Whether the line should be colored
+     * @param[out] scratch
+     *      The string the decorated copy is written to, if one is needed
+     *
+     * @return
+     *      A view of the text, valid as long as the line and `scratch`
+     */
+    std::string_view Render(bool color, std::string& scratch) const noexcept;
+
+private:
+    /// The record the line was rendered from
+    const LogRecord& m_Record;
+    /// The title of the logger that made the line
+    std::string_view m_Title;
+    /// The rendered line without color
+    std::string_view m_Text;
+    /// The decorations of the line
+    const ColorMarks& m_Marks;
+    /// The color of the log level
+    std::string_view m_ColorCode;
+};
+
+/**
+ * Base class for every destination a `rklog::SinkLogger` writes to. Each sink
+ * has its own minimum log level and lock
+ */
+class Sink
+{
+public:
+    /**
+     * Creates a sink
+     *
+     * @param[in] atomicWrite
+     *      Whether every line is written with a single write system call, see
+     *      `LockPolicy::ATOMIC_WRITE`
+     */
+    constexpr explicit Sink(bool atomicWrite) noexcept :
+        m_AtomicWrite(atomicWrite) {}
+
+    Sink(const Sink&) = delete;
+    Sink(Sink&&) = delete;
+
+    virtual ~Sink() = default;
+
+    /**
+     * Sets the minimum log level of the sink
+     *
+     * @param[in] level
+     *      The new minimum log level
+     */
+    inline void SetLevel(LogLevel level) noexcept { m_Level.store(level, std::memory_order_relaxed); }
+
+    /**
+     * Gets the minimum log level of the sink
+     *
+     * @return
+     *      The minimum log level
+     */
+    inline LogLevel GetLevel() const noexcept { return m_Level.load(std::memory_order_relaxed); }
+
+    /**
+     * Sets how the sink serializes its writes. Must be set before the sink is
+     * shared between threads
+     *
+     * @param[in] policy
+     *      The new lock policy
+     */
+    constexpr void SetLockPolicy(LockPolicy policy) noexcept { m_Lock.SetPolicy(policy); }
+
+    /**
+     * Gets how the sink serializes its writes
+     *
+     * @return
+     *      The lock policy
+     */
+    constexpr LockPolicy GetLockPolicy() const noexcept { return m_Lock.GetPolicy(); }
+
+    /**
+     * Writes a log line if it is not below the minimum log level of the sink
+     *
+     * @param[in] line
+     *      The log line to write
+     */
+    void Write(const LogLine& line) noexcept;
+
+    /**
+     * Writes any lines buffered by the sink to its destination
+     */
+    void Flush() noexcept;
+
+    /**
+     * Gets a snapshot of the statistics of the sink: the lines written per
+     * level plus whatever its destination counts. Never blocks writers
+     *
+     * @return
+     *      The statistics counted since the sink was created
+     */
+    virtual LogStats GetStats() const noexcept { return m_Counters.Get(); }
+
+protected:
+    /**
+     * Internal implementation of the sink, called under its lock
+     *
+     * @param[in] line
+     *      The log line to write
+     */
+    virtual void WriteInternal(const LogLine& line) noexcept = 0;
+
+    /**
+     * Internal implementation of `Flush()`, called under the lock of the sink
+     */
+    virtual void FlushInternal() noexcept {}
+
+protected:
+    /// Serializes the writes of the sink
+    mutable WriteLock m_Lock{};
+    /// Counts the lines written to the sink
+    LogCounters m_Counters{};
+
+private:
+    /// The minimum log level of the sink
+    std::atomic<LogLevel> m_Level{LogLevel::LOG_DEBUG};
+    /// Whether every line is written with a single write system call
+    bool m_AtomicWrite;
+};
+
+/**
+ * Class acting as a sink writing to `stderr`, with or without color
+ */
+class StdErrSink final : public Sink
+{
+public:
+    /**
+     * Creates a sink writing to `stderr`
+     *
+     * @param[in] color
+     *      Whether the lines should be colored
+     */
+    constexpr explicit StdErrSink(bool color) noexcept :
+        Sink(true), m_Color(color) {}
+
+protected:
+    virtual void WriteInternal(const LogLine& line) noexcept override;
+
+private:
+    /// A flag indicating whether the lines are colored
+    bool m_Color;
+};
+
+}
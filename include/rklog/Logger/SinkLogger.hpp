@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Logger.hpp"
+#include "Sink.hpp"
+
+#include "../Config/Style.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rklog {
+
+/**
+ * Class acting as an interface for logging to any number of sinks. Each log
+ * line is rendered once and the same text is handed to every sink, which only
+ * adds its own decoration such as color. Sinks can be attached and detached
+ * while other threads are logging
+ */
+class SinkLogger final : public Logger
+{
+public:
+    SinkLogger() noexcept = default;
+
+    /**
+     * Creates an instance of a sink logger with a title
+     *
+     * @param[in] title
+     *      The title of the logger
+     */
+    SinkLogger(std::string_view title) noexcept :
+        Logger(title) {}
+
+    /**
+     * Creates an instance of a sink logger with a custom style
+     *
+     * @param[in] style
+     *      The custom style of the logger
+     */
+    SinkLogger(LogStyle style) noexcept :
+        Logger(style) {}
+
+    /**
+     * Creates an instance of a sink logger with a title and a custom style
+     *
+     * @param[in] title
+     *      The title of the logger
+     * @param[in] style
+     *      The custom style of the logger
+     */
+    SinkLogger(std::string_view title, LogStyle style) noexcept :
+        Logger(title, style) {}
+
+    SinkLogger(const SinkLogger&) = delete;
+    SinkLogger(SinkLogger&&) = delete;
+
+    /**
+     * Starts writing to a sink. Attaching a sink twice writes every line to
+     * it twice
+     *
+     * @param[in] sink
+     *      The sink to write to
+     */
+    void Attach(std::shared_ptr<Sink> sink) noexcept;
+
+    /**
+     * Stops writing to a sink. Lines that other threads are writing at the
+     * same time may still reach it
+     *
+     * @param[in] sink
+     *      The sink to stop writing to
+     */
+    void Detach(const std::shared_ptr<Sink>& sink) noexcept;
+
+    /**
+     * Writes any lines buffered by the sinks to their destinations
+     */
+    virtual void Flush() noexcept override;
+
+    /**
+     * Gets a snapshot of the statistics of the logger, with the output of
+     * every attached sink added up
+     *
+     * @return
+     *      The statistics counted since the logger was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
+protected:
+    virtual void LogInternal(const LogRecord& record) noexcept override;
+
+private:
+    /// The list of sinks written to
+    using SinkList = std::vector<std::shared_ptr<Sink>>;
+
+private:
+    /// The sinks written to. Replaced as a whole when a sink is attached or
+    /// detached, so a logging thread keeps writing to the list it loaded
+    std::atomic<std::shared_ptr<const SinkList>> m_Sinks{};
+    /// Serializes attaching and detaching sinks
+    std::mutex m_SinksMutex{};
+};
+
+}
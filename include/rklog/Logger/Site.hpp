@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../Config/Level.hpp"
+
+#include "../Core/Platform.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace rklog {
+
+/**
+ * Struct containing what is known about a log statement at compile time
+ */
+struct CallSiteInfo final
+{
+public:
+    const char* file{""};      // The source file of the statement
+    uint32_t line{};           // The source line of the statement
+    const char* function{""};  // The function the statement is in
+    LogLevel level{};          // The log level of the statement
+    std::string_view format{}; // The format string of the statement
+};
+
+/**
+ * Class representing a log statement that can be switched on and off while
+ * the program runs. Every call site of the level macros (`RKLOG_INFO()` and
+ * friends) has one, linked into a global list before `main()` runs, so even
+ * statements that never ran can be found and toggled
+ */
+class CallSite final
+{
+public:
+    /**
+     * Registers a call site, applying the rules set so far by
+     * `EnableCallSites()` and `DisableCallSites()`
+     *
+     * @param[in] info
+     *      The compile time information about the statement
+     */
+    explicit CallSite(const CallSiteInfo& info) noexcept;
+
+    CallSite(const CallSite&) = delete;
+    CallSite(CallSite&&) = delete;
+
+    /**
+     * Unregisters the call site, so that the list never points into a library
+     * that was unloaded
+     */
+    ~CallSite() noexcept;
+
+    /**
+     * Checks whether the statement is switched on. A single relaxed load of
+     * one byte
+     *
+     * @return
+     *      `true` if the statement should log
+     */
+    inline bool IsEnabled() const noexcept { return m_Enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Gets the compile time information about the statement
+     *
+     * @return
+     *      The information about the statement
+     */
+    constexpr const CallSiteInfo& GetInfo() const noexcept { return m_Info; }
+
+private:
+    /// The compile time information about the statement
+    const CallSiteInfo& m_Info;
+    /// Whether the statement is switched on
+    std::atomic<bool> m_Enabled{true};
+    /// The next call site in the global list
+    CallSite* m_Next{};
+
+    friend class CallSiteRegistry;
+};
+
+/**
+ * Struct selecting call sites to switch on or off
+ */
+struct CallSiteFilter final
+{
+public:
+    std::string_view file{"*"};             // A glob (`*`, `?`) matched against the source file
+    std::string_view function{"*"};         // A glob matched against the function
+    LogLevel maxLevel{LogLevel::LOG_FATAL}; // Sites with a higher level are not matched
+};
+
+/**
+ * Switches on the call sites matching the filter, including those registered
+ * later, e.g. by a library loaded at runtime
+ *
+ * @param[in] filter
+ *      The call sites to switch on
+ *
+ * @return
+ *      The number of registered call sites matched
+ */
+size_t EnableCallSites(const CallSiteFilter& filter) noexcept;
+
+/**
+ * Switches off the call sites matching the filter, including those registered
+ * later. A switched off statement costs a single branch
+ *
+ * @param[in] filter
+ *      The call sites to switch off
+ *
+ * @return
+ *      The number of registered call sites matched
+ */
+size_t DisableCallSites(const CallSiteFilter& filter) noexcept;
+
+/**
+ * Calls a function for every registered call site, e.g. to list them
+ *
+ * @param[in] callback
+ *      The function to call with each call site. It must not switch call
+ *      sites on or off
+ */
+void ForEachCallSite(const std::function<void(const CallSite&)>& callback) noexcept;
+
+/**
+ * Struct owning the call site of a log statement. A static data member of a
+ * class template is initialized before `main()` runs, which is what registers
+ * the statements ahead of their first use
+ */
+template<const CallSiteInfo* INFO>
+struct CallSiteHolder final
+{
+public:
+    static inline CallSite site{*INFO};
+};
+
+}
+
+// --- call sites -------------------------------------------------------------
+
+#define RKLOG_FIRST_ARG_(first, ...) first
+
+// Checks the call site of the statement before anything else. The level has to
+// be a constant
+#define RKLOG_LOG_SITE_(logger, level, ...)                                                 \
+    do                                                                                      \
+    {                                                                                       \
+        static constexpr ::rklog::CallSiteInfo rklogSiteInfo_{                              \
+            __FILE__, __LINE__, RKLOG_CURR_FUNC, (level), RKLOG_FIRST_ARG_(__VA_ARGS__)};   \
+        if (::rklog::CallSiteHolder<&rklogSiteInfo_>::site.IsEnabled())                     \
+            RKLOG_LOG(logger, level, __VA_ARGS__);                                          \
+    } while (false)
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Logger.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace rklog {
+
+/**
+ * Class logging the statistics of a logger periodically from a background
+ * thread, so that the cost of logging can be watched and alerted on like any
+ * other metric. Each report is an info record whose structured fields hold the
+ * totals so far, e.g.
+ *
+ * `logger stats logger=app records=1024 records_error=3 suppressed=0 dropped=0 bytes=91422 write_calls=12 write_ns=48213 ...`
+ *
+ * The report can be written to the logger it describes or to another one
+ */
+class StatsReporter final
+{
+public:
+    /// The default time between reports
+    static constexpr std::chrono::milliseconds DEFAULT_INTERVAL = std::chrono::minutes(1);
+
+public:
+    /**
+     * Starts reporting the statistics of a logger
+     *
+     * @param[in] source
+     *      The logger whose statistics are reported, which must outlive the
+     *      reporter
+     * @param[in] target
+     *      The logger the reports are written to, which must outlive the
+     *      reporter
+     * @param[in] name
+     *      The name the source is reported under
+     * @param[in] interval
+     *      The time between reports
+     */
+    StatsReporter(const Logger& source, Logger& target, std::string_view name, std::chrono::milliseconds interval = DEFAULT_INTERVAL) noexcept;
+
+    StatsReporter(const StatsReporter&) = delete;
+    StatsReporter(StatsReporter&&) = delete;
+
+    /**
+     * Stops reporting
+     */
+    ~StatsReporter() noexcept;
+
+    /**
+     * Writes a report right away
+     */
+    void Report() noexcept;
+
+private:
+    /**
+     * The loop of the reporting thread
+     */
+    void Run() noexcept;
+
+private:
+    /// The logger whose statistics are reported
+    const Logger& m_Source;
+    /// The logger the reports are written to
+    Logger& m_Target;
+    /// The name the source is reported under
+    std::string m_Name;
+    /// The time between reports
+    std::chrono::milliseconds m_Interval;
+    /// Protects the stop flag of the reporting thread
+    std::mutex m_Mutex{};
+    /// Wakes the reporting thread when the reporter is destroyed
+    std::condition_variable m_Signal{};
+    /// A flag indicating whether the reporting thread should stop
+    bool m_Stop{};
+    /// The reporting thread
+    std::thread m_Thread{};
+};
+
+}
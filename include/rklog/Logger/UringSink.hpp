@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Sink.hpp"
+
+#include "../Config/Flush.hpp"
+#include "../Config/Uring.hpp"
+
+#include "../Core/Uring.hpp"
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace rklog {
+
+/**
+ * Class acting as a sink writing to a file through io_uring, see
+ * `rklog::UringWriter`. Log lines are collected in one of several buffers,
+ * each handed to the kernel when it fills up or the flush policy says so,
+ * without waiting for the write or for the sync that may follow it. Where
+ * io_uring is unavailable at runtime, the sink falls back to `writev()`
+ *
+ * The file is not rotated
+ */
+class UringFileSink final : public Sink
+{
+public:
+    /**
+     * Creates a sink writing to a file through io_uring
+     *
+     * @param[in] filePath
+     *      The path to the file to write to
+     * @param[in] policy
+     *      How large each buffer is and when it is handed to the kernel
+     * @param[in] uring
+     *      The number of buffers and how durable the writes are
+     */
+    UringFileSink(const std::filesystem::path& filePath, FlushPolicy policy = defaults::DEFAULT_FLUSH_POLICY, UringPolicy uring = defaults::DEFAULT_URING_POLICY) noexcept;
+
+    /**
+     * Stops the flush timer and waits for every buffer to be written
+     */
+    ~UringFileSink() noexcept;
+
+    /**
+     * Checks whether the buffers are written through io_uring
+     *
+     * @return
+     *      `true` if io_uring is used, `false` if `writev()` is
+     */
+    inline bool UsesUring() const noexcept { return m_Writer.UsesUring(); }
+
+    /**
+     * Gets a snapshot of the statistics of the sink, including the bytes
+     * written, system calls made, time spent in them and buffers handed over
+     *
+     * @return
+     *      The statistics counted since the sink was created
+     */
+    virtual LogStats GetStats() const noexcept override;
+
+protected:
+    virtual void WriteInternal(const LogLine& line) noexcept override;
+
+    /**
+     * Hands the current buffer to the kernel and waits until every buffer has
+     * been written
+     */
+    virtual void FlushInternal() noexcept override;
+
+private:
+    /**
+     * The loop of the flush timer
+     */
+    void RunFlushTimer() noexcept;
+
+private:
+    /// The writer of the file that this sink is writing to
+    UringWriter m_Writer;
+    /// When buffers are handed to the kernel
+    FlushPolicy m_Policy;
+    /// Protects the stop flag of the flush timer
+    std::mutex m_TimerMutex{};
+    /// Wakes the flush timer when the sink is destroyed
+    std::condition_variable m_TimerSignal{};
+    /// A flag indicating whether the flush timer should stop
+    bool m_StopTimer{};
+    /// The thread handing the buffer over periodically, started with the
+    /// first line written if the policy asks for one
+    std::thread m_Timer{};
+};
+
+}
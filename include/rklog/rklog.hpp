@@ -1,14 +1,19 @@
 #pragma once
 
+#include "Core/Crash.hpp"
+
 #include "Logger/BasicLogger.hpp"
 #include "Logger/ColorLogger.hpp"
+#include "Logger/Macros.hpp"
+#include "Logger/Registry.hpp"
 
 #include <exception> // Provides std::terminate()
 
 namespace rklog {
 
 /**
- * Gets the global instance of a basic logger
+ * Gets the global instance of a basic logger with the given title. Each title
+ * gets its own logger
  *
  * @param[in] title
  *      The title to give the basic logger
@@ -19,7 +24,8 @@ namespace rklog {
 BasicLogger& GetBasicLogger(std::string_view title = "global") noexcept;
 
 /**
- * Gets the global instance of a color logger
+ * Gets the global instance of a color logger with the given title. Each title
+ * gets its own logger
  *
  * @param[in] title
  *      The title to give the global logger
@@ -32,7 +38,8 @@ ColorLogger& GetColorLogger(std::string_view title = "global") noexcept;
 /**
  * Asserts that the given expression results to `true`. In the event that the
  * expression results to `false` a message is logged as "fatal" to the given
- * logger and the program is terminated via std::terminate()
+ * logger, the logger is flushed and the program is terminated via
+ * std::terminate()
  *
  * @param[in] logger
  *      The logger to log to if the assertion fails
@@ -44,12 +51,13 @@ ColorLogger& GetColorLogger(std::string_view title = "global") noexcept;
  *      The arguments for the format specifier
  */
 template<typename ... Args>
-void Assert(Logger& logger, bool expr, std::format_string<Args...> fmt, Args&& ... args) noexcept
+void Assert(Logger& logger, bool expr, FormatString<Args...> fmt, Args&& ... args) noexcept
 {
     if (expr)
         return;
 
     logger.Fatal(fmt, std::forward<Args>(args)...);
+    logger.Flush();
     std::terminate();
 }
 
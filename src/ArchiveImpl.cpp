@@ -0,0 +1,159 @@
+#include "rklog/Core/Archive.hpp"
+#include "rklog/Core/Gzip.hpp"
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace rklog {
+
+/// The extension of compressed rotated files
+static constexpr std::string_view COMPRESSED_EXTENSION = ".gz";
+/// The extension of rotated files while they are being compressed
+static constexpr std::string_view PARTIAL_EXTENSION = ".gz.tmp";
+
+FileArchiver::FileArchiver(const std::filesystem::path& filePath, RotationPolicy policy) noexcept :
+    m_Path(filePath), m_Policy(policy)
+{
+    if (!m_Policy.IsEnabled())
+        return;
+
+    std::error_code error{};
+    const std::filesystem::path directory = m_Path.has_parent_path() ? m_Path.parent_path() : ".";
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        uint64_t sequence{};
+        if (ParseSequence(it->path().filename(), sequence))
+            m_Sequence = std::max(m_Sequence, sequence);
+    }
+}
+
+FileArchiver::~FileArchiver() noexcept
+{
+    if (!m_Worker.joinable())
+        return;
+
+    {
+        const std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Signal.notify_one();
+    m_Worker.join();
+}
+
+std::filesystem::path FileArchiver::NextPath() noexcept
+{
+    std::filesystem::path rotatedPath = m_Path;
+    rotatedPath += "." + std::to_string(++m_Sequence);
+    return rotatedPath;
+}
+
+void FileArchiver::Submit(std::filesystem::path rotatedPath) noexcept
+{
+    if (!m_Policy.IsCompressing() && m_Policy.GetMaxFiles() == 0)
+        return;
+
+    {
+        const std::lock_guard lock(m_Mutex);
+        m_Pending.push_back(std::move(rotatedPath));
+        if (!m_Worker.joinable())
+            m_Worker = std::thread(&FileArchiver::Run, this);
+    }
+    m_Signal.notify_one();
+}
+
+void FileArchiver::Run() noexcept
+{
+    std::vector<std::filesystem::path> batch{};
+
+    std::unique_lock lock(m_Mutex);
+    for (;;)
+    {
+        m_Signal.wait(lock, [this] { return m_Stop || !m_Pending.empty(); });
+        if (m_Pending.empty())
+            return;
+
+        batch.swap(m_Pending);
+        lock.unlock();
+
+        for (const std::filesystem::path& rotatedPath : batch)
+        {
+            if (m_Policy.IsCompressing())
+                Compress(rotatedPath);
+        }
+        batch.clear();
+
+        if (m_Policy.GetMaxFiles() > 0)
+            Prune();
+
+        lock.lock();
+    }
+}
+
+void FileArchiver::Compress(const std::filesystem::path& rotatedPath) const noexcept
+{
+    std::filesystem::path partialPath = rotatedPath;
+    partialPath += PARTIAL_EXTENSION;
+    std::filesystem::path compressedPath = rotatedPath;
+    compressedPath += COMPRESSED_EXTENSION;
+
+    // The compressed file only appears under its final name once complete,
+    // and the rotated file is only deleted after that
+    std::error_code error{};
+    if (CompressFile(rotatedPath, partialPath))
+    {
+        std::filesystem::rename(partialPath, compressedPath, error);
+        if (!error)
+            std::filesystem::remove(rotatedPath, error);
+    }
+    else
+    {
+        std::filesystem::remove(partialPath, error);
+    }
+}
+
+void FileArchiver::Prune() const noexcept
+{
+    std::vector<std::pair<uint64_t, std::filesystem::path>> rotated{};
+
+    std::error_code error{};
+    const std::filesystem::path directory = m_Path.has_parent_path() ? m_Path.parent_path() : ".";
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        uint64_t sequence{};
+        if (ParseSequence(it->path().filename(), sequence))
+            rotated.emplace_back(sequence, it->path());
+    }
+
+    if (rotated.size() <= m_Policy.GetMaxFiles())
+        return;
+
+    std::sort(rotated.begin(), rotated.end());
+    const size_t excess = rotated.size() - m_Policy.GetMaxFiles();
+    for (size_t i = 0; i < excess; i++)
+        std::filesystem::remove(rotated[i].second, error);
+}
+
+bool FileArchiver::ParseSequence(const std::filesystem::path& fileName, uint64_t& sequence) const noexcept
+{
+    const std::string name = fileName.string();
+    const std::string base = m_Path.filename().string() + ".";
+    if (name.size() <= base.size() || !name.starts_with(base))
+        return false;
+
+    std::string_view suffix = std::string_view(name).substr(base.size());
+    if (suffix.ends_with(COMPRESSED_EXTENSION))
+        suffix.remove_suffix(COMPRESSED_EXTENSION.size());
+
+    if (suffix.empty() || !std::all_of(suffix.begin(), suffix.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        return false;
+
+    sequence = 0;
+    for (const char c : suffix)
+        sequence = sequence * 10 + static_cast<uint64_t>(c - '0');
+
+    return true;
+}
+
+}
@@ -0,0 +1,535 @@
+#include "rklog/Logger/AsyncLogger.hpp"
+
+#include "rklog/Core/Crash.hpp"
+#include "rklog/Core/Thread.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace rklog {
+
+struct AsyncLogger::ThreadQueueList
+{
+public:
+    /**
+     * Struct containing a queue the thread took from a logger
+     */
+    struct Entry
+    {
+    public:
+        std::shared_ptr<std::atomic<bool>> open{};  // Whether the logger still exists, also identifies it
+        ThreadQueue* queue{};                       // The queue, null if the thread uses the shared queue
+        Entry* next{};                              // The next entry
+    };
+
+public:
+    ~ThreadQueueList() noexcept
+    {
+        // Set first: whatever the thread logs from here on, e.g. from the
+        // destructors of other thread locals, must not go to a queue that
+        // another thread may take over
+        tornDown = true;
+        while (head)
+        {
+            Entry* const entry = head;
+            head = entry->next;
+            Drop(entry);
+        }
+    }
+
+    /**
+     * Gives up the queue of an entry and deletes the entry
+     */
+    static void Drop(Entry* entry) noexcept
+    {
+        if (entry->queue)
+        {
+            entry->queue->owned.store(false, std::memory_order_release);
+            entry->queue->Release();
+        }
+
+        delete entry;
+    }
+
+    /// Set once the list of the thread is destroyed, trivially destructible
+    /// so that it can still be read afterwards
+    static thread_local bool tornDown;
+
+    /// The queues the thread took, one per logger it logged to
+    Entry* head{};
+};
+
+thread_local constinit bool AsyncLogger::ThreadQueueList::tornDown{};
+
+AsyncLogger::AsyncLogger(std::unique_ptr<Logger> backend, size_t capacity) :
+    AsyncLogger(std::move(backend), InitBuildQueuePolicy().SetCapacity(capacity).Build()) {}
+
+AsyncLogger::AsyncLogger(std::unique_ptr<Logger> backend, QueuePolicy policy) :
+    Logger(backend->m_Style), m_Backend(std::move(backend)), m_Policy(policy),
+    m_Queue(policy.GetCapacity()), m_Priority(policy.GetPriorityCapacity())
+{
+    if (policy.GetMode() == QueueMode::PER_THREAD && policy.GetMaxThreads() > 0)
+    {
+        m_ThreadQueues = std::make_unique<std::atomic<ThreadQueue*>[]>(policy.GetMaxThreads());
+        m_Open = std::make_shared<std::atomic<bool>>(true);
+    }
+
+    m_DeferFormatting = true;
+    m_Worker = std::thread(&AsyncLogger::Run, this);
+    m_CrashSlot = RegisterCrashHook(CrashStage::QUEUE, &AsyncLogger::DrainOnCrash, this);
+}
+
+AsyncLogger::~AsyncLogger() noexcept
+{
+    UnregisterCrashHook(m_CrashSlot);
+
+    m_Running.store(false, std::memory_order_release);
+    m_Signal.fetch_add(1);
+    m_Signal.notify_one();
+
+    m_Worker.join();
+    m_Backend->Flush();
+
+    // Threads that still hold one of the queues keep it alive and drop it the
+    // next time they look for a queue
+    if (m_Open)
+    {
+        m_Open->store(false, std::memory_order_release);
+        for (size_t i = 0; i < m_ThreadQueueCount.load(std::memory_order_acquire); i++)
+            if (ThreadQueue* const queue = m_ThreadQueues[i].load(std::memory_order_acquire))
+                queue->Release();
+    }
+}
+
+void AsyncLogger::Flush() noexcept
+{
+    const uint64_t target = GetEnqueued();
+
+    m_Waiters.fetch_add(1);
+    m_Signal.fetch_add(1);
+    m_Signal.notify_one();
+
+    uint64_t written = m_Written.load(std::memory_order_acquire);
+    while (written < target)
+    {
+        m_Written.wait(written, std::memory_order_acquire);
+        written = m_Written.load(std::memory_order_acquire);
+    }
+
+    m_Waiters.fetch_sub(1);
+    m_Backend->Flush();
+}
+
+LogStats AsyncLogger::GetStats() const noexcept
+{
+    LogStats stats = Logger::GetStats();
+    stats.AddOutput(m_Backend->GetStats());
+    stats.queueHighWater = std::max(stats.queueHighWater, m_QueueHighWater.Get());
+    stats.queueLatency += m_QueueLatency.Get();
+    return stats;
+}
+
+void AsyncLogger::LogInternal(const LogRecord& record) noexcept
+{
+    QueuedRecord queued{std::string(record.message), DeferredMessage(), FieldStore(), record};
+    queued.fields.Assign(record.fields);
+    Push(std::move(queued));
+}
+
+void AsyncLogger::LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept
+{
+    Push(QueuedRecord{std::string(), msg, FieldStore(), record});
+}
+
+template<typename Lane>
+void AsyncLogger::PushWaiting(Lane& lane, QueuedRecord& queued, uint32_t spins) noexcept
+{
+    for (uint32_t attempt = 0;; attempt++)
+    {
+        if (lane.TryPush(std::move(queued)))
+            return;
+
+        Wake();
+        if (attempt < spins)
+        {
+            RKLOG_CPU_PAUSE();
+            continue;
+        }
+
+        // Registering before reading the count pairs with `Complete()`, so
+        // either the background thread sees us waiting or we see its progress
+        m_Waiters.fetch_add(1);
+        const uint64_t written = m_Written.load();
+        const bool pushed = lane.TryPush(std::move(queued));
+        if (!pushed)
+            m_Written.wait(written);
+
+        m_Waiters.fetch_sub(1);
+        if (pushed)
+            return;
+    }
+}
+
+void AsyncLogger::Push(QueuedRecord&& queued) noexcept
+{
+    const LogLevel level = queued.record.level;
+    if (m_Policy.IsPriority(level))
+    {
+        PushWaiting(m_Priority, queued, m_Policy.GetSpinCount());
+        Wake();
+        return;
+    }
+
+    if (ThreadQueue* const own = m_Open ? GetThreadQueue() : nullptr)
+    {
+        // Only the background thread pops from a thread's queue, so the
+        // newest record is dropped rather than the oldest
+        switch (m_Policy.GetOverflow())
+        {
+            case OverflowPolicy::BLOCK:
+                PushWaiting(own->queue, queued, 0);
+                break;
+            case OverflowPolicy::SPIN_THEN_BLOCK:
+                PushWaiting(own->queue, queued, m_Policy.GetSpinCount());
+                break;
+            case OverflowPolicy::DROP_NEWEST:
+            case OverflowPolicy::DROP_OLDEST:
+                if (!own->queue.TryPush(std::move(queued)))
+                    m_Counters.CountDropped(level, 1);
+                break;
+        }
+
+        Wake();
+        return;
+    }
+
+    switch (m_Policy.GetOverflow())
+    {
+        case OverflowPolicy::BLOCK:
+            PushWaiting(m_Queue, queued, 0);
+            break;
+        case OverflowPolicy::SPIN_THEN_BLOCK:
+            PushWaiting(m_Queue, queued, m_Policy.GetSpinCount());
+            break;
+        case OverflowPolicy::DROP_NEWEST:
+            if (!m_Queue.TryPush(std::move(queued)))
+                m_Counters.CountDropped(level, 1);
+            break;
+        case OverflowPolicy::DROP_OLDEST:
+            while (!m_Queue.TryPush(std::move(queued)))
+            {
+                QueuedRecord oldest{};
+                if (m_Queue.TryPop(oldest))
+                {
+                    m_Counters.CountDropped(oldest.record.level, 1);
+                    Complete(true);
+                }
+                else
+                {
+                    RKLOG_CPU_PAUSE();
+                }
+            }
+            break;
+    }
+
+    Wake();
+}
+
+AsyncLogger::ThreadQueue* AsyncLogger::GetThreadQueue() noexcept
+{
+    // The list is gone while the thread exits, and the queues it held may
+    // already belong to other threads
+    if (ThreadQueueList::tornDown)
+        return nullptr;
+
+    thread_local ThreadQueueList list{};
+    for (const ThreadQueueList::Entry* entry = list.head; entry; entry = entry->next)
+        if (entry->open == m_Open)
+            return entry->queue;
+
+    // Queues of loggers that no longer exist are only dropped here, so that
+    // looking up the queue stays a short scan
+    for (ThreadQueueList::Entry** link = &list.head; *link;)
+    {
+        ThreadQueueList::Entry* const entry = *link;
+        if (entry->open->load(std::memory_order_acquire))
+        {
+            link = &entry->next;
+            continue;
+        }
+
+        *link = entry->next;
+        ThreadQueueList::Drop(entry);
+    }
+
+    // Without memory for the entry the thread uses the shared queue, and
+    // looks again the next time it logs
+    auto* const entry = new (std::nothrow) ThreadQueueList::Entry{m_Open, nullptr, list.head};
+    if (!entry)
+        return nullptr;
+
+    entry->queue = AcquireThreadQueue();
+    list.head = entry;
+    return entry->queue;
+}
+
+AsyncLogger::ThreadQueue* AsyncLogger::AcquireThreadQueue() noexcept
+{
+    // The queue of a thread that exited is handed on, along with the records
+    // it may still hold
+    size_t count = m_ThreadQueueCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+    {
+        ThreadQueue* const queue = m_ThreadQueues[i].load(std::memory_order_acquire);
+        bool owned{};
+        if (queue && queue->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            queue->references.fetch_add(1, std::memory_order_relaxed);
+            return queue;
+        }
+    }
+
+    if (count >= m_Policy.GetMaxThreads())
+        return nullptr;
+
+    // Created by the thread that fills it, so that its memory is close to
+    // that thread on NUMA systems
+    ThreadQueue* const queue = new (std::nothrow) ThreadQueue(m_Policy.GetThreadCapacity());
+    if (!queue || queue->queue.Capacity() == 0)
+    {
+        delete queue;
+        return nullptr;
+    }
+
+    while (count < m_Policy.GetMaxThreads())
+    {
+        if (!m_ThreadQueueCount.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel))
+            continue;
+
+        m_ThreadQueues[count].store(queue, std::memory_order_release);
+        return queue;
+    }
+
+    delete queue;
+    return nullptr;
+}
+
+void AsyncLogger::Write(QueuedRecord& queued, std::string& scratch) noexcept
+{
+    if (queued.deferred.Empty())
+    {
+        queued.record.message = queued.message;
+    }
+    else
+    {
+        scratch.clear();
+        queued.deferred.FormatTo(scratch);
+        queued.record.message = scratch;
+    }
+
+    queued.record.fields = queued.fields.Get();
+    m_Backend->LogInternal(queued.record);
+
+    const TimeStamp& logged = queued.record.time;
+    const int64_t latency = TimeStamp::Now(logged.GetSource()).SinceEpoch() - logged.SinceEpoch();
+    m_QueueLatency.Record(latency > 0 ? static_cast<uint64_t>(latency) : 0);
+}
+
+void AsyncLogger::Complete(bool wake) noexcept
+{
+    m_Written.fetch_add(1);
+    if (wake && m_Waiters.load() > 0)
+        m_Written.notify_all();
+}
+
+void AsyncLogger::Wake() noexcept
+{
+    // Pairs with the fence in `Run()` so that either the consumer sees the
+    // pushed record or we see that it went to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_Sleeping.load(std::memory_order_relaxed))
+        return;
+
+    m_Signal.fetch_add(1);
+    m_Signal.notify_one();
+}
+
+bool AsyncLogger::PopLane(size_t lane, QueuedRecord& queued) noexcept
+{
+    if (lane == 0)
+        return m_Priority.TryPop(queued);
+
+    if (lane == 1)
+        return m_Queue.TryPop(queued);
+
+    ThreadQueue* const own = m_ThreadQueues[lane - 2].load(std::memory_order_acquire);
+    return own && own->queue.TryPop(queued);
+}
+
+size_t AsyncLogger::GetLaneCount() const noexcept
+{
+    return 2 + std::min(m_ThreadQueueCount.load(std::memory_order_acquire), m_Policy.GetMaxThreads());
+}
+
+uint64_t AsyncLogger::GetEnqueued() const noexcept
+{
+    uint64_t enqueued = m_Queue.EnqueuePosition() + m_Priority.EnqueuePosition();
+    for (size_t lane = 2, lanes = GetLaneCount(); lane < lanes; lane++)
+        if (const ThreadQueue* const own = m_ThreadQueues[lane - 2].load(std::memory_order_acquire))
+            enqueued += own->queue.EnqueuePosition();
+
+    return enqueued;
+}
+
+size_t AsyncLogger::GetPending() const noexcept
+{
+    size_t pending = m_Queue.Size() + m_Priority.Size();
+    for (size_t lane = 2, lanes = GetLaneCount(); lane < lanes; lane++)
+        if (const ThreadQueue* const own = m_ThreadQueues[lane - 2].load(std::memory_order_acquire))
+            pending += own->queue.Size();
+
+    return pending;
+}
+
+bool AsyncLogger::IsDrained() const noexcept
+{
+    if (!m_Queue.Empty() || !m_Priority.Empty())
+        return false;
+
+    for (size_t lane = 2, lanes = GetLaneCount(); lane < lanes; lane++)
+    {
+        const ThreadQueue* const own = m_ThreadQueues[lane - 2].load(std::memory_order_acquire);
+        if (own && !own->queue.Empty())
+            return false;
+    }
+
+    return true;
+}
+
+bool AsyncLogger::DrainOnCrash(void* context) noexcept
+{
+    AsyncLogger& logger = *static_cast<AsyncLogger*>(context);
+    if (std::this_thread::get_id() == logger.m_Worker.get_id())
+        return true;
+
+    const uint64_t target = logger.GetEnqueued();
+    if (logger.m_Written.load(std::memory_order_acquire) >= target)
+        return true;
+
+    logger.Wake();
+    return false;
+}
+
+void AsyncLogger::Run() noexcept
+{
+    if (const std::optional<uint32_t> cpu = m_Policy.GetConsumerCpu())
+        PinThreadToCpu(*cpu);
+    else if (const std::optional<uint32_t> node = m_Policy.GetConsumerNode())
+        PinThreadToNode(*node);
+
+    // The next record of each lane is held here, and the lanes holding one
+    // are kept in a heap with the oldest record on top
+    struct Head
+    {
+    public:
+        QueuedRecord queued{};  // The next record of the lane
+        int64_t time{};         // The time the record was logged
+        bool held{};            // Whether a record is held
+    };
+
+    std::vector<Head> heads(2 + (m_ThreadQueues ? m_Policy.GetMaxThreads() : 0));
+    std::vector<size_t> heap{};
+    heap.reserve(heads.size());
+
+    // Ties go to the lower lane, the priority lane first
+    const auto later = [&heads](size_t left, size_t right) {
+        return heads[left].time != heads[right].time ? heads[left].time > heads[right].time : left > right;
+    };
+
+    ClockSource source = ClockSource::SYSTEM;
+    const auto hold = [&](size_t lane) {
+        Head& head = heads[lane];
+        if (!PopLane(lane, head.queued))
+            return;
+
+        head.time = head.queued.record.time.SinceEpoch();
+        head.held = true;
+        source = head.queued.record.time.GetSource();
+        heap.push_back(lane);
+        std::push_heap(heap.begin(), heap.end(), later);
+    };
+
+    // Records logged up to `released` can no longer be overtaken by a record
+    // that has yet to show up in an empty lane
+    const int64_t window = std::chrono::duration_cast<std::chrono::nanoseconds>(m_Policy.GetMergeWindow()).count();
+    int64_t released = INT64_MIN;
+    std::string formatted{};
+    uint64_t written{};
+    for (;;)
+    {
+        // The empty lanes are only polled once the records held are not known
+        // to be the oldest. The clock is read first, so that whatever was
+        // logged a window before it has been pushed by the time its lane is
+        // polled and anything up to then may be written
+        const size_t lanes = GetLaneCount();
+        if (heap.size() < lanes && (heap.empty() || heads[heap.front()].time > released))
+        {
+            released = m_Running.load(std::memory_order_acquire) ? TimeStamp::Now(source).SinceEpoch() - window : INT64_MAX;
+            for (size_t lane = 0; lane < lanes; lane++)
+                if (!heads[lane].held)
+                    hold(lane);
+        }
+
+        if (!heap.empty())
+        {
+            const size_t oldest = heap.front();
+            if (heap.size() < lanes && heads[oldest].time > released)
+            {
+                // Waiting out the window for the lanes with nothing queued
+                if (m_Waiters.load() > 0)
+                    m_Written.notify_all();
+
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Reading the enqueue positions takes their cache lines away from
+            // the producers, so the depth is only sampled now and then
+            if (written % QUEUE_DEPTH_INTERVAL == 0)
+                m_QueueHighWater.Max(GetPending() + 1);
+
+            std::pop_heap(heap.begin(), heap.end(), later);
+            heap.pop_back();
+            Write(heads[oldest].queued, formatted);
+            heads[oldest].held = false;
+
+            written++;
+            Complete(written % WAKE_INTERVAL == 0);
+
+            // Only the lane just written from has a new head to look at
+            hold(oldest);
+            continue;
+        }
+
+        // Threads waiting for records written since the last batch
+        if (m_Waiters.load() > 0)
+            m_Written.notify_all();
+
+        if (!m_Running.load(std::memory_order_acquire) && IsDrained())
+            break;
+
+        m_Sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const uint32_t signal = m_Signal.load();
+        if (IsDrained() && m_Running.load(std::memory_order_acquire))
+            m_Signal.wait(signal);
+
+        m_Sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#include "rklog/Logger/Backtrace.hpp"
+#include "rklog/Logger/Logger.hpp"
+
+#include "rklog/Core/Platform.hpp"
+
+#include <bit>
+#include <new>
+
+namespace rklog {
+
+BacktraceRing::BacktraceRing(size_t capacity) noexcept
+{
+    if (capacity == 0)
+        return;
+
+    const size_t rounded = std::bit_ceil(capacity);
+    m_Slots.reset(new (std::nothrow) Slot[rounded]);
+    m_Capacity = m_Slots ? rounded : 0;
+}
+
+bool BacktraceRing::Take(uint64_t ticket, Entry& entry) noexcept
+{
+    Slot& slot = m_Slots[ticket & (m_Capacity - 1)];
+
+    // Writers never wait on a slot, so whoever holds it is done shortly
+    while (slot.busy.test_and_set(std::memory_order_acquire))
+        RKLOG_CPU_PAUSE();
+
+    // The slot may have been overwritten by a newer record, or was never
+    // written because its writer found it busy
+    const bool found = slot.entry.ticket == ticket;
+    if (found)
+    {
+        entry = slot.entry;
+        slot.entry.ticket = UINT64_MAX;
+    }
+
+    slot.busy.clear(std::memory_order_release);
+    return found;
+}
+
+void Logger::EnableBacktrace(size_t capacity) noexcept
+{
+    m_Backtrace.reset(new (std::nothrow) BacktraceRing(capacity));
+}
+
+void Logger::DisableBacktrace() noexcept
+{
+    m_Backtrace.reset();
+}
+
+size_t Logger::DumpBacktrace() noexcept
+{
+    if (!m_Backtrace)
+        return 0;
+
+    bool started{};
+    const size_t dumped = m_Backtrace->Drain([this, &started](const LogRecord& record) {
+        if (!started)
+        {
+            LogInternal(MakeRecord("backtrace begins", LogLevel::LOG_INFO, std::source_location::current()));
+            started = true;
+        }
+
+        m_Counters.CountRecord(record.level);
+        LogInternal(record);
+    });
+
+    if (started)
+    {
+        FormatBuffer notice{};
+        std::format_to(std::back_inserter(*notice), "backtrace ends, {} records", dumped);
+        LogInternal(MakeRecord(*notice, LogLevel::LOG_INFO, std::source_location::current()));
+    }
+
+    return dumped;
+}
+
+}
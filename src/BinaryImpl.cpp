@@ -0,0 +1,202 @@
+#include "rklog/Logger/BinaryLogger.hpp"
+
+#include "rklog/Core/Binary.hpp"
+#include "rklog/Core/Buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+
+namespace rklog {
+
+/// The types of the arguments of a message formatted by the caller
+static constexpr std::array<ArgType, 1> PREFORMATTED_SIGNATURE = { ArgType::STRING };
+
+/**
+ * Reads a value of the given type from the encoded arguments
+ */
+template<typename T>
+static T Load(const std::byte*& src) noexcept
+{
+    T value{};
+    std::memcpy(&value, src, sizeof(T));
+    src += sizeof(T);
+    return value;
+}
+
+/**
+ * Re-encodes the raw arguments of a deferred message in the binary format
+ */
+static void WriteArgs(std::string& out, std::span<const ArgType> signature, std::span<const std::byte> args) noexcept
+{
+    const std::byte* src = args.data();
+    for (const ArgType type : signature)
+    {
+        switch (type)
+        {
+            case ArgType::BOOL:
+            case ArgType::CHAR:
+            case ArgType::UINT8:
+                out.push_back(Load<char>(src));
+                break;
+            case ArgType::INT8:
+                binary::WriteSignedVarint(out, Load<int8_t>(src));
+                break;
+            case ArgType::INT16:
+                binary::WriteSignedVarint(out, Load<int16_t>(src));
+                break;
+            case ArgType::INT32:
+                binary::WriteSignedVarint(out, Load<int32_t>(src));
+                break;
+            case ArgType::INT64:
+                binary::WriteSignedVarint(out, Load<int64_t>(src));
+                break;
+            case ArgType::UINT16:
+                binary::WriteVarint(out, Load<uint16_t>(src));
+                break;
+            case ArgType::UINT32:
+                binary::WriteVarint(out, Load<uint32_t>(src));
+                break;
+            case ArgType::UINT64:
+                binary::WriteVarint(out, Load<uint64_t>(src));
+                break;
+            case ArgType::FLOAT:
+                out.append(reinterpret_cast<const char*>(src), sizeof(float));
+                src += sizeof(float);
+                break;
+            case ArgType::DOUBLE:
+                out.append(reinterpret_cast<const char*>(src), sizeof(double));
+                src += sizeof(double);
+                break;
+            case ArgType::STRING:
+            {
+                const auto length = Load<uint32_t>(src);
+                binary::WriteString(out, std::string_view(reinterpret_cast<const char*>(src), length));
+                src += length;
+                break;
+            }
+            case ArgType::POINTER:
+                binary::WriteVarint(out, Load<uintptr_t>(src));
+                break;
+            case ArgType::CUSTOM:
+                RKLOG_UNREACHABLE();
+        }
+    }
+}
+
+size_t BinaryLogger::FormatKeyHash::operator()(const FormatKey& key) const noexcept
+{
+    size_t hash = std::hash<const void*>()(key.format);
+    for (const void* part : { static_cast<const void*>(key.signature), static_cast<const void*>(key.file), static_cast<const void*>(key.function) })
+        hash = hash * 31 + std::hash<const void*>()(part);
+
+    return hash * 31 + key.line;
+}
+
+void BinaryLogger::Flush() noexcept
+{
+    const WriteGuard guard(m_Lock);
+    m_Writer.Flush();
+}
+
+LogStats BinaryLogger::GetStats() const noexcept
+{
+    LogStats stats = Logger::GetStats();
+    stats.AddOutput(m_Writer.GetStats());
+    return stats;
+}
+
+void BinaryLogger::LogInternal(const LogRecord& record) noexcept
+{
+    FormatBuffer entry{};
+
+    const WriteGuard guard(m_Lock);
+    WriteRecordHeader(*entry, {}, PREFORMATTED_SIGNATURE, record);
+    if (record.fields.empty())
+        binary::WriteString(*entry, record.message);
+    else
+    {
+        // The format has no room for fields, so they are kept as text
+        FormatBuffer message{};
+        message->append(record.message);
+        for (const Field& field : record.fields)
+        {
+            if (!message->empty())
+                message->push_back(' ');
+
+            AppendFieldText(*message, field);
+        }
+
+        binary::WriteString(*entry, *message);
+    }
+
+    m_Writer.Write(*entry);
+}
+
+void BinaryLogger::LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept
+{
+    const std::span<const ArgType> signature = msg.GetSignature();
+    if (std::find(signature.begin(), signature.end(), ArgType::CUSTOM) != signature.end())
+    {
+        // The decoder would not know how to read these back
+        Logger::LogDeferred(msg, record);
+        return;
+    }
+
+    FormatBuffer entry{};
+
+    const WriteGuard guard(m_Lock);
+    WriteRecordHeader(*entry, msg.GetFormat(), signature, record);
+    WriteArgs(*entry, signature, msg.GetArgs());
+    m_Writer.Write(*entry);
+}
+
+void BinaryLogger::Start() noexcept
+{
+    m_DeferFormatting = true;
+    m_LastTime = TimeStamp::Now().SinceEpoch();
+
+    std::string header{binary::MAGIC};
+    header.push_back(static_cast<char>(binary::VERSION));
+    header.push_back(static_cast<char>(m_Title.has_value()));
+    binary::WriteString(header, m_Title.value_or(""));
+    binary::WriteString(header, m_Style.GetPattern().GetSource());
+
+    const TimeFormat timeFormat = m_Style.GetTimeFormat();
+    header.push_back(static_cast<char>(timeFormat.precision));
+    header.push_back(static_cast<char>(timeFormat.utc));
+    header.push_back(static_cast<char>(timeFormat.iso8601));
+
+    for (const LogLevel level : { LogLevel::LOG_DEBUG, LogLevel::LOG_INFO, LogLevel::LOG_WARNING, LogLevel::LOG_ERROR, LogLevel::LOG_FATAL })
+        binary::WriteString(header, m_Style.GetConfig(level).GetTag());
+
+    binary::WriteSignedVarint(header, m_LastTime);
+    m_Writer.Write(header);
+}
+
+void BinaryLogger::WriteRecordHeader(std::string& out, std::string_view format, std::span<const ArgType> signature, const LogRecord& record) noexcept
+{
+    const FormatKey key{format.data(), signature.data(), record.location.file, record.location.function, record.location.line};
+    const auto [it, inserted] = m_Formats.try_emplace(key, static_cast<uint32_t>(m_Formats.size()));
+    if (inserted)
+    {
+        out.push_back(static_cast<char>(binary::FORMAT_TAG));
+        binary::WriteString(out, format.data() ? format : "{}");
+        binary::WriteString(out, record.location.file);
+        binary::WriteVarint(out, record.location.line);
+        binary::WriteString(out, record.location.function);
+        binary::WriteVarint(out, signature.size());
+        for (const ArgType type : signature)
+            out.push_back(static_cast<char>(type));
+    }
+
+    const int64_t time = record.time.SinceEpoch();
+    out.push_back(static_cast<char>(binary::RECORD_TAG + static_cast<uint8_t>(record.level)));
+    binary::WriteVarint(out, it->second);
+    binary::WriteSignedVarint(out, time - m_LastTime);
+    binary::WriteVarint(out, record.threadId);
+    m_LastTime = time;
+}
+
+}
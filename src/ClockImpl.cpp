@@ -0,0 +1,172 @@
+#include "rklog/Core/Clock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+namespace rklog {
+
+namespace {
+
+/**
+ * Class owning the calibration of the cycle counter against the system clock.
+ * The mapping is published through a sequence lock so that readers never
+ * block the calibration thread, nor each other
+ */
+class TscCalibrator final
+{
+public:
+    TscCalibrator()
+    {
+        // The initial frequency comes from a short measurement, later
+        // calibrations measure against this first sample so the frequency
+        // keeps getting more precise
+        Sample(m_AnchorTicks, m_AnchorNanos);
+        std::this_thread::sleep_for(INITIAL_WINDOW);
+
+        uint64_t ticks{};
+        int64_t nanos{};
+        Sample(ticks, nanos);
+        Publish(ticks, nanos, static_cast<double>(nanos - m_AnchorNanos) / static_cast<double>(ticks - m_AnchorTicks), 0);
+
+        std::thread(&TscCalibrator::Run, this).detach();
+    }
+
+    int64_t ToNanoseconds(uint64_t ticks) const noexcept
+    {
+        for (;;)
+        {
+            const uint32_t seq = m_Sequence.load(std::memory_order_acquire);
+            const uint64_t baseTicks = m_BaseTicks.load(std::memory_order_relaxed);
+            const int64_t baseNanos = m_BaseNanos.load(std::memory_order_relaxed);
+            const double nanosPerTick = m_NanosPerTick.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if ((seq & 1) == 0 && seq == m_Sequence.load(std::memory_order_relaxed))
+            {
+                const auto delta = static_cast<double>(static_cast<int64_t>(ticks - baseTicks));
+                return baseNanos + static_cast<int64_t>(delta * nanosPerTick);
+            }
+        }
+    }
+
+    TscCalibration GetCalibration() const noexcept
+    {
+        return TscCalibration{1e9 / m_NanosPerTick.load(std::memory_order_relaxed), m_ErrorNanos.load(std::memory_order_relaxed)};
+    }
+
+private:
+    /// The length of the measurement taken on first use
+    static constexpr std::chrono::milliseconds INITIAL_WINDOW{10};
+    /// The interval between calibrations
+    static constexpr std::chrono::seconds INTERVAL{1};
+    /// The error after which the system clock is assumed to have been set
+    static constexpr int64_t MAX_DRIFT_NANOS = 100'000'000;
+
+private:
+    /**
+     * Reads the cycle counter and the system clock at the same instant, as
+     * close as it can be measured
+     */
+    static void Sample(uint64_t& ticks, int64_t& nanos) noexcept
+    {
+        uint64_t bestWindow = std::numeric_limits<uint64_t>::max();
+        for (int i = 0; i < 8; i++)
+        {
+            const uint64_t before = TscClock::Ticks();
+            const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            const uint64_t after = TscClock::Ticks();
+
+            if (after - before < bestWindow)
+            {
+                bestWindow = after - before;
+                ticks = before + bestWindow / 2;
+                nanos = now;
+            }
+        }
+    }
+
+    void Publish(uint64_t ticks, int64_t nanos, double nanosPerTick, int64_t error) noexcept
+    {
+        const uint32_t seq = m_Sequence.load(std::memory_order_relaxed);
+        m_Sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_BaseTicks.store(ticks, std::memory_order_relaxed);
+        m_BaseNanos.store(nanos, std::memory_order_relaxed);
+        m_NanosPerTick.store(nanosPerTick, std::memory_order_relaxed);
+        m_ErrorNanos.store(error, std::memory_order_relaxed);
+
+        m_Sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    void Run() noexcept
+    {
+        for (;;)
+        {
+            std::this_thread::sleep_for(INTERVAL);
+
+            uint64_t ticks{};
+            int64_t nanos{};
+            Sample(ticks, nanos);
+
+            const int64_t error = ToNanoseconds(ticks) - nanos;
+            if (error > MAX_DRIFT_NANOS || error < -MAX_DRIFT_NANOS)
+            {
+                m_AnchorTicks = ticks;
+                m_AnchorNanos = nanos;
+                Publish(ticks, nanos, m_NanosPerTick.load(std::memory_order_relaxed), error);
+                continue;
+            }
+
+            const double nanosPerTick = static_cast<double>(nanos - m_AnchorNanos) / static_cast<double>(ticks - m_AnchorTicks);
+            Publish(ticks, nanos, nanosPerTick, error);
+        }
+    }
+
+private:
+    /// The sequence lock guarding the published mapping, odd while writing
+    std::atomic<uint32_t> m_Sequence{};
+    /// The cycle counter value of the published mapping
+    std::atomic<uint64_t> m_BaseTicks{};
+    /// The nanoseconds since the epoch of the published mapping
+    std::atomic<int64_t> m_BaseNanos{};
+    /// The nanoseconds per tick of the published mapping
+    std::atomic<double> m_NanosPerTick{};
+    /// The error measured at the last calibration
+    std::atomic<int64_t> m_ErrorNanos{};
+
+    /// The cycle counter value the frequency is measured from
+    uint64_t m_AnchorTicks{};
+    /// The nanoseconds since the epoch the frequency is measured from
+    int64_t m_AnchorNanos{};
+};
+
+}
+
+static TscCalibrator& GetCalibrator() noexcept
+{
+    // Intentionally leaked, so that timestamps can still be converted while
+    // other static objects, such as loggers, are being destroyed
+    static TscCalibrator* const calibrator = new TscCalibrator();
+    return *calibrator;
+}
+
+int64_t TscClock::ToNanoseconds(uint64_t ticks) noexcept
+{
+    return GetCalibrator().ToNanoseconds(ticks);
+}
+
+void TscClock::Calibrate() noexcept
+{
+    GetCalibrator();
+}
+
+TscCalibration TscClock::GetCalibration() noexcept
+{
+    return GetCalibrator().GetCalibration();
+}
+
+}
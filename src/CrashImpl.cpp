@@ -0,0 +1,350 @@
+#include "rklog/Core/Crash.hpp"
+#include "rklog/Core/Platform.hpp"
+
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+#include <Windows.h>
+#include <io.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace rklog {
+
+/// Size of the alternate signal stack the crash handler runs on
+static constexpr size_t CRASH_STACK_SIZE = 64 * 1024;
+
+/**
+ * Sleeps for a millisecond, async-signal-safe
+ */
+static void SleepBriefly() noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    ::Sleep(1);
+#else
+    const ::timespec duration{0, 1'000'000};
+    ::nanosleep(&duration, nullptr);
+#endif
+}
+
+/**
+ * Writes a notice to `stderr`, async-signal-safe
+ */
+static void WriteNotice(std::string_view notice) noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    ::_write(2, notice.data(), static_cast<unsigned int>(notice.size()));
+#else
+    [[maybe_unused]] const ssize_t written = ::write(2, notice.data(), notice.size());
+#endif
+}
+
+/**
+ * Gets the time on the monotonic clock, async-signal-safe
+ */
+static int64_t MonotonicNanos() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Class containing the registered crash hooks and the handlers that run them.
+ * Everything the handlers touch is a lock-free atomic in a fixed table
+ */
+class CrashRegistry final
+{
+public:
+    /// The number of crash hooks that can be registered at once
+    static constexpr size_t MAX_HOOKS = 256;
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    /// The number of handled signals, Windows has no `SIGBUS`
+    static constexpr size_t SIGNAL_COUNT = 4;
+#else
+    /// The number of handled signals
+    static constexpr size_t SIGNAL_COUNT = 5;
+#endif
+
+public:
+    /**
+     * Gets the global registry. Constant-initialized, so it is usable from
+     * static initializers and signal handlers alike
+     */
+    static CrashRegistry& Get() noexcept
+    {
+        static CrashRegistry registry{};
+        return registry;
+    }
+
+    /**
+     * Claims a free slot for a hook and publishes it
+     */
+    size_t Register(CrashStage stage, CrashHook hook, void* context) noexcept
+    {
+        for (size_t i = 0; i < MAX_HOOKS; i++)
+        {
+            Slot& slot = m_Slots[i];
+            bool used = false;
+            if (!slot.used.compare_exchange_strong(used, true, std::memory_order_acquire))
+                continue;
+
+            slot.stage.store(stage, std::memory_order_relaxed);
+            slot.hook.store(hook, std::memory_order_relaxed);
+            slot.context.store(context, std::memory_order_release);
+            return i;
+        }
+
+        return SIZE_MAX;
+    }
+
+    /**
+     * Hides a hook from the handlers and frees its slot
+     */
+    void Unregister(size_t slot) noexcept
+    {
+        if (slot >= MAX_HOOKS)
+            return;
+
+        m_Slots[slot].context.store(nullptr, std::memory_order_release);
+        m_Slots[slot].used.store(false, std::memory_order_release);
+    }
+
+    /**
+     * Polls the queue hooks until they are done or the timeout passes, then
+     * runs the buffer hooks
+     */
+    void Drain() noexcept
+    {
+        const int64_t deadline = MonotonicNanos() + m_DrainTimeout.load(std::memory_order_relaxed);
+        while (!RunHooks(CrashStage::QUEUE) && MonotonicNanos() < deadline)
+            SleepBriefly();
+
+        RunHooks(CrashStage::BUFFER);
+    }
+
+    /**
+     * Installs the signal and terminate handlers, once
+     */
+    void Install(std::chrono::milliseconds drainTimeout) noexcept
+    {
+        m_DrainTimeout.store(std::chrono::nanoseconds(drainTimeout).count(), std::memory_order_relaxed);
+        std::call_once(m_Installed, [this] {
+#if defined(RKLOG_PLATFORM_WINDOWS)
+            for (FatalSignal& fatal : m_Signals)
+                fatal.previous = std::signal(fatal.number, OnFatalSignal);
+#else
+            // Overflowing the stack is a common cause of SIGSEGV, so the
+            // handler runs on a stack of its own on the installing thread
+            InstallCrashStack();
+
+            struct sigaction action{};
+            action.sa_sigaction = OnFatalSignal;
+            action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            for (FatalSignal& fatal : m_Signals)
+                ::sigaction(fatal.number, &action, &fatal.previous);
+#endif
+
+            m_PreviousTerminate = std::set_terminate(OnTerminate);
+        });
+    }
+
+private:
+    /**
+     * Struct containing a registered crash hook. The context is published
+     * last and cleared first, so a non-null context means the rest is valid
+     */
+    struct Slot
+    {
+    public:
+        std::atomic<bool> used{};        // Whether the slot is claimed
+        std::atomic<CrashStage> stage{}; // When the hook runs
+        std::atomic<CrashHook> hook{};   // The hook
+        std::atomic<void*> context{};    // The pointer passed to the hook
+    };
+
+    /**
+     * Struct containing a handled signal and the handler it replaced
+     */
+    struct FatalSignal
+    {
+    public:
+        int number{};                    // The signal number
+        std::string_view notice{};       // The line written to `stderr` when it arrives
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        void (*previous)(int){};         // The previous handler
+#else
+        struct sigaction previous{};     // The previous handler
+#endif
+    };
+
+private:
+    /**
+     * Runs the hooks of a stage once, returning whether they are all done
+     */
+    bool RunHooks(CrashStage stage) noexcept
+    {
+        bool done = true;
+        for (const Slot& slot : m_Slots)
+        {
+            void* const context = slot.context.load(std::memory_order_acquire);
+            if (!context || slot.stage.load(std::memory_order_relaxed) != stage)
+                continue;
+
+            if (!slot.hook.load(std::memory_order_relaxed)(context))
+                done = false;
+        }
+
+        return done;
+    }
+
+    /**
+     * Drains once, then hands the signal to the handler that was replaced
+     */
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    static void OnFatalSignal(int number) noexcept
+#else
+    static void OnFatalSignal(int number, ::siginfo_t*, void*) noexcept
+#endif
+    {
+        CrashRegistry& registry = Get();
+        FatalSignal* fatal = &registry.m_Signals[0];
+        for (FatalSignal& candidate : registry.m_Signals)
+        {
+            if (candidate.number == number)
+                fatal = &candidate;
+        }
+
+        // A crash while draining goes straight to the previous handler
+        if (!registry.m_Crashing.exchange(true))
+        {
+            WriteNotice(fatal->notice);
+            registry.Drain();
+        }
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        std::signal(number, fatal->previous ? fatal->previous : SIG_DFL);
+#else
+        ::sigaction(number, &fatal->previous, nullptr);
+#endif
+        std::raise(number);
+    }
+
+    /**
+     * Drains before `std::terminate()` carries on, e.g. after a failed
+     * `rklog::Assert()` or an uncaught exception
+     */
+    [[noreturn]] static void OnTerminate() noexcept
+    {
+        CrashRegistry& registry = Get();
+        if (!registry.m_Crashing.exchange(true))
+            registry.Drain();
+
+        // The SIGABRT that usually follows should drain whatever was logged
+        // after this point as well
+        registry.m_Crashing.store(false);
+        if (registry.m_PreviousTerminate)
+            registry.m_PreviousTerminate();
+
+        std::abort();
+    }
+
+private:
+    /// The hooks
+    std::array<Slot, MAX_HOOKS> m_Slots{};
+    /// How long to wait for queued records, in nanoseconds
+    std::atomic<int64_t> m_DrainTimeout{std::chrono::nanoseconds(DEFAULT_CRASH_DRAIN_TIMEOUT).count()};
+    /// A flag indicating whether a handler is draining
+    std::atomic<bool> m_Crashing{};
+    /// Makes sure the handlers are only installed once
+    std::once_flag m_Installed{};
+    /// The terminate handler that was replaced
+    std::terminate_handler m_PreviousTerminate{};
+    /// The handled signals
+    FatalSignal m_Signals[SIGNAL_COUNT]{
+        {SIGSEGV, "rklog: fatal signal SIGSEGV, draining pending records\n"},
+        {SIGFPE, "rklog: fatal signal SIGFPE, draining pending records\n"},
+        {SIGILL, "rklog: fatal signal SIGILL, draining pending records\n"},
+        {SIGABRT, "rklog: fatal signal SIGABRT, draining pending records\n"},
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+        {SIGBUS, "rklog: fatal signal SIGBUS, draining pending records\n"},
+#endif
+    };
+};
+
+size_t RegisterCrashHook(CrashStage stage, CrashHook hook, void* context) noexcept
+{
+    return CrashRegistry::Get().Register(stage, hook, context);
+}
+
+void UnregisterCrashHook(size_t slot) noexcept
+{
+    CrashRegistry::Get().Unregister(slot);
+}
+
+void DrainOnCrash() noexcept
+{
+    CrashRegistry::Get().Drain();
+}
+
+void InstallCrashHandler(std::chrono::milliseconds drainTimeout) noexcept
+{
+    CrashRegistry::Get().Install(drainTimeout);
+}
+
+bool InstallCrashStack() noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    return false;
+#else
+    // Owns the alternate signal stack of the thread, switched off before it
+    // is freed when the thread exits
+    struct CrashStack
+    {
+    public:
+        ~CrashStack() noexcept
+        {
+            if (!memory)
+                return;
+
+            ::stack_t disable{};
+            disable.ss_flags = SS_DISABLE;
+            ::sigaltstack(&disable, nullptr);
+            delete[] memory;
+        }
+
+        char* memory{}; // The memory of the stack
+    };
+
+    ::stack_t current{};
+    if (::sigaltstack(nullptr, &current) == 0 && !(current.ss_flags & SS_DISABLE))
+        return true;
+
+    thread_local CrashStack crashStack{};
+    crashStack.memory = new (std::nothrow) char[CRASH_STACK_SIZE];
+    if (!crashStack.memory)
+        return false;
+
+    ::stack_t stack{};
+    stack.ss_sp = crashStack.memory;
+    stack.ss_size = CRASH_STACK_SIZE;
+    if (::sigaltstack(&stack, nullptr) != 0)
+    {
+        delete[] crashStack.memory;
+        crashStack.memory = nullptr;
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+}
@@ -0,0 +1,186 @@
+#include "rklog/Core/Field.hpp"
+#include "rklog/Core/Buffer.hpp"
+#include "rklog/Core/Json.hpp"
+#include "rklog/Core/Platform.hpp"
+
+#include <charconv>
+#include <cmath>
+
+namespace rklog {
+
+static void AppendNumber(std::string& out, const Field& field) noexcept
+{
+    char buffer[32]{};
+    std::to_chars_result result{};
+    switch (field.GetKind())
+    {
+        case FieldKind::INT:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), field.GetInt());
+            break;
+        case FieldKind::UINT:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), field.GetUInt());
+            break;
+        case FieldKind::FLOAT:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), field.GetFloat());
+            break;
+        default:
+            RKLOG_UNREACHABLE();
+    }
+
+    out.append(buffer, result.ptr);
+}
+
+/**
+ * Checks whether a text value has to be quoted to be read back as one value
+ */
+static bool NeedsQuotes(std::string_view value) noexcept
+{
+    if (value.empty())
+        return true;
+
+    for (const char c : value)
+    {
+        if (c == ' ' || c == '=' || c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20)
+            return true;
+    }
+
+    return false;
+}
+
+static void AppendTextValue(std::string& out, std::string_view value) noexcept
+{
+    if (NeedsQuotes(value))
+        AppendJsonString(out, value);
+    else
+        out.append(value);
+}
+
+void FieldStore::Assign(std::span<const Field> fields) noexcept
+{
+    m_Fields.clear();
+    m_Text.clear();
+    if (fields.empty())
+        return;
+
+    // The text is laid out first and the views into it are taken once it has
+    // stopped growing. Until then each field holds the length of its value
+    FormatBuffer custom{};
+    for (const Field& field : fields)
+    {
+        const std::string_view key = field.GetKey();
+        m_Text.insert(m_Text.end(), key.begin(), key.end());
+
+        std::string_view value{};
+        if (field.GetKind() == FieldKind::STRING)
+            value = field.GetString();
+        else if (field.GetKind() == FieldKind::CUSTOM)
+        {
+            custom->clear();
+            field.FormatCustom(*custom);
+            value = *custom;
+        }
+
+        m_Text.insert(m_Text.end(), value.begin(), value.end());
+        m_Fields.push_back(field.GetKind() == FieldKind::STRING || field.GetKind() == FieldKind::CUSTOM ?
+            Field({}, static_cast<uint64_t>(value.size())) : field);
+    }
+
+    const char* text = m_Text.data();
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        const std::string_view key(text, fields[i].GetKey().size());
+        text += key.size();
+
+        Field& field = m_Fields[i];
+        switch (field.GetKind())
+        {
+            case FieldKind::BOOL:
+                field = Field(key, field.GetBool());
+                break;
+            case FieldKind::INT:
+                field = Field(key, field.GetInt());
+                break;
+            case FieldKind::UINT:
+                if (fields[i].GetKind() == FieldKind::UINT)
+                    field = Field(key, field.GetUInt());
+                else
+                {
+                    // Custom values are kept as the strings they were formatted to
+                    const std::string_view value(text, field.GetUInt());
+                    text += value.size();
+                    field = Field(key, value);
+                }
+                break;
+            case FieldKind::FLOAT:
+                field = Field(key, field.GetFloat());
+                break;
+            case FieldKind::STRING:
+            case FieldKind::CUSTOM:
+                RKLOG_UNREACHABLE();
+        }
+    }
+}
+
+void AppendFieldText(std::string& out, const Field& field) noexcept
+{
+    out.append(field.GetKey());
+    out.push_back('=');
+    switch (field.GetKind())
+    {
+        case FieldKind::BOOL:
+            out.append(field.GetBool() ? "true" : "false");
+            break;
+        case FieldKind::INT:
+        case FieldKind::UINT:
+        case FieldKind::FLOAT:
+            AppendNumber(out, field);
+            break;
+        case FieldKind::STRING:
+            AppendTextValue(out, field.GetString());
+            break;
+        case FieldKind::CUSTOM:
+        {
+            FormatBuffer value{};
+            field.FormatCustom(*value);
+            AppendTextValue(out, *value);
+            break;
+        }
+    }
+}
+
+void AppendFieldJson(std::string& out, const Field& field, std::string_view keyPrefix) noexcept
+{
+    out.push_back('"');
+    EscapeJson(out, keyPrefix);
+    EscapeJson(out, field.GetKey());
+    out.append("\":");
+    switch (field.GetKind())
+    {
+        case FieldKind::BOOL:
+            out.append(field.GetBool() ? "true" : "false");
+            break;
+        case FieldKind::INT:
+        case FieldKind::UINT:
+            AppendNumber(out, field);
+            break;
+        case FieldKind::FLOAT:
+            // JSON has no representation of infinities and NaN
+            if (std::isfinite(field.GetFloat()))
+                AppendNumber(out, field);
+            else
+                out.append("null");
+            break;
+        case FieldKind::STRING:
+            AppendJsonString(out, field.GetString());
+            break;
+        case FieldKind::CUSTOM:
+        {
+            FormatBuffer value{};
+            field.FormatCustom(*value);
+            AppendJsonString(out, *value);
+            break;
+        }
+    }
+}
+
+}
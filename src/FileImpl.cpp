@@ -0,0 +1,186 @@
+#include "rklog/Core/Crash.hpp"
+#include "rklog/Core/File.hpp"
+#include "rklog/Core/Platform.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace rklog {
+
+/**
+ * Struct containing what it took to write some data
+ */
+struct WriteResult final
+{
+public:
+    uint64_t bytes{};  // The number of bytes written
+    uint64_t calls{};  // The number of write system calls made
+    uint64_t nanos{};  // The time spent in them
+    uint64_t errors{}; // The number of them that failed
+};
+
+/**
+ * Writes all of the data to a file descriptor, retrying partial and
+ * interrupted writes
+ */
+static WriteResult WriteFully(int handle, std::string_view data, LatencyRecorder* latency) noexcept
+{
+    WriteResult result{};
+    while (!data.empty())
+    {
+        const auto start = std::chrono::steady_clock::now();
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        const int written = ::_write(handle, data.data(), static_cast<unsigned int>(data.size()));
+#else
+        const ssize_t written = ::write(handle, data.data(), data.size());
+#endif
+        const auto nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        result.calls++;
+        result.nanos += nanos;
+        if (latency)
+            latency->Record(nanos);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // Nowhere to report the error to, so the data is dropped
+            result.errors++;
+            break;
+        }
+
+        result.bytes += static_cast<uint64_t>(written);
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+
+    return result;
+}
+
+FileWriter::FileWriter(const std::filesystem::path& filePath, size_t bufferSize, bool append) noexcept
+{
+    if (bufferSize > 0)
+    {
+        m_Buffer.reset(new (std::nothrow) char[bufferSize]);
+        m_Capacity = m_Buffer ? bufferSize : 0;
+    }
+
+    Open(filePath, append);
+    m_CrashSlot = RegisterCrashHook(CrashStage::BUFFER, &FileWriter::DrainOnCrash, this);
+}
+
+FileWriter::~FileWriter() noexcept
+{
+    UnregisterCrashHook(m_CrashSlot);
+    Close();
+}
+
+bool FileWriter::Open(const std::filesystem::path& filePath, bool append) noexcept
+{
+    Close();
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    const int mode = append ? _O_APPEND : _O_TRUNC;
+    m_Handle = ::_wopen(filePath.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | mode, _S_IREAD | _S_IWRITE);
+#else
+    const int mode = append ? O_APPEND : O_TRUNC;
+    m_Handle = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | mode, 0644);
+#endif
+
+    return m_Handle >= 0;
+}
+
+void FileWriter::Close() noexcept
+{
+    Flush();
+
+    if (m_Handle >= 0)
+    {
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        ::_close(m_Handle);
+#else
+        ::close(m_Handle);
+#endif
+        m_Handle = -1;
+    }
+}
+
+void FileWriter::Write(std::string_view data) noexcept
+{
+    if (data.empty())
+        return;
+
+    if (m_Size + data.size() > m_Capacity)
+    {
+        Flush();
+        if (data.size() >= m_Capacity)
+        {
+            WriteAll(data);
+            return;
+        }
+    }
+
+    std::memcpy(m_Buffer.get() + m_Size, data.data(), data.size());
+    m_Size += data.size();
+}
+
+void FileWriter::Flush() noexcept
+{
+    if (m_Size == 0)
+        return;
+
+    WriteAll(std::string_view(m_Buffer.get(), m_Size));
+    m_Size = 0;
+    m_Flushes.Add(1);
+}
+
+FileStats FileWriter::GetStats() const noexcept
+{
+    return FileStats{
+        m_BytesWritten.Get(), m_WriteCalls.Get(), m_WriteNanos.Get(),
+        m_WriteErrors.Get(), m_Flushes.Get(), m_WriteLatency.Get()
+    };
+}
+
+void FileWriter::WriteAll(std::string_view data) noexcept
+{
+    if (m_Handle < 0)
+        return;
+
+    const WriteResult result = WriteFully(m_Handle, data, &m_WriteLatency);
+    m_BytesWritten.Add(result.bytes);
+    m_WriteCalls.Add(result.calls);
+    m_WriteNanos.Add(result.nanos);
+    m_WriteErrors.Add(result.errors);
+}
+
+bool FileWriter::DrainOnCrash(void* context) noexcept
+{
+    FileWriter& writer = *static_cast<FileWriter*>(context);
+    if (writer.m_Handle >= 0 && writer.m_Size > 0)
+        WriteFully(writer.m_Handle, std::string_view(writer.m_Buffer.get(), writer.m_Size), nullptr);
+
+    writer.m_Size = 0;
+    return true;
+}
+
+void WriteToStdErr(std::string_view data, LogCounters* counters) noexcept
+{
+    const WriteResult result = WriteFully(2, data, nullptr);
+    if (counters)
+        counters->CountWrite(result.bytes, result.calls, result.nanos, result.errors);
+}
+
+}
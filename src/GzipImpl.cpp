@@ -0,0 +1,397 @@
+#include "rklog/Core/Gzip.hpp"
+#include "rklog/Core/Platform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace rklog {
+
+/// The size of the window matches can refer back into
+static constexpr size_t WINDOW_SIZE = 32 * 1024;
+/// The number of bytes read from the source at a time
+static constexpr size_t CHUNK_SIZE = 256 * 1024;
+/// The number of bits of the hash of the next three bytes
+static constexpr size_t HASH_BITS = 15;
+/// The maximum number of earlier positions tried per match
+static constexpr size_t MAX_CHAIN = 32;
+/// The shortest match that deflate can encode
+static constexpr size_t MIN_MATCH = 3;
+/// The longest match that deflate can encode
+static constexpr size_t MAX_MATCH = 258;
+
+/// The base lengths of the length codes 257 to 285
+static constexpr std::array<uint16_t, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+/// The number of extra bits of the length codes 257 to 285
+static constexpr std::array<uint8_t, 29> LENGTH_EXTRA = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+/// The base distances of the distance codes 0 to 29
+static constexpr std::array<uint16_t, 30> DISTANCE_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+/// The number of extra bits of the distance codes 0 to 29
+static constexpr std::array<uint8_t, 30> DISTANCE_EXTRA = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+/**
+ * Builds the lookup table of the CRC-32 used by gzip
+ */
+static constexpr std::array<uint32_t, 256> MakeCrcTable() noexcept
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        table[i] = crc;
+    }
+
+    return table;
+}
+
+/// The lookup table of the CRC-32
+static constexpr std::array<uint32_t, 256> CRC_TABLE = MakeCrcTable();
+
+/**
+ * Continues a CRC-32 over more data
+ */
+static uint32_t UpdateCrc(uint32_t crc, const uint8_t* data, size_t size) noexcept
+{
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = CRC_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+namespace {
+
+/**
+ * Class writing the least significant bit first bit stream of deflate
+ */
+class BitWriter final
+{
+public:
+    explicit BitWriter(std::FILE* file) noexcept :
+        m_File(file) {}
+
+    /**
+     * Writes the lowest bits of a value, least significant bit first
+     */
+    void Write(uint32_t value, uint32_t count) noexcept
+    {
+        m_Bits |= static_cast<uint64_t>(value) << m_Count;
+        m_Count += count;
+        while (m_Count >= 8)
+        {
+            Put(static_cast<uint8_t>(m_Bits));
+            m_Bits >>= 8;
+            m_Count -= 8;
+        }
+    }
+
+    /**
+     * Writes a Huffman code, which is stored most significant bit first
+     */
+    void WriteCode(uint32_t code, uint32_t length) noexcept
+    {
+        uint32_t reversed{};
+        for (uint32_t i = 0; i < length; i++)
+            reversed |= ((code >> i) & 1) << (length - 1 - i);
+
+        Write(reversed, length);
+    }
+
+    /**
+     * Pads the stream to a whole byte and writes out everything pending
+     *
+     * @return
+     *      `true` if everything was written
+     */
+    bool Finish() noexcept
+    {
+        if (m_Count > 0)
+            Write(0, 8 - m_Count);
+
+        return Drain();
+    }
+
+    /**
+     * Writes raw bytes, only valid on a byte boundary
+     */
+    void WriteBytes(const uint8_t* data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; i++)
+            Put(data[i]);
+    }
+
+    /**
+     * Writes out the buffered bytes
+     *
+     * @return
+     *      `true` if everything was written
+     */
+    bool Drain() noexcept
+    {
+        const bool ok = std::fwrite(m_Buffer.data(), 1, m_Size, m_File) == m_Size;
+        m_Size = 0;
+        m_Failed |= !ok;
+        return !m_Failed;
+    }
+
+private:
+    void Put(uint8_t byte) noexcept
+    {
+        m_Buffer[m_Size++] = byte;
+        if (m_Size == m_Buffer.size())
+            Drain();
+    }
+
+private:
+    std::FILE* m_File;
+    std::array<uint8_t, 16 * 1024> m_Buffer{};
+    size_t m_Size{};
+    uint64_t m_Bits{};
+    uint32_t m_Count{};
+    bool m_Failed{};
+};
+
+/**
+ * Class encoding a stream as a single deflate block with the fixed codes
+ */
+class DeflateEncoder final
+{
+public:
+    explicit DeflateEncoder(BitWriter& out) noexcept :
+        m_Out(out)
+    {
+        m_Head.fill(-1);
+        m_Prev.fill(-1);
+
+        // BFINAL = 1, BTYPE = 01 (fixed Huffman codes)
+        m_Out.Write(1, 1);
+        m_Out.Write(1, 2);
+    }
+
+    /**
+     * Encodes the data in the window from the given position up to its end
+     *
+     * @param[in] window
+     *      The window, containing earlier data before `start`
+     * @param[in] start
+     *      The index of the first new byte in the window
+     * @param[in] end
+     *      The index past the last byte in the window
+     * @param[in] offset
+     *      The position in the stream of the first byte of the window
+     */
+    void Encode(const uint8_t* window, size_t start, size_t end, int64_t offset) noexcept
+    {
+        size_t idx = start;
+        while (idx < end)
+        {
+            const int64_t position = offset + static_cast<int64_t>(idx);
+
+            size_t bestLength{};
+            size_t bestDistance{};
+            if (idx + MIN_MATCH <= end)
+            {
+                const uint32_t hash = Hash(window + idx);
+                int64_t candidate = m_Head[hash];
+                const size_t limit = std::min(MAX_MATCH, end - idx);
+
+                for (size_t chain = 0; chain < MAX_CHAIN && candidate >= 0; chain++)
+                {
+                    const auto distance = static_cast<size_t>(position - candidate);
+                    if (distance > WINDOW_SIZE)
+                        break;
+
+                    const uint8_t* const match = window + (idx - distance);
+                    size_t length{};
+                    while (length < limit && match[length] == window[idx + length])
+                        length++;
+
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length == limit)
+                            break;
+                    }
+
+                    candidate = m_Prev[static_cast<size_t>(candidate) & (WINDOW_SIZE - 1)];
+                }
+            }
+
+            if (bestLength >= MIN_MATCH)
+            {
+                WriteMatch(bestLength, bestDistance);
+                for (size_t i = 0; i < bestLength; i++)
+                    Insert(window, idx + i, end, offset);
+                idx += bestLength;
+            }
+            else
+            {
+                WriteLiteral(window[idx]);
+                Insert(window, idx, end, offset);
+                idx++;
+            }
+        }
+    }
+
+    /**
+     * Ends the block
+     */
+    void Finish() noexcept
+    {
+        WriteLiteral(256);
+    }
+
+private:
+    static uint32_t Hash(const uint8_t* data) noexcept
+    {
+        const uint32_t value = static_cast<uint32_t>(data[0]) << 16 | static_cast<uint32_t>(data[1]) << 8 | data[2];
+        return (value * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void Insert(const uint8_t* window, size_t idx, size_t end, int64_t offset) noexcept
+    {
+        if (idx + MIN_MATCH > end)
+            return;
+
+        const int64_t position = offset + static_cast<int64_t>(idx);
+        const uint32_t hash = Hash(window + idx);
+        m_Prev[static_cast<size_t>(position) & (WINDOW_SIZE - 1)] = m_Head[hash];
+        m_Head[hash] = position;
+    }
+
+    void WriteLiteral(uint32_t symbol) noexcept
+    {
+        if (symbol < 144)
+            m_Out.WriteCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            m_Out.WriteCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            m_Out.WriteCode(symbol - 256, 7);
+        else
+            m_Out.WriteCode(0xC0 + symbol - 280, 8);
+    }
+
+    void WriteMatch(size_t length, size_t distance) noexcept
+    {
+        size_t lengthCode = LENGTH_BASE.size() - 1;
+        while (LENGTH_BASE[lengthCode] > length)
+            lengthCode--;
+
+        WriteLiteral(static_cast<uint32_t>(257 + lengthCode));
+        m_Out.Write(static_cast<uint32_t>(length - LENGTH_BASE[lengthCode]), LENGTH_EXTRA[lengthCode]);
+
+        size_t distanceCode = DISTANCE_BASE.size() - 1;
+        while (DISTANCE_BASE[distanceCode] > distance)
+            distanceCode--;
+
+        m_Out.WriteCode(static_cast<uint32_t>(distanceCode), 5);
+        m_Out.Write(static_cast<uint32_t>(distance - DISTANCE_BASE[distanceCode]), DISTANCE_EXTRA[distanceCode]);
+    }
+
+private:
+    BitWriter& m_Out;
+    std::array<int64_t, size_t(1) << HASH_BITS> m_Head{};
+    std::array<int64_t, WINDOW_SIZE> m_Prev{};
+};
+
+/**
+ * Closes a file when going out of scope
+ */
+struct FileCloser final
+{
+public:
+    void operator()(std::FILE* file) const noexcept { std::fclose(file); }
+};
+
+}
+
+/**
+ * Writes a 32-bit value in little endian
+ */
+static void WriteLittleEndian(BitWriter& out, uint32_t value) noexcept
+{
+    const std::array<uint8_t, 4> bytes = {
+        static_cast<uint8_t>(value),
+        static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16),
+        static_cast<uint8_t>(value >> 24),
+    };
+    out.WriteBytes(bytes.data(), bytes.size());
+}
+
+bool CompressFile(const std::filesystem::path& source, const std::filesystem::path& destination) noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    const std::unique_ptr<std::FILE, FileCloser> input(::_wfopen(source.c_str(), L"rb"));
+    const std::unique_ptr<std::FILE, FileCloser> output(::_wfopen(destination.c_str(), L"wb"));
+#else
+    const std::unique_ptr<std::FILE, FileCloser> input(std::fopen(source.c_str(), "rb"));
+    const std::unique_ptr<std::FILE, FileCloser> output(std::fopen(destination.c_str(), "wb"));
+#endif
+    if (!input || !output)
+        return false;
+
+    // The history of the last window is kept in front of each new chunk
+    const std::unique_ptr<uint8_t[]> window(new (std::nothrow) uint8_t[WINDOW_SIZE + CHUNK_SIZE]);
+    const std::unique_ptr<BitWriter> out(new (std::nothrow) BitWriter(output.get()));
+    if (!window || !out)
+        return false;
+
+    // Magic, deflate, no flags, no modification time, no extra flags, unknown OS
+    constexpr std::array<uint8_t, 10> HEADER = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+    out->WriteBytes(HEADER.data(), HEADER.size());
+
+    const std::unique_ptr<DeflateEncoder> deflate(new (std::nothrow) DeflateEncoder(*out));
+    if (!deflate)
+        return false;
+
+    uint32_t crc{};
+    uint64_t total{};
+    size_t history{};
+    for (;;)
+    {
+        const size_t read = std::fread(window.get() + history, 1, CHUNK_SIZE, input.get());
+        if (read == 0)
+            break;
+
+        crc = UpdateCrc(crc, window.get() + history, read);
+        deflate->Encode(window.get(), history, history + read, static_cast<int64_t>(total) - static_cast<int64_t>(history));
+        total += read;
+
+        const size_t end = history + read;
+        const size_t keep = std::min(end, WINDOW_SIZE);
+        std::memmove(window.get(), window.get() + end - keep, keep);
+        history = keep;
+    }
+
+    if (std::ferror(input.get()))
+        return false;
+
+    deflate->Finish();
+    out->Finish();
+    WriteLittleEndian(*out, crc);
+    WriteLittleEndian(*out, static_cast<uint32_t>(total));
+
+    return out->Drain() && std::fflush(output.get()) == 0;
+}
+
+}
@@ -0,0 +1,155 @@
+#include "rklog/Core/Json.hpp"
+
+#include "rklog/Core/Platform.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RKLOG_JSON_SSE2
+#include <immintrin.h>
+#if defined(RKLOG_COMPILER_GCC) || defined(RKLOG_COMPILER_LLVM)
+#define RKLOG_JSON_AVX2
+#endif
+#endif
+
+namespace rklog {
+
+/// Finds the first byte of a text that needs escaping, or its size if none does
+using FindEscapeFn = size_t (*)(const char* text, size_t size) noexcept;
+
+static constexpr bool NeedsEscape(char c) noexcept
+{
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+static size_t FindEscapeScalar(const char* text, size_t size) noexcept
+{
+    size_t i{};
+    while (i < size && !NeedsEscape(text[i]))
+        i++;
+
+    return i;
+}
+
+#if defined(RKLOG_JSON_SSE2)
+static size_t FindEscapeSse2(const char* text, size_t size) noexcept
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    size_t i{};
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        // A byte is a control character if it is its own minimum with 0x1F
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0)
+            return i + std::countr_zero(mask);
+    }
+
+    return i + FindEscapeScalar(text + i, size - i);
+}
+#endif
+
+#if defined(RKLOG_JSON_AVX2)
+__attribute__((target("avx2")))
+static size_t FindEscapeAvx2(const char* text, size_t size) noexcept
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+
+    size_t i{};
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk));
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0)
+            return i + std::countr_zero(mask);
+    }
+
+    return i + FindEscapeSse2(text + i, size - i);
+}
+#endif
+
+/**
+ * Picks the widest search the CPU supports
+ */
+static FindEscapeFn SelectFindEscape() noexcept
+{
+#if defined(RKLOG_JSON_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        return FindEscapeAvx2;
+#endif
+
+#if defined(RKLOG_JSON_SSE2)
+    return FindEscapeSse2;
+#else
+    return FindEscapeScalar;
+#endif
+}
+
+static void AppendEscaped(std::string& out, char c) noexcept
+{
+    switch (c)
+    {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\b':
+            out.append("\\b");
+            break;
+        case '\f':
+            out.append("\\f");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+        {
+            constexpr std::string_view HEX = "0123456789abcdef";
+            const auto byte = static_cast<unsigned char>(c);
+            const char escaped[] = {'\\', 'u', '0', '0', HEX[byte >> 4], HEX[byte & 0xF]};
+            out.append(escaped, sizeof(escaped));
+            break;
+        }
+    }
+}
+
+void EscapeJson(std::string& out, std::string_view text) noexcept
+{
+    static const FindEscapeFn findEscape = SelectFindEscape();
+
+    size_t start{};
+    while (start < text.size())
+    {
+        const size_t end = start + findEscape(text.data() + start, text.size() - start);
+        out.append(text.data() + start, end - start);
+        if (end == text.size())
+            break;
+
+        AppendEscaped(out, text[end]);
+        start = end + 1;
+    }
+}
+
+}
@@ -1,11 +1,16 @@
 #include "rklog/Logger/BasicLogger.hpp"
 #include "rklog/Logger/ColorLogger.hpp"
 #include "rklog/Logger/FileLogger.hpp"
+#include "rklog/Logger/MappedFileLogger.hpp"
+#include "rklog/Logger/Sink.hpp"
 
+#include "rklog/Core/File.hpp"
 #include "rklog/Core/Platform.hpp"
-#include "rklog/Core/Time.hpp"
 
-#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #if defined(RKLOG_PLATFORM_WINDOWS)
 #include <Windows.h>
@@ -29,90 +34,142 @@ static void EnableVirtualConsole() noexcept
 
 namespace rklog {
 
-static std::string BuildLogMessage(const std::optional<std::string>& loggerTitle, const LogConfig& cfg, std::string_view msg) noexcept
+/**
+ * Writes a log line to the standard error stream in a single write system
+ * call, so that lines logged by different threads do not interleave. This is
+ * what lets `LockPolicy::ATOMIC_WRITE` skip the lock
+ */
+static void WriteLine(std::string& line, LogCounters& counters) noexcept
 {
-    const auto tag = cfg.GetTag();
-    const auto ts = TimeStamp::Now();
-
-    return loggerTitle ? std::format("[{}]:[{}]:[{}]: {}", *loggerTitle, tag, ts, msg) :
-        std::format("[{}]:[{}]: {}", tag, ts, msg);
+    line.push_back('\n');
+    WriteToStdErr(line, &counters);
 }
 
-static std::optional<std::string> BuildColorCode(std::optional<Color> fg, std::optional<Color> bg) noexcept
+void Logger::LogDeferred(const DeferredMessage& msg, const LogRecord& record) noexcept
 {
-    if (fg && bg)
-    {
-        return std::format("\033[38;2;{};{};{};48;2;{};{};{}m", fg->r, fg->g, fg->b, bg->r, bg->g, bg->b);
-    }
-    else if (fg)
-    {
-        return std::format("\033[38;2;{};{};{}m", fg->r, fg->g, fg->b);
-    }
-    else if (bg)
-    {
-        return std::format("\033[48;2;{};{};{}m", bg->r, bg->g, bg->b);
-    }
+    FormatBuffer formatted{};
+    msg.FormatTo(*formatted);
 
-    return {};
+    LogRecord formattedRecord = record;
+    formattedRecord.message = *formatted;
+    LogInternal(formattedRecord);
 }
 
-static std::string ColorizeString(std::string_view str, std::optional<Color> fg, std::optional<Color> bg)
+void BasicLogger::LogInternal(const LogRecord& record) noexcept
 {
-    constexpr std::string_view ANSI_RESET = "\033[0m";
-
-    if (const auto colorCode = BuildColorCode(fg, bg))
-        return std::format("{}{}{}", *colorCode, str, ANSI_RESET);
+    FormatBuffer logMessage{};
+    m_Style.FormatTo(*logMessage, record, m_Title, false);
 
-    return str.data();
+    const WriteGuard guard(m_Lock, true);
+    WriteLine(*logMessage, m_Counters);
 }
 
-void BasicLogger::LogInternal(std::string_view msg, LogLevel level) noexcept
+void ColorLogger::LogInternal(const LogRecord& record) noexcept
 {
-    const auto cfg = m_Style.GetConfig(level);
-    const auto logMessage = BuildLogMessage(m_Title, cfg, msg);
+    FormatBuffer logMessage{};
+    m_Style.FormatTo(*logMessage, record, m_Title, true);
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    EnableVirtualConsole();
+#endif
 
-    std::println(std::cerr, "{}", logMessage);
+    const WriteGuard guard(m_Lock, true);
+    WriteLine(*logMessage, m_Counters);
 }
 
-void ColorLogger::LogInternal(std::string_view msg, LogLevel level) noexcept
+void StdErrSink::WriteInternal(const LogLine& line) noexcept
 {
-    const auto cfg = m_Style.GetConfig(level);
-    const auto logMessage = BuildLogMessage(m_Title, cfg, msg);
-    const auto coloredLogMessage = ColorizeString(logMessage, cfg.GetForegroundColor(), cfg.GetBackgroundColor());
+    FormatBuffer scratch{};
+    const std::string_view text = line.Render(m_Color, *scratch);
 
 #if defined(RKLOG_PLATFORM_WINDOWS)
-    EnableVirtualConsole();
+    if (m_Color)
+        EnableVirtualConsole();
 #endif
 
-    std::println(std::cerr, "{}", coloredLogMessage);
+    WriteToStdErr(text, &m_Counters);
 }
 
-void FileLogger::LogInternal(std::string_view msg, LogLevel level) noexcept
+void FileLogger::LogInternal(const LogRecord& record) noexcept
 {
-    const auto cfg = m_Style.GetConfig(level);
-    const auto logMessage = BuildLogMessage(m_Title, cfg, msg);
-    std::println(m_FileHandle, "{}", logMessage);
-    
+    FormatBuffer logMessage{};
+    ColorMarks marks{};
+    m_Style.FormatTo(*logMessage, record, m_Title, marks);
+    logMessage->push_back('\n');
+
+    const LogLine line(record, m_Title ? std::string_view(*m_Title) : std::string_view(), *logMessage, marks, m_Style.GetConfig(record.level).GetColorCode());
+    m_File.Write(line);
     if (m_WriteToStdErr)
-    {
-#if defined(RKLOG_PLATFORM_WINDOWS)
-        EnableVirtualConsole();
+        m_StdErr.Write(line);
+}
+
+LogStats FileLogger::GetStats() const noexcept
+{
+    LogStats stats = Logger::GetStats();
+    stats.AddOutput(m_File.GetStats());
+    stats.AddOutput(m_StdErr.GetStats());
+    return stats;
+}
+
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+
+void MappedFileLogger::Sync() noexcept
+{
+    const WriteGuard guard(m_Lock);
+    m_File.Sync();
+}
+
+void MappedFileLogger::LogInternal(const LogRecord& record) noexcept
+{
+    FormatBuffer logMessage{};
+    m_Style.FormatTo(*logMessage, record, m_Title, false);
+    logMessage->push_back('\n');
+
+    m_Counters.CountWrite(logMessage->size(), 0, 0, 0);
+
+    const WriteGuard guard(m_Lock);
+    m_File.Write(*logMessage);
+}
+
 #endif
-        const auto coloredLogMessage = ColorizeString(logMessage, cfg.GetForegroundColor(), cfg.GetBackgroundColor());
-        std::println(std::cerr, "{}", coloredLogMessage);
+
+/// The title of the default global loggers
+static constexpr std::string_view GLOBAL_TITLE = "global";
+
+/**
+ * Gets the global logger of the given type with the given title, creating it
+ * on first use
+ */
+template<typename T>
+static T& GetGlobalLogger(std::string_view title) noexcept
+{
+    // Most log calls go through the default logger, so it skips the lock and
+    // the lookup
+    if (title == GLOBAL_TITLE)
+    {
+        static T logger(GLOBAL_TITLE);
+        return logger;
     }
+
+    static std::mutex mutex{};
+    static std::map<std::string, std::unique_ptr<T>, std::less<>> loggers{};
+
+    const std::lock_guard lock(mutex);
+    auto it = loggers.find(title);
+    if (it == loggers.end())
+        it = loggers.emplace(std::string(title), std::make_unique<T>(title)).first;
+
+    return *it->second;
 }
 
 ColorLogger& GetColorLogger(std::string_view title = "global") noexcept
 {
-    static ColorLogger colorLogger{title};
-    return colorLogger;
+    return GetGlobalLogger<ColorLogger>(title);
 }
 
 BasicLogger& GetBasicLogger(std::string_view title = "global") noexcept
 {
-    static BasicLogger basicLogger{title};
-    return basicLogger;
+    return GetGlobalLogger<BasicLogger>(title);
 }
 
-}
\ No newline at end of file
+}
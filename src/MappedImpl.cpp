@@ -0,0 +1,106 @@
+#include "rklog/Core/Mapped.hpp"
+#include "rklog/Core/Platform.hpp"
+
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace rklog {
+
+MappedFile::MappedFile(const std::filesystem::path& filePath, size_t segmentSize) noexcept
+{
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    m_SegmentSize = segmentSize == 0 ? pageSize : (segmentSize + pageSize - 1) / pageSize * pageSize;
+
+    m_Handle = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_Handle >= 0)
+        MapSegment(0);
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    if (m_Mapping)
+        ::munmap(m_Mapping, m_SegmentSize);
+
+    if (m_Handle >= 0)
+    {
+        // Cuts off the preallocated space that was never written to
+        [[maybe_unused]] const int result = ::ftruncate(m_Handle, static_cast<off_t>(Size()));
+        ::close(m_Handle);
+    }
+}
+
+void MappedFile::Write(std::string_view data) noexcept
+{
+    while (!data.empty() && m_Mapping)
+    {
+        if (m_Used == m_SegmentSize && !MapSegment(m_SegmentOffset + m_SegmentSize))
+            return;
+
+        const size_t count = std::min(data.size(), m_SegmentSize - m_Used);
+        std::memcpy(m_Mapping + m_Used, data.data(), count);
+        m_Used += count;
+        data.remove_prefix(count);
+    }
+}
+
+void MappedFile::Sync() noexcept
+{
+    if (m_Mapping)
+        ::msync(m_Mapping, m_Used, MS_SYNC);
+
+    // Previous segments are no longer mapped, their dirty pages are flushed
+    // through the file descriptor
+    if (m_Handle >= 0 && m_SegmentOffset > 0)
+    {
+#if defined(RKLOG_PLATFORM_LINUX)
+        ::fdatasync(m_Handle);
+#else
+        ::fsync(m_Handle);
+#endif
+    }
+}
+
+bool MappedFile::MapSegment(uint64_t offset) noexcept
+{
+    if (m_Mapping)
+    {
+        ::munmap(m_Mapping, m_SegmentSize);
+        m_Mapping = nullptr;
+    }
+
+    const auto end = static_cast<off_t>(offset + m_SegmentSize);
+#if defined(RKLOG_PLATFORM_LINUX)
+    // Reserves the blocks up front, so that writing to the mapping cannot
+    // fail on a full disk. Only falls back to a sparse file where that is not
+    // supported; on a full disk or quota the first write to a sparse mapping
+    // would raise SIGBUS, so the file stops being written instead
+    if (::fallocate(m_Handle, 0, static_cast<off_t>(offset), static_cast<off_t>(m_SegmentSize)) != 0)
+    {
+        if ((errno != EOPNOTSUPP && errno != ENOSYS) || ::ftruncate(m_Handle, end) != 0)
+            return false;
+    }
+#else
+    if (::ftruncate(m_Handle, end) != 0)
+        return false;
+#endif
+
+    void* const mapping = ::mmap(nullptr, m_SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_Handle, static_cast<off_t>(offset));
+    if (mapping == MAP_FAILED)
+        return false;
+
+    m_Mapping = static_cast<char*>(mapping);
+    m_SegmentOffset = offset;
+    m_Used = 0;
+    return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include "rklog/Config/Pattern.hpp"
+#include "rklog/Config/Style.hpp"
+
+#include <charconv>
+#include <iterator>
+
+namespace rklog {
+
+static void AppendNumber(std::string& out, uint64_t value) noexcept
+{
+    char buffer[20]{};
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+static bool IsFieldEmpty(PatternToken field, const LogRecord& record, const std::optional<std::string>& title, const LogConfig& cfg, bool color) noexcept
+{
+    switch (field)
+    {
+        case PatternToken::TITLE:
+            return !title || title->empty();
+        case PatternToken::TAG:
+            return cfg.GetTag().empty();
+        case PatternToken::FILE:
+            return *record.location.file == '\0';
+        case PatternToken::LINE:
+            return record.location.line == 0;
+        case PatternToken::FUNCTION:
+            return *record.location.function == '\0';
+        case PatternToken::MESSAGE:
+            return record.message.empty() && record.fields.empty();
+        case PatternToken::COLOR:
+        case PatternToken::RESET:
+            return !color || cfg.GetColorCode().empty();
+        default:
+            return false;
+    }
+}
+
+void LogStyle::FormatTo(std::string& out, const LogRecord& record, const std::optional<std::string>& title, bool color) const
+{
+    Render(out, record, title, color, nullptr);
+}
+
+void LogStyle::FormatTo(std::string& out, const LogRecord& record, const std::optional<std::string>& title, ColorMarks& marks) const
+{
+    Render(out, record, title, false, &marks);
+}
+
+void LogStyle::Render(std::string& out, const LogRecord& record, const std::optional<std::string>& title, bool color, ColorMarks* marks) const
+{
+    const LogConfig& cfg = GetConfig(record.level);
+    const bool hasColor = !cfg.GetColorCode().empty();
+    bool colored{};
+    // The indices of the `{endif}` segments closing rendered `{if:color}` blocks
+    uint64_t coloredBlockEnds{};
+
+    for (size_t i = 0; i < m_Pattern.Size(); i++)
+    {
+        const PatternSegment& segment = m_Pattern[i];
+        switch (segment.token)
+        {
+            case PatternToken::LITERAL:
+                out.append(m_Pattern.GetLiteral(segment));
+                break;
+            case PatternToken::TITLE:
+                if (title)
+                    out.append(*title);
+                break;
+            case PatternToken::TAG:
+                out.append(cfg.GetTag());
+                break;
+            case PatternToken::TIME:
+                record.time.FormatTo(std::back_inserter(out), segment.hasTimeFormat ? segment.timeFormat : m_TimeFormat);
+                break;
+            case PatternToken::THREAD:
+                AppendNumber(out, record.threadId);
+                break;
+            case PatternToken::FILE:
+                out.append(record.location.file);
+                break;
+            case PatternToken::LINE:
+                AppendNumber(out, record.location.line);
+                break;
+            case PatternToken::FUNCTION:
+                out.append(record.location.function);
+                break;
+            case PatternToken::MESSAGE:
+                out.append(record.message);
+                for (const Field& field : record.fields)
+                {
+                    if (!out.empty() && out.back() != ' ')
+                        out.push_back(' ');
+
+                    AppendFieldText(out, field);
+                }
+                break;
+            case PatternToken::COLOR:
+                if (marks && hasColor)
+                {
+                    marks->Add(out.size(), ColorMarkKind::COLOR);
+                    colored = true;
+                }
+                else if (color && hasColor)
+                {
+                    out.append(cfg.GetColorCode());
+                    colored = true;
+                }
+                break;
+            case PatternToken::RESET:
+                if (colored)
+                {
+                    if (marks)
+                        marks->Add(out.size(), ColorMarkKind::RESET);
+                    else
+                        out.append(ANSI_RESET);
+
+                    colored = false;
+                }
+                break;
+            case PatternToken::IF:
+                if (marks && segment.condition == PatternToken::COLOR && hasColor)
+                {
+                    marks->Add(out.size(), ColorMarkKind::BEGIN_COLORED);
+                    coloredBlockEnds |= uint64_t{1} << segment.jump;
+                }
+                else if (IsFieldEmpty(segment.condition, record, title, cfg, color))
+                    i = segment.jump;
+                break;
+            case PatternToken::ENDIF:
+                if (coloredBlockEnds & (uint64_t{1} << i))
+                    marks->Add(out.size(), ColorMarkKind::END_COLORED);
+                break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,94 @@
+#include "rklog/Logger/ColorLogger.hpp"
+#include "rklog/Logger/Registry.hpp"
+
+namespace rklog {
+
+/**
+ * Checks whether a dotted name is at or below another
+ */
+static bool IsBelow(std::string_view name, std::string_view parent) noexcept
+{
+    if (parent.empty())
+        return true;
+
+    return name.starts_with(parent) && (name.size() == parent.size() || name[parent.size()] == '.');
+}
+
+LoggerRegistry::LoggerRegistry() noexcept :
+    m_Factory([](std::string_view name) -> std::shared_ptr<Logger> { return std::make_shared<ColorLogger>(name); }) {}
+
+void LoggerRegistry::Register(std::string_view name, std::shared_ptr<Logger> logger) noexcept
+{
+    if (!logger)
+        return;
+
+    const std::lock_guard lock(m_Mutex);
+    if (const std::optional<LogLevel> level = GetInheritedLevel(name))
+        logger->SetLevel(*level);
+
+    Entry& entry = m_Entries.try_emplace(std::string(name)).first->second;
+    if (entry.owner)
+        m_Replaced.push_back(std::move(entry.owner));
+
+    entry.logger.store(logger.get(), std::memory_order_release);
+    entry.owner = std::move(logger);
+}
+
+LoggerHandle LoggerRegistry::GetHandle(std::string_view name) noexcept
+{
+    const std::lock_guard lock(m_Mutex);
+    auto it = m_Entries.find(name);
+    if (it == m_Entries.end())
+    {
+        std::shared_ptr<Logger> logger = m_Factory(name);
+        if (const std::optional<LogLevel> level = GetInheritedLevel(name))
+            logger->SetLevel(*level);
+
+        it = m_Entries.try_emplace(std::string(name)).first;
+        it->second.logger.store(logger.get(), std::memory_order_release);
+        it->second.owner = std::move(logger);
+    }
+
+    return LoggerHandle(it->second.logger);
+}
+
+void LoggerRegistry::SetLevel(std::string_view name, LogLevel level) noexcept
+{
+    const std::lock_guard lock(m_Mutex);
+    m_Levels.insert_or_assign(std::string(name), level);
+
+    for (auto it = m_Entries.lower_bound(name); it != m_Entries.end() && it->first.starts_with(name); ++it)
+    {
+        if (IsBelow(it->first, name))
+            it->second.owner->SetLevel(*GetInheritedLevel(it->first));
+    }
+}
+
+void LoggerRegistry::SetFactory(LoggerFactory factory) noexcept
+{
+    const std::lock_guard lock(m_Mutex);
+    m_Factory = std::move(factory);
+}
+
+std::optional<LogLevel> LoggerRegistry::GetInheritedLevel(std::string_view name) const noexcept
+{
+    while (true)
+    {
+        if (const auto it = m_Levels.find(name); it != m_Levels.end())
+            return it->second;
+
+        if (name.empty())
+            return std::nullopt;
+
+        const size_t dot = name.rfind('.');
+        name = dot == std::string_view::npos ? std::string_view() : name.substr(0, dot);
+    }
+}
+
+LoggerRegistry& GetRegistry() noexcept
+{
+    static LoggerRegistry registry{};
+    return registry;
+}
+
+}
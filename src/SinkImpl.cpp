@@ -0,0 +1,390 @@
+#include "rklog/Logger/FileSink.hpp"
+#include "rklog/Logger/JsonSink.hpp"
+#include "rklog/Logger/Sink.hpp"
+#include "rklog/Logger/SinkLogger.hpp"
+#include "rklog/Logger/UringSink.hpp"
+
+#include "rklog/Core/Buffer.hpp"
+#include "rklog/Core/Json.hpp"
+#include "rklog/Core/Time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <iterator>
+#include <system_error>
+
+namespace rklog {
+
+/**
+ * Gets the next multiple of the interval since the epoch after a point in time
+ */
+static int64_t NextRotationTime(int64_t now, std::chrono::seconds interval) noexcept
+{
+    const int64_t period = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+    return (now / period + 1) * period;
+}
+
+/// The members the JSON sink writes for every record
+static constexpr std::array<std::string_view, 8> JSON_KEYS = {
+    "time", "level", "logger", "msg", "file", "line", "func", "thread"
+};
+/// Put before the keys of fields that are named like one of those members
+static constexpr std::string_view JSON_FIELD_PREFIX = "fields.";
+
+static void AppendNumber(std::string& out, uint64_t value) noexcept
+{
+    char buffer[20]{};
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+std::string_view LogLine::Render(bool color, std::string& scratch) const noexcept
+{
+    if (m_Marks.Size() == 0 || (!color && !m_Marks.HasColoredText()))
+        return m_Text;
+
+    scratch.clear();
+    size_t offset{};
+    // The nesting of the `{if:color}` blocks being skipped
+    uint32_t hidden{};
+    for (size_t i = 0; i < m_Marks.Size(); i++)
+    {
+        const ColorMark& mark = m_Marks[i];
+        if (hidden == 0)
+            scratch.append(m_Text.substr(offset, mark.offset - offset));
+
+        offset = mark.offset;
+        switch (mark.kind)
+        {
+            case ColorMarkKind::COLOR:
+                if (color)
+                    scratch.append(m_ColorCode);
+                break;
+            case ColorMarkKind::RESET:
+                if (color)
+                    scratch.append(ANSI_RESET);
+                break;
+            case ColorMarkKind::BEGIN_COLORED:
+                if (!color)
+                    hidden++;
+                break;
+            case ColorMarkKind::END_COLORED:
+                if (hidden > 0)
+                    hidden--;
+                break;
+        }
+    }
+
+    if (hidden == 0)
+        scratch.append(m_Text.substr(offset));
+    else if (m_Text.ends_with('\n'))
+        scratch.push_back('\n'); // A block left open runs to the end of the line
+
+    return scratch;
+}
+
+void Sink::Write(const LogLine& line) noexcept
+{
+    if (line.GetLevel() < GetLevel())
+        return;
+
+    m_Counters.CountRecord(line.GetLevel());
+    const WriteGuard guard(m_Lock, m_AtomicWrite);
+    WriteInternal(line);
+}
+
+void Sink::Flush() noexcept
+{
+    const WriteGuard guard(m_Lock);
+    FlushInternal();
+}
+
+FileSink::~FileSink() noexcept
+{
+    if (m_Timer.joinable())
+    {
+        {
+            const std::lock_guard lock(m_TimerMutex);
+            m_StopTimer = true;
+        }
+        m_TimerSignal.notify_one();
+        m_Timer.join();
+    }
+
+    Flush();
+}
+
+LogStats FileSink::GetStats() const noexcept
+{
+    LogStats stats = Sink::GetStats();
+    stats.AddOutput(m_Writer.GetStats());
+    return stats;
+}
+
+void FileSink::WriteInternal(const LogLine& line) noexcept
+{
+    // The timer starts with the first line rather than with the sink, so
+    // that the lock policy can still be set until then
+    if (m_Policy.GetMode() == FlushMode::INTERVAL && !m_Timer.joinable())
+        m_Timer = std::thread(&FileSink::RunFlushTimer, this);
+
+    FormatBuffer scratch{};
+    const std::string_view text = RenderLine(line, *scratch);
+
+    if (m_Rotation.IsEnabled())
+    {
+        const int64_t now = line.GetRecord().time.SinceEpoch();
+        const uint64_t maxSize = m_Rotation.GetMaxSize();
+        if ((maxSize > 0 && m_FileSize > 0 && m_FileSize + text.size() > maxSize) ||
+            (m_NextRotation > 0 && now >= m_NextRotation))
+            Rotate(now);
+    }
+
+    m_Writer.Write(text);
+    m_FileSize += text.size();
+    if (m_Policy.FlushesImmediately(line.GetLevel()))
+        m_Writer.Flush();
+}
+
+void FileSink::FlushInternal() noexcept
+{
+    m_Writer.Flush();
+}
+
+std::string_view FileSink::RenderLine(const LogLine& line, std::string& scratch) const noexcept
+{
+    return line.Render(false, scratch);
+}
+
+void FileSink::Start() noexcept
+{
+    // With rotation the file is appended to, so a restart keeps the lines of
+    // the previous run and rotates them away once the file is full
+    if (m_Rotation.IsEnabled())
+    {
+        std::error_code error{};
+        const uintmax_t size = std::filesystem::file_size(m_Path, error);
+        m_FileSize = error ? 0 : static_cast<uint64_t>(size);
+    }
+
+    if (m_Rotation.GetInterval().count() > 0)
+        m_NextRotation = NextRotationTime(TimeStamp::Now().SinceEpoch(), m_Rotation.GetInterval());
+
+    // The timer flushes the buffer the writers fill, so it has to lock
+    // against them even for a sink used by a single thread
+    if (m_Policy.GetMode() == FlushMode::INTERVAL)
+        m_Lock.SetShared(true);
+}
+
+void FileSink::Rotate(int64_t now) noexcept
+{
+    // Windows cannot rename open files, so the file is closed first
+    m_Writer.Close();
+
+    std::error_code error{};
+    const std::filesystem::path rotatedPath = m_Archiver.NextPath();
+    std::filesystem::rename(m_Path, rotatedPath, error);
+
+    // If the file could not be moved aside, keep appending to it rather than
+    // truncating what was already written. The size is reset either way, so
+    // that the next attempt waits for another full file instead of being
+    // retried on every line
+    m_Writer.Open(m_Path, static_cast<bool>(error));
+    m_FileSize = 0;
+    if (!error)
+        m_Archiver.Submit(rotatedPath);
+
+    if (m_NextRotation > 0)
+        m_NextRotation = NextRotationTime(now, m_Rotation.GetInterval());
+}
+
+void FileSink::RunFlushTimer() noexcept
+{
+    std::unique_lock lock(m_TimerMutex);
+    while (!m_StopTimer)
+    {
+        m_TimerSignal.wait_for(lock, m_Policy.GetInterval(), [this] { return m_StopTimer; });
+        Flush();
+    }
+}
+
+UringFileSink::UringFileSink(const std::filesystem::path& filePath, FlushPolicy policy, UringPolicy uring) noexcept :
+    Sink(false), m_Writer(filePath, policy.GetBufferSize(), uring), m_Policy(policy)
+{
+    // The timer submits the buffer the writers fill, so it has to lock
+    // against them even for a sink used by a single thread
+    if (m_Policy.GetMode() == FlushMode::INTERVAL)
+        m_Lock.SetShared(true);
+}
+
+UringFileSink::~UringFileSink() noexcept
+{
+    if (m_Timer.joinable())
+    {
+        {
+            const std::lock_guard lock(m_TimerMutex);
+            m_StopTimer = true;
+        }
+        m_TimerSignal.notify_one();
+        m_Timer.join();
+    }
+
+    Flush();
+}
+
+LogStats UringFileSink::GetStats() const noexcept
+{
+    LogStats stats = Sink::GetStats();
+    stats.AddOutput(m_Writer.GetStats());
+    return stats;
+}
+
+void UringFileSink::WriteInternal(const LogLine& line) noexcept
+{
+    // The timer starts with the first line rather than with the sink, so
+    // that the lock policy can still be set until then
+    if (m_Policy.GetMode() == FlushMode::INTERVAL && !m_Timer.joinable())
+        m_Timer = std::thread(&UringFileSink::RunFlushTimer, this);
+
+    FormatBuffer scratch{};
+    m_Writer.Write(line.Render(false, *scratch));
+
+    // Without syncs the buffer is written right away with a single blocking
+    // `pwrite()`, with them it is handed to the ring along with its sync and
+    // the caller only waits if every buffer is still in flight
+    if (m_Policy.FlushesImmediately(line.GetLevel()))
+        m_Writer.Submit();
+}
+
+void UringFileSink::FlushInternal() noexcept
+{
+    m_Writer.Flush();
+}
+
+void UringFileSink::RunFlushTimer() noexcept
+{
+    std::unique_lock lock(m_TimerMutex);
+    while (!m_StopTimer)
+    {
+        m_TimerSignal.wait_for(lock, m_Policy.GetInterval(), [this] { return m_StopTimer; });
+
+        // Only submits the current buffer; waiting for every buffer in flight
+        // under the lock of the sink would stall the loggers
+        const WriteGuard guard(m_Lock);
+        m_Writer.Submit();
+    }
+}
+
+std::string_view JsonSink::RenderLine(const LogLine& line, std::string& scratch) const noexcept
+{
+    constexpr TimeFormat TIME_FORMAT{TimePrecision::MICROSECONDS, true, true};
+    const LogRecord& record = line.GetRecord();
+
+    scratch.clear();
+    scratch.append("{\"time\":\"");
+    record.time.FormatTo(std::back_inserter(scratch), TIME_FORMAT);
+    scratch.append("\",\"level\":\"");
+    scratch.append(GetLevelName(record.level));
+    scratch.push_back('"');
+
+    if (!line.GetTitle().empty())
+    {
+        scratch.append(",\"logger\":");
+        AppendJsonString(scratch, line.GetTitle());
+    }
+
+    scratch.append(",\"msg\":");
+    AppendJsonString(scratch, record.message);
+
+    if (*record.location.file != '\0')
+    {
+        scratch.append(",\"file\":");
+        AppendJsonString(scratch, record.location.file);
+        scratch.append(",\"line\":");
+        AppendNumber(scratch, record.location.line);
+    }
+
+    if (*record.location.function != '\0')
+    {
+        scratch.append(",\"func\":");
+        AppendJsonString(scratch, record.location.function);
+    }
+
+    scratch.append(",\"thread\":");
+    AppendNumber(scratch, record.threadId);
+
+    // Fields named like the members above would repeat their keys, and most
+    // parsers would keep only the last one
+    for (const Field& field : record.fields)
+    {
+        scratch.push_back(',');
+        const bool reserved = std::find(JSON_KEYS.begin(), JSON_KEYS.end(), field.GetKey()) != JSON_KEYS.end();
+        AppendFieldJson(scratch, field, reserved ? JSON_FIELD_PREFIX : std::string_view{});
+    }
+
+    scratch.append("}\n");
+    return scratch;
+}
+
+void SinkLogger::Attach(std::shared_ptr<Sink> sink) noexcept
+{
+    const std::lock_guard lock(m_SinksMutex);
+    const std::shared_ptr<const SinkList> current = m_Sinks.load();
+
+    auto sinks = current ? std::make_shared<SinkList>(*current) : std::make_shared<SinkList>();
+    sinks->push_back(std::move(sink));
+    m_Sinks.store(std::move(sinks));
+}
+
+void SinkLogger::Detach(const std::shared_ptr<Sink>& sink) noexcept
+{
+    const std::lock_guard lock(m_SinksMutex);
+    const std::shared_ptr<const SinkList> current = m_Sinks.load();
+    if (!current)
+        return;
+
+    auto sinks = std::make_shared<SinkList>(*current);
+    std::erase(*sinks, sink);
+    m_Sinks.store(std::move(sinks));
+}
+
+LogStats SinkLogger::GetStats() const noexcept
+{
+    LogStats stats = Logger::GetStats();
+    if (const std::shared_ptr<const SinkList> sinks = m_Sinks.load())
+    {
+        for (const std::shared_ptr<Sink>& sink : *sinks)
+            stats.AddOutput(sink->GetStats());
+    }
+
+    return stats;
+}
+
+void SinkLogger::Flush() noexcept
+{
+    if (const std::shared_ptr<const SinkList> sinks = m_Sinks.load())
+    {
+        for (const std::shared_ptr<Sink>& sink : *sinks)
+            sink->Flush();
+    }
+}
+
+void SinkLogger::LogInternal(const LogRecord& record) noexcept
+{
+    const std::shared_ptr<const SinkList> sinks = m_Sinks.load();
+    if (!sinks || sinks->empty())
+        return;
+
+    FormatBuffer logMessage{};
+    ColorMarks marks{};
+    m_Style.FormatTo(*logMessage, record, m_Title, marks);
+    logMessage->push_back('\n');
+
+    const LogLine line(record, m_Title ? std::string_view(*m_Title) : std::string_view(), *logMessage, marks, m_Style.GetConfig(record.level).GetColorCode());
+    for (const std::shared_ptr<Sink>& sink : *sinks)
+        sink->Write(line);
+}
+
+}
@@ -0,0 +1,192 @@
+#include "rklog/Logger/Site.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rklog {
+
+/**
+ * Matches text against a glob where `*` matches any run of characters and
+ * `?` any single character
+ */
+static bool MatchGlob(std::string_view glob, std::string_view text) noexcept
+{
+    size_t g{};
+    size_t t{};
+    size_t star = std::string_view::npos;
+    size_t resume{};
+    while (t < text.size())
+    {
+        if (g < glob.size() && (glob[g] == '?' || glob[g] == text[t]))
+        {
+            g++;
+            t++;
+        }
+        else if (g < glob.size() && glob[g] == '*')
+        {
+            star = g++;
+            resume = t;
+        }
+        else if (star != std::string_view::npos)
+        {
+            // Let the last star swallow one more character and retry
+            g = star + 1;
+            t = ++resume;
+        }
+        else
+            return false;
+    }
+
+    while (g < glob.size() && glob[g] == '*')
+        g++;
+
+    return g == glob.size();
+}
+
+/**
+ * Class containing every registered call site and the rules switching them on
+ * and off
+ */
+class CallSiteRegistry final
+{
+public:
+    /**
+     * Gets the global registry. Created on first use, so call sites can
+     * register from static initializers of any translation unit
+     */
+    static CallSiteRegistry& Get() noexcept
+    {
+        static CallSiteRegistry registry{};
+        return registry;
+    }
+
+    /**
+     * Applies the rules to a call site and links it into the list
+     */
+    void Register(CallSite& site) noexcept
+    {
+        const std::lock_guard lock(m_Mutex);
+        for (const Rule& rule : m_Rules)
+        {
+            if (rule.Matches(site.GetInfo()))
+                site.m_Enabled.store(rule.enabled, std::memory_order_relaxed);
+        }
+
+        site.m_Next = m_Head;
+        m_Head = &site;
+    }
+
+    /**
+     * Unlinks a call site from the list, e.g. when the library it is in is
+     * unloaded
+     */
+    void Unregister(CallSite& site) noexcept
+    {
+        const std::lock_guard lock(m_Mutex);
+        for (CallSite** link = &m_Head; *link; link = &(*link)->m_Next)
+        {
+            if (*link == &site)
+            {
+                *link = site.m_Next;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Switches the matching call sites and remembers the rule for call sites
+     * registered later
+     */
+    size_t Apply(const CallSiteFilter& filter, bool enabled) noexcept
+    {
+        const std::lock_guard lock(m_Mutex);
+
+        // A rule for the same globs that matches no more levels than the new
+        // one is fully overridden by it, so toggling the same sites over and
+        // over does not grow the list
+        std::erase_if(m_Rules, [&filter](const Rule& old) {
+            return old.file == filter.file && old.function == filter.function && old.maxLevel <= filter.maxLevel;
+        });
+
+        const Rule& rule = m_Rules.emplace_back(std::string(filter.file), std::string(filter.function), filter.maxLevel, enabled);
+
+        size_t matched{};
+        for (CallSite* site = m_Head; site; site = site->m_Next)
+        {
+            if (rule.Matches(site->GetInfo()))
+            {
+                site->m_Enabled.store(enabled, std::memory_order_relaxed);
+                matched++;
+            }
+        }
+
+        return matched;
+    }
+
+    /**
+     * Calls a function for every registered call site
+     */
+    void ForEach(const std::function<void(const CallSite&)>& callback) noexcept
+    {
+        const std::lock_guard lock(m_Mutex);
+        for (const CallSite* site = m_Head; site; site = site->m_Next)
+            callback(*site);
+    }
+
+private:
+    /**
+     * Struct containing a filter applied to the call sites
+     */
+    struct Rule
+    {
+    public:
+        std::string file{};     // The glob matched against the source file
+        std::string function{}; // The glob matched against the function
+        LogLevel maxLevel{};    // Sites with a higher level are not matched
+        bool enabled{};         // Whether matched sites are switched on
+
+    public:
+        bool Matches(const CallSiteInfo& info) const noexcept
+        {
+            return info.level <= maxLevel && MatchGlob(file, info.file) && MatchGlob(function, info.function);
+        }
+    };
+
+private:
+    /// The most recently registered call site
+    CallSite* m_Head{};
+    /// The rules applied so far, in order
+    std::vector<Rule> m_Rules{};
+    /// Serializes registering and switching call sites
+    std::mutex m_Mutex{};
+};
+
+CallSite::CallSite(const CallSiteInfo& info) noexcept :
+    m_Info(info)
+{
+    CallSiteRegistry::Get().Register(*this);
+}
+
+CallSite::~CallSite() noexcept
+{
+    CallSiteRegistry::Get().Unregister(*this);
+}
+
+size_t EnableCallSites(const CallSiteFilter& filter) noexcept
+{
+    return CallSiteRegistry::Get().Apply(filter, true);
+}
+
+size_t DisableCallSites(const CallSiteFilter& filter) noexcept
+{
+    return CallSiteRegistry::Get().Apply(filter, false);
+}
+
+void ForEachCallSite(const std::function<void(const CallSite&)>& callback) noexcept
+{
+    CallSiteRegistry::Get().ForEach(callback);
+}
+
+}
@@ -0,0 +1,177 @@
+#include "rklog/Core/Stats.hpp"
+#include "rklog/Logger/StatsReporter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rklog {
+
+uint64_t LatencyHistogram::Count() const noexcept
+{
+    uint64_t count{};
+    for (const uint64_t bucket : buckets)
+        count += bucket;
+
+    return count;
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const noexcept
+{
+    const uint64_t count = Count();
+    if (count == 0)
+        return 0;
+
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count))), 1);
+
+    uint64_t seen{};
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return i + 1 < BUCKET_COUNT ? (uint64_t{1} << (i + 1)) - 1 : UINT64_MAX;
+    }
+
+    return UINT64_MAX;
+}
+
+LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& other) noexcept
+{
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+        buckets[i] += other.buckets[i];
+
+    return *this;
+}
+
+LatencyHistogram LatencyRecorder::Get() const noexcept
+{
+    LatencyHistogram histogram{};
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+        histogram.buckets[i] = m_Buckets[i].Get();
+
+    return histogram;
+}
+
+uint64_t LogStats::TotalRecords() const noexcept
+{
+    uint64_t total{};
+    for (const uint64_t count : records)
+        total += count;
+
+    return total;
+}
+
+uint64_t LogStats::TotalDropped() const noexcept
+{
+    uint64_t total{};
+    for (const uint64_t count : dropped)
+        total += count;
+
+    return total;
+}
+
+void LogStats::AddOutput(const LogStats& output) noexcept
+{
+    for (size_t i = 0; i < LEVEL_COUNT; i++)
+        dropped[i] += output.dropped[i];
+
+    bytesWritten += output.bytesWritten;
+    writeCalls += output.writeCalls;
+    writeNanos += output.writeNanos;
+    writeErrors += output.writeErrors;
+    flushes += output.flushes;
+    queueHighWater = std::max(queueHighWater, output.queueHighWater);
+    writeLatency += output.writeLatency;
+    queueLatency += output.queueLatency;
+}
+
+void LogStats::AddOutput(const FileStats& file) noexcept
+{
+    bytesWritten += file.bytesWritten;
+    writeCalls += file.writeCalls;
+    writeNanos += file.writeNanos;
+    writeErrors += file.writeErrors;
+    flushes += file.flushes;
+    writeLatency += file.writeLatency;
+}
+
+LogStats LogCounters::Get() const noexcept
+{
+    LogStats stats{};
+    for (const Shard& shard : m_Shards)
+    {
+        for (size_t i = 0; i < LEVEL_COUNT; i++)
+        {
+            stats.records[i] += shard.records[i].load(std::memory_order_relaxed);
+            stats.dropped[i] += shard.dropped[i].load(std::memory_order_relaxed);
+        }
+
+        stats.suppressed += shard.suppressed.load(std::memory_order_relaxed);
+        stats.bytesWritten += shard.bytesWritten.load(std::memory_order_relaxed);
+        stats.writeCalls += shard.writeCalls.load(std::memory_order_relaxed);
+        stats.writeNanos += shard.writeNanos.load(std::memory_order_relaxed);
+        stats.writeErrors += shard.writeErrors.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+size_t LogCounters::NextShardIndex() noexcept
+{
+    static std::atomic<size_t> next{};
+    return next.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+}
+
+StatsReporter::StatsReporter(const Logger& source, Logger& target, std::string_view name, std::chrono::milliseconds interval) noexcept :
+    m_Source(source), m_Target(target), m_Name(name), m_Interval(interval)
+{
+    m_Thread = std::thread(&StatsReporter::Run, this);
+}
+
+StatsReporter::~StatsReporter() noexcept
+{
+    {
+        const std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Signal.notify_one();
+    m_Thread.join();
+}
+
+void StatsReporter::Report() noexcept
+{
+    const LogStats stats = m_Source.GetStats();
+    const auto level = [&stats](LogLevel level) { return stats.records[static_cast<size_t>(level)]; };
+
+    m_Target.Info("logger stats",
+        kv("logger", m_Name),
+        kv("records", stats.TotalRecords()),
+        kv("records_debug", level(LogLevel::LOG_DEBUG)),
+        kv("records_info", level(LogLevel::LOG_INFO)),
+        kv("records_warning", level(LogLevel::LOG_WARNING)),
+        kv("records_error", level(LogLevel::LOG_ERROR)),
+        kv("records_fatal", level(LogLevel::LOG_FATAL)),
+        kv("suppressed", stats.suppressed),
+        kv("dropped", stats.TotalDropped()),
+        kv("bytes", stats.bytesWritten),
+        kv("write_calls", stats.writeCalls),
+        kv("write_ns", stats.writeNanos),
+        kv("write_errors", stats.writeErrors),
+        kv("write_p99_ns", stats.writeLatency.Percentile(99.0)),
+        kv("flushes", stats.flushes),
+        kv("queue_high_water", stats.queueHighWater),
+        kv("queue_p50_ns", stats.queueLatency.Percentile(50.0)),
+        kv("queue_p99_ns", stats.queueLatency.Percentile(99.0)));
+}
+
+void StatsReporter::Run() noexcept
+{
+    std::unique_lock lock(m_Mutex);
+    while (!m_Stop)
+    {
+        if (!m_Signal.wait_for(lock, m_Interval, [this] { return m_Stop; }))
+            Report();
+    }
+}
+
+}
@@ -0,0 +1,148 @@
+#include "rklog/Core/Platform.hpp"
+#include "rklog/Core/Thread.hpp"
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+#include <Windows.h>
+
+#include <climits>
+#elif defined(RKLOG_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <format>
+#include <string_view>
+#elif defined(RKLOG_PLATFORM_APPLE)
+#include <pthread.h>
+#endif
+
+namespace rklog {
+
+uint64_t QueryThreadId() noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    return static_cast<uint64_t>(::GetCurrentThreadId());
+#elif defined(RKLOG_PLATFORM_LINUX)
+    return static_cast<uint64_t>(::syscall(SYS_gettid));
+#elif defined(RKLOG_PLATFORM_APPLE)
+    uint64_t threadId{};
+    ::pthread_threadid_np(nullptr, &threadId);
+    return threadId;
+#endif
+}
+
+#if defined(RKLOG_PLATFORM_LINUX)
+/**
+ * Reads the CPUs of a NUMA node from sysfs, a list of ranges such as
+ * `0-3,8-11`
+ *
+ * @param[in] node
+ *      The index of the NUMA node
+ * @param[out] set
+ *      The CPUs of the node
+ *
+ * @return
+ *      `true` if the node has at least one CPU
+ */
+static bool ReadNodeCpus(uint32_t node, cpu_set_t& set) noexcept
+{
+    std::array<char, 64> path{};
+    std::format_to_n(path.data(), path.size() - 1, "/sys/devices/system/node/node{}/cpulist", node);
+
+    const int handle = ::open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (handle < 0)
+        return false;
+
+    std::array<char, 4096> text{};
+    const ssize_t size = ::read(handle, text.data(), text.size() - 1);
+    ::close(handle);
+    if (size <= 0)
+        return false;
+
+    // Terminating the list makes sure the last range is added as well
+    text[static_cast<size_t>(size)] = '\n';
+
+    CPU_ZERO(&set);
+    uint32_t first{};
+    uint32_t current{};
+    bool inRange{};
+    bool hasDigits{};
+    bool any{};
+    for (const char c : std::string_view(text.data(), static_cast<size_t>(size) + 1))
+    {
+        if (c >= '0' && c <= '9')
+        {
+            current = current * 10 + static_cast<uint32_t>(c - '0');
+            hasDigits = true;
+            continue;
+        }
+
+        if (c == '-')
+        {
+            first = current;
+            inRange = true;
+        }
+        else if ((c == ',' || c == '\n') && hasDigits)
+        {
+            for (uint32_t cpu = inRange ? first : current; cpu <= current && cpu < CPU_SETSIZE; cpu++)
+            {
+                CPU_SET(cpu, &set);
+                any = true;
+            }
+
+            inRange = false;
+        }
+
+        current = 0;
+        hasDigits = false;
+    }
+
+    return any;
+}
+#endif
+
+bool PinThreadToCpu(uint32_t cpu) noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    if (cpu >= sizeof(DWORD_PTR) * 8)
+        return false;
+
+    return ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(RKLOG_PLATFORM_LINUX)
+    if (cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t set{};
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#elif defined(RKLOG_PLATFORM_APPLE)
+    static_cast<void>(cpu);
+    return false;
+#endif
+}
+
+bool PinThreadToNode(uint32_t node) noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    GROUP_AFFINITY affinity{};
+    if (node > USHRT_MAX || !::GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity))
+        return false;
+
+    return ::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(RKLOG_PLATFORM_LINUX)
+    cpu_set_t set{};
+    if (!ReadNodeCpus(node, set))
+        return false;
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#elif defined(RKLOG_PLATFORM_APPLE)
+    static_cast<void>(node);
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,135 @@
+#include "rklog/Core/Platform.hpp"
+#include "rklog/Core/Time.hpp"
+
+#include <climits>
+#include <ctime>
+
+namespace rklog {
+
+namespace {
+
+/**
+ * Struct containing the broken down time of the last second a thread has
+ * formatted, along with its text
+ */
+struct TimeCache
+{
+    /// The second since the epoch that is cached
+    int64_t second{LLONG_MIN};
+    /// The minute since the epoch that was last broken down
+    int64_t minute{LLONG_MIN};
+    /// The hours of the cached second
+    uint32_t hours{};
+    /// The minutes of the cached second
+    uint32_t minutes{};
+    /// The seconds of the cached second
+    uint32_t seconds{};
+    /// The cached text as `YYYY-MM-DDTHH:MM:SS`, the time starts at `TIME_OFFSET`
+    char text[19]{};
+};
+
+}
+
+/// The offset of `HH:MM:SS` in the cached text
+static constexpr size_t TIME_OFFSET = 11;
+
+static void WriteDigits(char* dst, uint32_t value, int count) noexcept
+{
+    for (int i = count - 1; i >= 0; i--)
+    {
+        dst[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+static int64_t FloorDiv(int64_t value, int64_t divisor) noexcept
+{
+    const int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+static void BreakDownTime(std::time_t time, bool utc, std::tm& out) noexcept
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    if (utc)
+        ::gmtime_s(&out, &time);
+    else
+        ::localtime_s(&out, &time);
+#else
+    if (utc)
+        ::gmtime_r(&time, &out);
+    else
+        ::localtime_r(&time, &out);
+#endif
+}
+
+static const TimeCache& GetTimeCache(int64_t nanoseconds, bool utc) noexcept
+{
+    thread_local TimeCache localCache{};
+    thread_local TimeCache utcCache{};
+
+    TimeCache& cache = utc ? utcCache : localCache;
+    const int64_t second = FloorDiv(nanoseconds, 1'000'000'000);
+    if (second == cache.second)
+        return cache;
+
+    // Time zones are whole minutes off from UTC, so the date and the time up
+    // to the minute only need to be broken down once a minute
+    const int64_t minute = FloorDiv(second, 60);
+    if (minute == cache.minute)
+    {
+        cache.seconds = static_cast<uint32_t>(second - minute * 60);
+    }
+    else
+    {
+        std::tm time{};
+        BreakDownTime(static_cast<std::time_t>(second), utc, time);
+
+        cache.hours = static_cast<uint32_t>(time.tm_hour);
+        cache.minutes = static_cast<uint32_t>(time.tm_min);
+        cache.seconds = static_cast<uint32_t>(time.tm_sec);
+        cache.minute = minute;
+
+        char* const text = cache.text;
+        WriteDigits(text, static_cast<uint32_t>(time.tm_year + 1900), 4);
+        text[4] = '-';
+        WriteDigits(text + 5, static_cast<uint32_t>(time.tm_mon + 1), 2);
+        text[7] = '-';
+        WriteDigits(text + 8, static_cast<uint32_t>(time.tm_mday), 2);
+        text[10] = 'T';
+        WriteDigits(text + TIME_OFFSET, cache.hours, 2);
+        text[TIME_OFFSET + 2] = ':';
+        WriteDigits(text + TIME_OFFSET + 3, cache.minutes, 2);
+        text[TIME_OFFSET + 5] = ':';
+    }
+
+    WriteDigits(cache.text + TIME_OFFSET + 6, cache.seconds, 2);
+    cache.second = second;
+
+    return cache;
+}
+
+uint32_t TimeStamp::Hours() const noexcept
+{
+    return GetTimeCache(SinceEpoch(), false).hours;
+}
+
+uint32_t TimeStamp::Minutes() const noexcept
+{
+    return GetTimeCache(SinceEpoch(), false).minutes;
+}
+
+uint32_t TimeStamp::Seconds() const noexcept
+{
+    return GetTimeCache(SinceEpoch(), false).seconds;
+}
+
+std::string_view TimeStamp::CachedText(int64_t nanoseconds, bool utc, bool iso8601) noexcept
+{
+    const TimeCache& cache = GetTimeCache(nanoseconds, utc);
+    const std::string_view text(cache.text, sizeof(cache.text));
+
+    return iso8601 ? text : text.substr(TIME_OFFSET);
+}
+
+}
@@ -0,0 +1,761 @@
+#include "rklog/Core/Crash.hpp"
+#include "rklog/Core/Platform.hpp"
+#include "rklog/Core/Uring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(RKLOG_PLATFORM_LINUX)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace rklog {
+
+/// The fewest and most buffers a writer uses
+static constexpr size_t MIN_BUFFER_COUNT = 2;
+static constexpr size_t MAX_BUFFER_COUNT = 64;
+
+#if defined(RKLOG_PLATFORM_LINUX)
+
+/// Marks the completion of a sync in its user data, the rest is the buffer
+static constexpr uint64_t SYNC_FLAG = 1;
+/// The number of refused enters in a row after which the ring is dropped
+static constexpr uint32_t MAX_ENTER_FAILURES = 16;
+/// The longest time the crash hook waits for the requests in flight
+static constexpr uint64_t CRASH_WAIT_NANOS = 100'000'000;
+
+/**
+ * Enum describing what is queued again for a buffer after a reap
+ */
+enum class Retry : uint8_t
+{
+    NONE,  // Nothing
+    SYNC,  // The sync on its own
+    WRITE, // The rest of the write, along with its sync
+};
+
+/**
+ * Struct containing the rings shared with the kernel. Set up and used through
+ * the raw system calls, so that no library is needed
+ */
+struct UringRing final
+{
+public:
+    int handle{-1};                     // The file descriptor of the instance
+    void* sqMemory{MAP_FAILED};         // The mapped submission ring
+    size_t sqSize{};                    // Its size
+    void* cqMemory{MAP_FAILED};         // The mapped completion ring, may be the submission ring
+    size_t cqSize{};                    // Its size
+    ::io_uring_sqe* sqes{};             // The mapped submission entries
+    size_t sqesSize{};                  // Their size
+    unsigned* sqHead{};                 // The head of the submission ring, written by the kernel
+    unsigned* sqTail{};                 // The tail of the submission ring, written by us
+    unsigned* sqArray{};                // The indices of the submitted entries
+    unsigned sqMask{};                  // The mask of the submission ring
+    unsigned* cqHead{};                 // The head of the completion ring, written by us
+    unsigned* cqTail{};                 // The tail of the completion ring, written by the kernel
+    unsigned cqMask{};                  // The mask of the completion ring
+    ::io_uring_cqe* cqes{};             // The completion entries
+    unsigned pending{};                 // The entries queued but not yet published
+    bool registered{};                  // Whether the buffers are registered
+
+public:
+    ~UringRing() noexcept
+    {
+        if (sqes)
+            ::munmap(sqes, sqesSize);
+        if (cqMemory != MAP_FAILED && cqMemory != sqMemory)
+            ::munmap(cqMemory, cqSize);
+        if (sqMemory != MAP_FAILED)
+            ::munmap(sqMemory, sqSize);
+        if (handle >= 0)
+            ::close(handle);
+    }
+
+    /**
+     * Checks whether the submission ring has room for more entries, which
+     * only leave it once the kernel has taken them
+     */
+    bool HasRoom(unsigned count) const noexcept
+    {
+        return Unsubmitted() + pending + count <= sqMask + 1;
+    }
+
+    /**
+     * Gets the next free submission entry, cleared. Only called once
+     * `HasRoom()` has made sure there is one
+     */
+    ::io_uring_sqe& NextEntry() noexcept
+    {
+        const unsigned tail = std::atomic_ref(*sqTail).load(std::memory_order_relaxed) + pending;
+        const unsigned index = tail & sqMask;
+        sqArray[index] = index;
+        pending++;
+
+        ::io_uring_sqe& entry = sqes[index];
+        std::memset(&entry, 0, sizeof(entry));
+        return entry;
+    }
+
+    /**
+     * Gets the number of published entries the kernel has not taken yet
+     */
+    unsigned Unsubmitted() const noexcept
+    {
+        return std::atomic_ref(*sqTail).load(std::memory_order_relaxed) -
+            std::atomic_ref(*sqHead).load(std::memory_order_acquire);
+    }
+
+    /**
+     * Publishes the queued entries and enters the kernel to submit them and
+     * optionally wait for completions
+     */
+    int Enter(unsigned wait) noexcept
+    {
+        if (pending > 0)
+        {
+            std::atomic_ref(*sqTail).fetch_add(pending, std::memory_order_release);
+            pending = 0;
+        }
+
+        // Entries left behind by a failed or partial submission are still in
+        // the ring, so they go along with the new ones
+        const unsigned submit = Unsubmitted();
+        const unsigned flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (;;)
+        {
+            const long result = ::syscall(__NR_io_uring_enter, handle, submit, wait, flags, nullptr, 0);
+            if (result >= 0 || errno != EINTR)
+                return static_cast<int>(result);
+        }
+    }
+};
+
+#else
+
+/**
+ * Struct standing in for the rings where io_uring is unavailable
+ */
+struct UringRing final
+{
+};
+
+#endif
+
+/**
+ * Gets the time on the monotonic clock in nanoseconds
+ */
+static uint64_t NowNanos() noexcept
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Writes all of the data at an offset of a file descriptor, async-signal-safe
+ *
+ * @return
+ *      The number of bytes written
+ */
+static size_t WriteAt(int handle, const char* data, size_t size, [[maybe_unused]] uint64_t offset) noexcept
+{
+    size_t total{};
+    while (size > 0)
+    {
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        const int written = ::_write(handle, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t written = ::pwrite(handle, data, size, static_cast<off_t>(offset));
+#endif
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            break;
+
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+        total += static_cast<size_t>(written);
+    }
+
+    return total;
+}
+
+UringWriter::UringWriter(const std::filesystem::path& filePath, size_t bufferSize, UringPolicy policy) noexcept :
+    m_Policy(policy)
+{
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    m_Handle = ::_wopen(filePath.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | _O_TRUNC, _S_IREAD | _S_IWRITE);
+#else
+    m_Handle = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | O_TRUNC, 0644);
+#endif
+
+    const size_t count = std::clamp(policy.GetBufferCount(), MIN_BUFFER_COUNT, MAX_BUFFER_COUNT);
+    const size_t size = std::max<size_t>(bufferSize, 1);
+    m_Memory.reset(new (std::nothrow) char[count * size]);
+    m_Buffers.reset(new (std::nothrow) Buffer[count]);
+    if (!m_Memory || !m_Buffers)
+    {
+        m_Memory.reset();
+        m_Buffers.reset();
+        return;
+    }
+
+    m_BufferCount = count;
+    m_BufferSize = size;
+    for (size_t i = 0; i < count; i++)
+        m_Buffers[i].data = m_Memory.get() + i * size;
+
+    if (m_Handle >= 0 && policy.IsUringEnabled())
+        SetUpRing();
+
+    m_CrashSlot = RegisterCrashHook(CrashStage::BUFFER, &UringWriter::DrainOnCrash, this);
+}
+
+UringWriter::~UringWriter() noexcept
+{
+    UnregisterCrashHook(m_CrashSlot);
+    Flush();
+
+    // The ring has to go before the buffers registered with it
+    m_Ring.reset();
+    if (m_Handle >= 0)
+    {
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        ::_close(m_Handle);
+#else
+        ::close(m_Handle);
+#endif
+    }
+}
+
+void UringWriter::Write(std::string_view data) noexcept
+{
+    if (m_BufferCount == 0)
+        return;
+
+    while (!data.empty())
+    {
+        Buffer& buffer = m_Buffers[m_Current];
+        const size_t length = std::min(data.size(), m_BufferSize - buffer.size);
+        std::memcpy(buffer.data + buffer.size, data.data(), length);
+        buffer.size += length;
+        data.remove_prefix(length);
+
+        if (buffer.size == m_BufferSize)
+        {
+            SubmitBuffer(m_Current);
+            Advance();
+        }
+    }
+}
+
+void UringWriter::Submit() noexcept
+{
+    if (m_BufferCount == 0)
+        return;
+
+    // A round trip through the ring costs more than writing a few bytes
+    // directly, and this way the buffer can be filled again right away. Only
+    // syncs are worth waiting for elsewhere
+    Buffer& current = m_Buffers[m_Current];
+    if (m_Ring && m_Policy.GetSyncMode() == SyncMode::NONE)
+    {
+        if (current.size == 0)
+            return;
+
+        const uint64_t start = NowNanos();
+        const size_t written = WriteAt(m_Handle, current.data, current.size, m_Offset);
+        CountCall(NowNanos() - start, written < current.size);
+        m_BytesWritten.Add(written);
+        m_Flushes.Add(1);
+
+        m_Offset += current.size;
+        current.size = 0;
+        return;
+    }
+
+    const bool hasData = current.size > 0;
+    if (hasData)
+        SubmitBuffer(m_Current);
+
+    if (!m_Ring)
+        WriteFilled();
+
+    if (hasData)
+        Advance();
+}
+
+void UringWriter::Flush() noexcept
+{
+    Submit();
+
+#if defined(RKLOG_PLATFORM_LINUX)
+    while (m_Ring && m_InFlight > 0)
+        Reap(1);
+#endif
+}
+
+FileStats UringWriter::GetStats() const noexcept
+{
+    return FileStats{
+        m_BytesWritten.Get(), m_WriteCalls.Get(), m_WriteNanos.Get(),
+        m_WriteErrors.Get(), m_Flushes.Get(), m_WriteLatency.Get()
+    };
+}
+
+bool UringWriter::SetUpRing() noexcept
+{
+#if defined(RKLOG_PLATFORM_LINUX)
+    auto ring = std::unique_ptr<UringRing>(new (std::nothrow) UringRing());
+    if (!ring)
+        return false;
+
+    // A write and a sync per buffer can be in flight at once
+    ::io_uring_params params{};
+    const auto entries = static_cast<unsigned>(std::bit_ceil(m_BufferCount * 2));
+    ring->handle = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->handle < 0)
+        return false;
+
+    ring->sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+    const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMap)
+        ring->sqSize = ring->cqSize = std::max(ring->sqSize, ring->cqSize);
+
+    ring->sqMemory = ::mmap(nullptr, ring->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->handle, IORING_OFF_SQ_RING);
+    if (ring->sqMemory == MAP_FAILED)
+        return false;
+
+    ring->cqMemory = singleMap ? ring->sqMemory :
+        ::mmap(nullptr, ring->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->handle, IORING_OFF_CQ_RING);
+    if (ring->cqMemory == MAP_FAILED)
+        return false;
+
+    ring->sqesSize = params.sq_entries * sizeof(::io_uring_sqe);
+    void* const sqes = ::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->handle, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return false;
+
+    auto* const sq = static_cast<char*>(ring->sqMemory);
+    auto* const cq = static_cast<char*>(ring->cqMemory);
+    ring->sqes = static_cast<::io_uring_sqe*>(sqes);
+    ring->sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Registered buffers save the kernel from mapping the pages of every
+    // write. They count against RLIMIT_MEMLOCK, so plain writes are used if
+    // the registration is refused
+    ::iovec vectors[MAX_BUFFER_COUNT]{};
+    for (size_t i = 0; i < m_BufferCount; i++)
+        vectors[i] = ::iovec{m_Buffers[i].data, m_BufferSize};
+
+    ring->registered = ::syscall(__NR_io_uring_register, ring->handle, IORING_REGISTER_BUFFERS,
+        vectors, static_cast<unsigned>(m_BufferCount)) == 0;
+
+    m_Ring = std::move(ring);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UringWriter::SubmitBuffer(size_t index) noexcept
+{
+    Buffer& buffer = m_Buffers[index];
+    buffer.offset = m_Offset;
+    buffer.written = 0;
+    buffer.resync = false;
+    buffer.filled = true;
+    m_Offset += buffer.size;
+    m_Flushes.Add(1);
+
+    // Whatever has completed meanwhile is reaped without a system call
+    if (m_Ring)
+    {
+        QueueWrite(index, true);
+        Reap(0);
+    }
+}
+
+void UringWriter::QueueWrite([[maybe_unused]] size_t index, [[maybe_unused]] bool write) noexcept
+{
+#if defined(RKLOG_PLATFORM_LINUX)
+    Buffer& buffer = m_Buffers[index];
+    const SyncMode sync = m_Policy.GetSyncMode();
+
+    // A full submission ring is submitted first. If the kernel still does
+    // not take the entries, the ring is of no further use
+    const unsigned needed = (write ? 1 : 0) + (sync != SyncMode::NONE ? 1 : 0);
+    if (!m_Ring->HasRoom(needed) && (!EnterRing(0) || !m_Ring->HasRoom(needed)))
+    {
+        if (m_Ring)
+            DropRing();
+        return;
+    }
+
+    UringRing& ring = *m_Ring;
+    if (write)
+    {
+        ::io_uring_sqe& entry = ring.NextEntry();
+        entry.opcode = ring.registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        entry.fd = m_Handle;
+        entry.addr = reinterpret_cast<uint64_t>(buffer.data + buffer.written);
+        entry.len = static_cast<uint32_t>(buffer.size - buffer.written);
+        entry.off = buffer.offset + buffer.written;
+        entry.buf_index = static_cast<uint16_t>(index);
+        entry.user_data = index << 1;
+
+        // The sync only starts once the write has completed in full; a short
+        // or failed write cancels it
+        if (sync != SyncMode::NONE)
+            entry.flags |= IOSQE_IO_LINK;
+
+        buffer.writing = true;
+        buffer.pending++;
+        m_InFlight++;
+    }
+
+    if (sync != SyncMode::NONE)
+    {
+        ::io_uring_sqe& entry = ring.NextEntry();
+        entry.opcode = IORING_OP_FSYNC;
+        entry.fd = m_Handle;
+        entry.fsync_flags = sync == SyncMode::DATA ? IORING_FSYNC_DATASYNC : 0;
+        entry.user_data = (index << 1) | SYNC_FLAG;
+
+        buffer.resync = false;
+        buffer.pending++;
+        m_InFlight++;
+    }
+
+    EnterRing(0);
+#endif
+}
+
+void UringWriter::Reap([[maybe_unused]] uint32_t wait) noexcept
+{
+#if defined(RKLOG_PLATFORM_LINUX)
+    if (!m_Ring || (wait > 0 && !EnterRing(wait)))
+        return;
+
+    UringRing& ring = *m_Ring;
+
+    // Requests are queued again once the ring has been read, so that the
+    // kernel has room for their completions. A buffer gets one retry at
+    // most, a write taking its sync along
+    Retry retries[MAX_BUFFER_COUNT]{};
+
+    unsigned head = std::atomic_ref(*ring.cqHead).load(std::memory_order_relaxed);
+    const unsigned tail = std::atomic_ref(*ring.cqTail).load(std::memory_order_acquire);
+    for (; head != tail; head++)
+    {
+        const ::io_uring_cqe& completion = ring.cqes[head & ring.cqMask];
+        const size_t index = completion.user_data >> 1;
+        const bool isSync = completion.user_data & SYNC_FLAG;
+        const int result = completion.res;
+
+        Buffer& buffer = m_Buffers[index];
+        buffer.pending--;
+        m_InFlight--;
+
+        // Requests still queued when the thread that submitted them exits are
+        // cancelled by the kernel. Every write goes to an explicit offset, so
+        // repeating one is harmless
+        const bool interrupted = result == -ECANCELED || result == -EINTR || result == -EAGAIN;
+        if (isSync)
+        {
+            // A sync cancelled by a short write is queued again with the rest
+            // of the write, one cancelled on its own is queued again by itself
+            if (interrupted && buffer.writing)
+                buffer.resync = true;
+            else if (interrupted)
+                retries[index] = std::max(retries[index], Retry::SYNC);
+            else if (result < 0)
+                m_WriteErrors.Add(1);
+        }
+        else
+        {
+            if (result > 0)
+            {
+                buffer.written += static_cast<size_t>(result);
+                m_BytesWritten.Add(static_cast<uint64_t>(result));
+            }
+            else if (!interrupted)
+            {
+                // Nowhere to report the error to, so the data is dropped
+                m_WriteErrors.Add(1);
+                buffer.written = buffer.size;
+                buffer.resync = false;
+            }
+
+            // Marked as writing right away, so that a sync cancelled along
+            // with this write is left to the retry
+            buffer.writing = buffer.written < buffer.size;
+            if (buffer.writing)
+                retries[index] = Retry::WRITE;
+            else if (buffer.resync)
+                retries[index] = std::max(retries[index], Retry::SYNC);
+        }
+
+        if (buffer.pending == 0 && !buffer.writing && buffer.written == buffer.size && !buffer.resync)
+            buffer.filled = false;
+    }
+
+    std::atomic_ref(*ring.cqHead).store(head, std::memory_order_release);
+    for (size_t i = 0; i < m_BufferCount && m_Ring; i++)
+        if (retries[i] != Retry::NONE)
+            QueueWrite(i, retries[i] == Retry::WRITE);
+#endif
+}
+
+bool UringWriter::EnterRing([[maybe_unused]] uint32_t wait) noexcept
+{
+#if defined(RKLOG_PLATFORM_LINUX)
+    const uint64_t start = NowNanos();
+    const int result = m_Ring->Enter(wait);
+    const int error = errno;
+    CountCall(NowNanos() - start, result < 0);
+    if (result >= 0)
+    {
+        m_EnterFailures = 0;
+        return true;
+    }
+
+    // The kernel runs short of memory or of room for completions for a
+    // while, the latter until the ring is reaped. Anything else, or either
+    // of them for too long, means the ring is of no further use
+    if ((error == EAGAIN || error == EBUSY) && ++m_EnterFailures < MAX_ENTER_FAILURES)
+        return true;
+
+    DropRing();
+#endif
+    return false;
+}
+
+void UringWriter::DropRing() noexcept
+{
+#if defined(RKLOG_PLATFORM_LINUX)
+    m_Ring.reset();
+    m_InFlight = 0;
+    m_EnterFailures = 0;
+
+    // Every write goes to an explicit offset, so what remains of each filled
+    // buffer is written again, whatever the kernel made of it
+    for (size_t i = 0; i < m_BufferCount; i++)
+    {
+        Buffer& buffer = m_Buffers[i];
+        if (buffer.filled)
+        {
+            const size_t size = buffer.size - buffer.written;
+            const uint64_t start = NowNanos();
+            const size_t written = WriteAt(m_Handle, buffer.data + buffer.written, size, buffer.offset + buffer.written);
+            CountCall(NowNanos() - start, written < size);
+            m_BytesWritten.Add(written);
+        }
+
+        buffer.pending = 0;
+        buffer.writing = false;
+        buffer.resync = false;
+        buffer.filled = false;
+    }
+
+    if (m_Policy.GetSyncMode() != SyncMode::NONE)
+    {
+        const uint64_t start = NowNanos();
+        const int result = m_Policy.GetSyncMode() == SyncMode::DATA ? ::fdatasync(m_Handle) : ::fsync(m_Handle);
+        CountCall(NowNanos() - start, result < 0);
+    }
+
+    // The ring never moved the file position, and `writev()` goes on from it
+    ::lseek(m_Handle, static_cast<off_t>(m_Offset), SEEK_SET);
+#endif
+}
+
+void UringWriter::WriteFilled() noexcept
+{
+    if (m_Handle < 0)
+        return;
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+    for (size_t i = 1; i <= m_BufferCount; i++)
+    {
+        Buffer& buffer = m_Buffers[(m_Current + i) % m_BufferCount];
+        if (!buffer.filled)
+            continue;
+
+        const uint64_t start = NowNanos();
+        WriteAt(m_Handle, buffer.data, buffer.size, buffer.offset);
+        CountCall(NowNanos() - start, false);
+        m_BytesWritten.Add(buffer.size);
+        buffer.filled = false;
+    }
+
+    if (m_Policy.GetSyncMode() != SyncMode::NONE)
+        ::_commit(m_Handle);
+#else
+    // The filled buffers follow the current one around the ring, oldest first
+    ::iovec vectors[MAX_BUFFER_COUNT]{};
+    int count{};
+    for (size_t i = 1; i <= m_BufferCount; i++)
+    {
+        Buffer& buffer = m_Buffers[(m_Current + i) % m_BufferCount];
+        if (buffer.filled)
+            vectors[count++] = ::iovec{buffer.data, buffer.size};
+
+        buffer.filled = false;
+    }
+
+    ::iovec* next = vectors;
+    while (count > 0)
+    {
+        const uint64_t start = NowNanos();
+        const ssize_t written = ::writev(m_Handle, next, count);
+        CountCall(NowNanos() - start, written < 0 && errno != EINTR);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        m_BytesWritten.Add(static_cast<uint64_t>(written));
+        size_t left = static_cast<size_t>(written);
+        while (count > 0 && left >= next->iov_len)
+        {
+            left -= next->iov_len;
+            next++;
+            count--;
+        }
+
+        // The rest of a partly written buffer goes with the next call
+        if (count > 0)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + left;
+            next->iov_len -= left;
+        }
+    }
+
+    if (m_Policy.GetSyncMode() != SyncMode::NONE)
+    {
+        const uint64_t start = NowNanos();
+#if defined(RKLOG_PLATFORM_LINUX)
+        const int result = m_Policy.GetSyncMode() == SyncMode::DATA ? ::fdatasync(m_Handle) : ::fsync(m_Handle);
+#else
+        const int result = ::fsync(m_Handle);
+#endif
+        CountCall(NowNanos() - start, result < 0);
+    }
+#endif
+}
+
+void UringWriter::Advance() noexcept
+{
+    const size_t next = (m_Current + 1) % m_BufferCount;
+    Buffer& buffer = m_Buffers[next];
+
+    // Only waits when every buffer is still being written
+#if defined(RKLOG_PLATFORM_LINUX)
+    while (m_Ring && buffer.filled)
+        Reap(1);
+#endif
+
+    if (!m_Ring && buffer.filled)
+        WriteFilled();
+
+    m_Current = next;
+    buffer.size = 0;
+}
+
+void UringWriter::CountCall(uint64_t nanos, bool failed) noexcept
+{
+    m_WriteCalls.Add(1);
+    m_WriteNanos.Add(nanos);
+    m_WriteLatency.Record(nanos);
+    if (failed)
+        m_WriteErrors.Add(1);
+}
+
+bool UringWriter::DrainOnCrash(void* context) noexcept
+{
+    UringWriter& writer = *static_cast<UringWriter*>(context);
+    if (writer.m_Handle < 0 || writer.m_BufferCount == 0)
+        return true;
+
+    // What the kernel writes is not written again, and the bytes it reports
+    // are only counted here, so that a signal in the middle of a reap does
+    // no harm
+    size_t written[MAX_BUFFER_COUNT]{};
+    for (size_t i = 0; i < writer.m_BufferCount; i++)
+        written[i] = writer.m_Ring ? writer.m_Buffers[i].written : 0;
+
+#if defined(RKLOG_PLATFORM_LINUX)
+    // Entries the kernel has not taken yet are submitted, and the requests
+    // in flight are waited for a while. Whatever is still out afterwards is
+    // written again at its offset, which does no harm if it lands later
+    if (writer.m_Ring && writer.m_InFlight > 0)
+    {
+        UringRing& ring = *writer.m_Ring;
+        ::syscall(__NR_io_uring_enter, ring.handle, ring.Unsubmitted(), 0, 0, nullptr, 0);
+
+        const unsigned head = std::atomic_ref(*ring.cqHead).load(std::memory_order_relaxed);
+        const uint64_t deadline = NowNanos() + CRASH_WAIT_NANOS;
+        while (std::atomic_ref(*ring.cqTail).load(std::memory_order_acquire) - head < writer.m_InFlight &&
+            NowNanos() < deadline)
+        {
+            const ::timespec duration{0, 1'000'000};
+            ::nanosleep(&duration, nullptr);
+        }
+
+        const unsigned tail = std::atomic_ref(*ring.cqTail).load(std::memory_order_acquire);
+        for (unsigned i = head; i != tail; i++)
+        {
+            const ::io_uring_cqe& completion = ring.cqes[i & ring.cqMask];
+            if (!(completion.user_data & SYNC_FLAG) && completion.res > 0)
+                written[completion.user_data >> 1] += static_cast<size_t>(completion.res);
+        }
+    }
+#endif
+
+    for (size_t i = 1; i <= writer.m_BufferCount; i++)
+    {
+        const size_t index = (writer.m_Current + i) % writer.m_BufferCount;
+        const Buffer& buffer = writer.m_Buffers[index];
+        if (buffer.filled && written[index] < buffer.size)
+            WriteAt(writer.m_Handle, buffer.data + written[index], buffer.size - written[index], buffer.offset + written[index]);
+    }
+
+    const Buffer& current = writer.m_Buffers[writer.m_Current];
+    if (current.size > 0 && !current.filled)
+        WriteAt(writer.m_Handle, current.data, current.size, writer.m_Offset);
+
+    return true;
+}
+
+}
@@ -0,0 +1,114 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Logger/FileLogger.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+static std::atomic<uint64_t> s_Allocations{};
+
+void* operator new(size_t size)
+{
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* const ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+/// The number of records logged before counting, to warm up the buffers
+static constexpr int WARM_UP_RECORDS = 64;
+/// The number of records counted
+static constexpr int COUNTED_RECORDS = 1024;
+
+/**
+ * Logs records of every level with strings, numbers and a message longer
+ * than the small string buffer of `std::string`
+ *
+ * @param[in] logger
+ *      The logger to log to
+ * @param[in] count
+ *      The number of records to log
+ */
+static void LogRecords(rklog::Logger& logger, int count)
+{
+    static const std::string text(100, 'x');
+    for (int i = 0; i < count; i++)
+    {
+        logger.Info("record {} of {}: {} {:.3f}", i, count, text, i * 0.5);
+        logger.Warn("warning {}", i);
+        logger.Error("error {} in {}", i, "AllocTest");
+    }
+}
+
+/**
+ * Checks that a logger does not allocate once it has warmed up
+ *
+ * @param[in] name
+ *      The name of the logger, for the report
+ * @param[in] logger
+ *      The logger to check
+ *
+ * @return
+ *      `true` if no record allocated
+ */
+static bool ExpectNoAllocations(const char* name, rklog::Logger& logger)
+{
+    LogRecords(logger, WARM_UP_RECORDS);
+    logger.Flush();
+
+    const uint64_t before = s_Allocations.load();
+    LogRecords(logger, COUNTED_RECORDS);
+    const uint64_t allocations = s_Allocations.load() - before;
+    logger.Flush();
+
+    std::fprintf(stderr, "%s: %llu allocations for %d records\n", name, static_cast<unsigned long long>(allocations), COUNTED_RECORDS * 3);
+    return allocations == 0;
+}
+
+int main()
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "rklog_alloc_test.log";
+
+    bool passed = true;
+    {
+        rklog::BasicLogger logger{"basic"};
+        passed &= ExpectNoAllocations("BasicLogger", logger);
+    }
+    {
+        rklog::ColorLogger logger{"color"};
+        passed &= ExpectNoAllocations("ColorLogger", logger);
+    }
+    {
+        rklog::FileLogger logger{path, "file"};
+        passed &= ExpectNoAllocations("FileLogger", logger);
+    }
+
+    std::error_code ec{};
+    std::filesystem::remove(path, ec);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,169 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Core/Json.hpp>
+#include <rklog/Logger/JsonSink.hpp>
+#include <rklog/Logger/SinkLogger.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/// The longest text checked, enough for two AVX2 blocks, an SSE2 block and a
+/// scalar tail
+static constexpr size_t MAX_LENGTH = 100;
+/// Bytes that have to be escaped
+static constexpr char ESCAPED[] = { '"', '\\', '\0', '\x01', '\b', '\t', '\n', '\f', '\r', '\x1f' };
+/// Bytes that are copied as-is, around the edges of the escaped ones
+static constexpr char COPIED[] = { ' ', '/', '\x7f', '\x80', '\xc3', '\xff' };
+
+/**
+ * Escapes text one byte at a time, the way the vectorized search has to
+ *
+ * @param[in] text
+ *      The text to escape
+ *
+ * @return
+ *      The escaped text
+ */
+static std::string EscapeReference(std::string_view text)
+{
+    constexpr std::string_view HEX = "0123456789abcdef";
+    std::string out{};
+    for (const char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (byte < 0x20)
+                    out += std::string("\\u00") + HEX[byte >> 4] + HEX[byte & 0xF];
+                else
+                    out += c;
+                break;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Checks that a text is escaped like the reference does
+ *
+ * @param[in] text
+ *      The text to escape
+ *
+ * @return
+ *      `true` if the escaped text matches
+ */
+static bool CheckEscape(std::string_view text)
+{
+    std::string out{"prefix"};
+    rklog::EscapeJson(out, text);
+    if (out == "prefix" + EscapeReference(text))
+        return true;
+
+    std::printf("escaping %zu bytes gave %s\n", text.size(), out.c_str());
+    return false;
+}
+
+/**
+ * Checks every byte of interest at every position of texts of every length up
+ * to `MAX_LENGTH`, alone and next to a second one, so that hits land on
+ * either side of the 16 and 32 byte boundaries and in the scalar tail
+ *
+ * @return
+ *      `true` if every text is escaped correctly
+ */
+static bool CheckEscapes()
+{
+    bool passed = true;
+    for (size_t length = 0; length <= MAX_LENGTH; length++)
+    {
+        passed &= CheckEscape(std::string(length, 'a'));
+        for (size_t position = 0; position < length; position++)
+        {
+            for (const char c : ESCAPED)
+            {
+                std::string text(length, 'a');
+                text[position] = c;
+                passed &= CheckEscape(text);
+
+                text[length - 1 - position] = '"';
+                passed &= CheckEscape(text);
+            }
+
+            for (const char c : COPIED)
+            {
+                std::string text(length, 'a');
+                text[position] = c;
+                passed &= CheckEscape(text);
+            }
+        }
+    }
+
+    // Every byte value on its own, the first in the text and the last
+    std::string all(256, 'a');
+    for (size_t byte = 0; byte < 256; byte++)
+        all[byte] = static_cast<char>(byte);
+
+    passed &= CheckEscape(all);
+    return passed;
+}
+
+/**
+ * Checks that fields named like the members of the JSON sink do not repeat
+ * their keys
+ *
+ * @return
+ *      `true` if every key of the line is written once
+ */
+static bool CheckReservedKeys()
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "rklog_json_test.jsonl";
+    {
+        rklog::SinkLogger logger{"json"};
+        logger.Attach(std::make_shared<rklog::JsonSink>(path));
+        logger.Info("the message", rklog::kv("msg", "a field"), rklog::kv("level", 3), rklog::kv("latency_us", 250));
+    }
+
+    std::ifstream file(path);
+    std::string line{};
+    std::getline(file, line);
+    file.close();
+    std::filesystem::remove(path);
+
+    const auto count = [&line](std::string_view key) {
+        size_t found{};
+        for (size_t at = line.find(key); at != std::string::npos; at = line.find(key, at + 1))
+            found++;
+
+        return found;
+    };
+
+    const bool passed = count("\"msg\":") == 1 && count("\"level\":") == 1 &&
+        count("\"fields.msg\":\"a field\"") == 1 && count("\"fields.level\":3") == 1 &&
+        count("\"latency_us\":250") == 1 && count("\"msg\":\"the message\"") == 1;
+    if (!passed)
+        std::printf("keys repeated or missing: %s\n", line.c_str());
+
+    return passed;
+}
+
+int main()
+{
+    const bool escapes = CheckEscapes();
+    std::printf("escapes:       %s\n", escapes ? "ok" : "FAILED");
+    const bool keys = CheckReservedKeys();
+    std::printf("reserved keys: %s\n", keys ? "ok" : "FAILED");
+    return escapes && keys ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Logger/FileLogger.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// The number of records each thread logs
+static constexpr uint32_t RECORDS_PER_THREAD = 4000;
+/// The thread counts the policies are run with
+static constexpr uint32_t THREAD_COUNTS[] = { 1, 2, 4, 8 };
+
+/**
+ * Gets the payload of a record, a run of one character whose length depends
+ * on the thread and the record, so that a torn or interleaved line shows up
+ * as a payload of the wrong length or with a foreign character
+ *
+ * @param[in] thread
+ *      The index of the thread
+ * @param[in] record
+ *      The index of the record
+ *
+ * @return
+ *      The payload
+ */
+static std::string MakePayload(uint32_t thread, uint32_t record)
+{
+    return std::string(16 + (thread * 31 + record * 7) % 200, static_cast<char>('a' + thread % 26));
+}
+
+/**
+ * Logs records from a number of threads at once
+ *
+ * @param[in] logger
+ *      The logger to log to
+ * @param[in] threads
+ *      The number of threads
+ *
+ * @return
+ *      The nanoseconds taken per record
+ */
+static double LogFromThreads(rklog::Logger& logger, uint32_t threads)
+{
+    std::vector<std::thread> workers{};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t thread = 0; thread < threads; thread++)
+    {
+        workers.emplace_back([&logger, thread] {
+            for (uint32_t record = 0; record < RECORDS_PER_THREAD; record++)
+                logger.Info("{}:{}:{}:end", thread, record, MakePayload(thread, record));
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    logger.Flush();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (threads * RECORDS_PER_THREAD);
+}
+
+/**
+ * Checks that the file holds every record logged by `LogFromThreads()` as a
+ * whole line, exactly once
+ *
+ * @param[in] path
+ *      The path to the file
+ * @param[in] threads
+ *      The number of threads that logged
+ *
+ * @return
+ *      `true` if no line was torn, lost or duplicated
+ */
+static bool CheckLines(const std::filesystem::path& path, uint32_t threads)
+{
+    std::vector<std::vector<bool>> seen(threads, std::vector<bool>(RECORDS_PER_THREAD));
+    std::ifstream file(path);
+    std::string line{};
+    size_t count{};
+    while (std::getline(file, line))
+    {
+        uint32_t thread{};
+        uint32_t record{};
+        int payloadStart{};
+        if (std::sscanf(line.c_str(), "%u:%u:%n", &thread, &record, &payloadStart) != 2 || thread >= threads ||
+            record >= RECORDS_PER_THREAD || seen[thread][record] ||
+            std::string_view(line).substr(static_cast<size_t>(payloadStart)) != MakePayload(thread, record) + ":end")
+        {
+            std::printf("torn or duplicated line: %s\n", line.c_str());
+            return false;
+        }
+
+        seen[thread][record] = true;
+        count++;
+    }
+
+    if (count != threads * RECORDS_PER_THREAD)
+    {
+        std::printf("%zu of %u lines written\n", count, threads * RECORDS_PER_THREAD);
+        return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    constexpr rklog::LogStyle style = rklog::InitBuildStyle()
+        .SetPattern("{msg}")
+        .Build();
+    constexpr std::pair<rklog::LockPolicy, const char*> POLICIES[] = {
+        { rklog::LockPolicy::MUTEX, "mutex" },
+        { rklog::LockPolicy::SPIN, "spin" },
+        { rklog::LockPolicy::ATOMIC_WRITE, "atomic-write" },
+    };
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    bool passed = true;
+    for (const auto& [policy, name] : POLICIES)
+    {
+        for (const uint32_t threads : THREAD_COUNTS)
+        {
+            const std::filesystem::path path = directory / "rklog_lock_test.log";
+            double nanos{};
+            {
+                rklog::FileLogger logger{path, style};
+                logger.SetLockPolicy(policy);
+                nanos = LogFromThreads(logger, threads);
+            }
+
+            const bool whole = CheckLines(path, threads);
+            std::printf("file    %-12s %u threads: %8.1f ns/record %s\n", name, threads, nanos, whole ? "ok" : "TORN");
+            passed &= whole;
+        }
+    }
+
+    // Under `NONE` the single logging thread shares the buffer with the flush
+    // timer, which has to lock against it all the same
+    {
+        constexpr rklog::FlushPolicy interval = rklog::InitBuildFlushPolicy()
+            .SetMode(rklog::FlushMode::INTERVAL)
+            .SetInterval(std::chrono::milliseconds(1))
+            .SetBufferSize(1024)
+            .Build();
+
+        const std::filesystem::path path = directory / "rklog_lock_test.log";
+        double nanos{};
+        {
+            rklog::FileLogger logger{path, style, interval};
+            logger.SetLockPolicy(rklog::LockPolicy::NONE);
+            nanos = LogFromThreads(logger, 1);
+        }
+
+        const bool whole = CheckLines(path, 1);
+        std::printf("file    %-12s %u threads: %8.1f ns/record %s\n", "none+timer", 1u, nanos, whole ? "ok" : "TORN");
+        passed &= whole;
+    }
+
+#if !defined(RKLOG_PLATFORM_WINDOWS)
+    // Terminal loggers write to the standard error, redirected to a file here.
+    // Under `ATOMIC_WRITE` they take no lock at all
+    const std::filesystem::path stderrPath = directory / "rklog_lock_test_stderr.log";
+    for (const auto& [policy, name] : POLICIES)
+    {
+        for (const uint32_t threads : THREAD_COUNTS)
+        {
+            double nanos{};
+            std::filesystem::remove(stderrPath);
+            if (!std::freopen(stderrPath.c_str(), "a", stderr))
+                return EXIT_FAILURE;
+
+            {
+                rklog::BasicLogger logger{style};
+                logger.SetLockPolicy(policy);
+                nanos = LogFromThreads(logger, threads);
+            }
+
+            const bool whole = CheckLines(stderrPath, threads);
+            std::printf("stderr  %-12s %u threads: %8.1f ns/record %s\n", name, threads, nanos, whole ? "ok" : "TORN");
+            passed &= whole;
+        }
+    }
+
+    std::filesystem::remove(stderrPath);
+#endif
+
+    std::filesystem::remove(directory / "rklog_lock_test.log");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,361 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Logger/AsyncLogger.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// The number of records a thread's queue holds, far fewer than a burst
+static constexpr size_t THREAD_CAPACITY = 8;
+/// The number of records the shared queue holds, enough for every burst
+static constexpr size_t SHARED_CAPACITY = 1024;
+/// The number of records each thread logs in a burst
+static constexpr uint32_t BURST = 64;
+/// The number of threads logging one after another
+static constexpr uint32_t SEQUENTIAL_THREADS = 4;
+/// The number of threads logging at once
+static constexpr uint32_t CONCURRENT_THREADS = 3;
+
+/**
+ * Class acting as a backend that keeps the messages it is given. While its
+ * gate is closed, the background thread waits in it with the first record
+ * it writes, so that the queues fill up behind it
+ */
+class CaptureLogger final : public rklog::Logger
+{
+public:
+    /**
+     * Lets the background thread write again
+     */
+    void Open() noexcept
+    {
+        m_Closed.store(false);
+        m_Closed.notify_all();
+    }
+
+    /**
+     * Stops the background thread at the next record it writes
+     */
+    void Close() noexcept { m_Closed.store(true); }
+
+    /**
+     * Counts the records logged by a thread, checking that they come in the
+     * order they were logged
+     *
+     * @param[in] thread
+     *      The index of the thread
+     *
+     * @return
+     *      The number of records, or `SIZE_MAX` if they are out of order
+     */
+    size_t Count(uint32_t thread) const
+    {
+        size_t count{};
+        int64_t last = -1;
+        for (const auto& [from, record] : m_Records)
+        {
+            if (from != thread)
+                continue;
+
+            if (static_cast<int64_t>(record) <= last)
+                return SIZE_MAX;
+
+            last = record;
+            count++;
+        }
+
+        return count;
+    }
+
+protected:
+    virtual void LogInternal(const rklog::LogRecord& record) noexcept override
+    {
+        m_Closed.wait(true);
+
+        uint32_t thread{};
+        uint32_t index{};
+        const std::string message{record.message};
+        if (std::sscanf(message.c_str(), "%u:%u", &thread, &index) == 2)
+            m_Records.emplace_back(thread, index);
+    }
+
+private:
+    /// The thread and index of every record written, in order
+    std::vector<std::pair<uint32_t, uint32_t>> m_Records{};
+    /// A flag indicating whether the background thread has to wait
+    std::atomic<bool> m_Closed{};
+};
+
+/**
+ * Struct logging a last record from the destructor of a thread local, which
+ * runs after the queues of the thread have been given up
+ */
+struct LogOnExit
+{
+public:
+    ~LogOnExit() noexcept
+    {
+        if (logger)
+            logger->Info("{}:{}", thread, BURST);
+    }
+
+    rklog::AsyncLogger* logger{};  // The logger to log to
+    uint32_t thread{};             // The index of the thread
+};
+
+/**
+ * Creates an asynchronous logger with per-thread queues that drop when full,
+ * so that a thread with a queue of its own loses most of a burst while the
+ * background thread is held up, and a thread on the shared queue none
+ *
+ * @param[in] backend
+ *      The backend, kept by the logger
+ * @param[in] maxThreads
+ *      The most threads that get a queue of their own
+ *
+ * @return
+ *      The logger
+ */
+static std::unique_ptr<rklog::AsyncLogger> MakeLogger(CaptureLogger*& backend, size_t maxThreads)
+{
+    const rklog::QueuePolicy policy = rklog::InitBuildQueuePolicy()
+        .SetMode(rklog::QueueMode::PER_THREAD)
+        .SetOverflow(rklog::OverflowPolicy::DROP_NEWEST)
+        .SetCapacity(SHARED_CAPACITY)
+        .SetThreadCapacity(THREAD_CAPACITY)
+        .SetMaxThreads(maxThreads)
+        .Build();
+
+    auto capture = std::make_unique<CaptureLogger>();
+    backend = capture.get();
+    return std::make_unique<rklog::AsyncLogger>(std::move(capture), policy);
+}
+
+/**
+ * Logs a burst of records
+ *
+ * @param[in] logger
+ *      The logger to log to
+ * @param[in] thread
+ *      The index of the thread
+ */
+static void LogBurst(rklog::AsyncLogger& logger, uint32_t thread)
+{
+    for (uint32_t record = 0; record < BURST; record++)
+        logger.Info("{}:{}", thread, record);
+}
+
+/**
+ * Gets the number of records a logger dropped
+ *
+ * @param[in] logger
+ *      The logger
+ *
+ * @return
+ *      The number of dropped records
+ */
+static uint64_t GetDropped(const rklog::AsyncLogger& logger)
+{
+    uint64_t dropped{};
+    for (const uint64_t count : logger.GetStats().dropped)
+        dropped += count;
+
+    return dropped;
+}
+
+/**
+ * Checks that the queue of a thread that exited is taken over by the next
+ * thread, with a single queue to go around
+ *
+ * @return
+ *      `true` if every thread got the queue
+ */
+static bool CheckReuse()
+{
+    CaptureLogger* backend{};
+    const std::unique_ptr<rklog::AsyncLogger> logger = MakeLogger(backend, 1);
+    bool passed = true;
+    for (uint32_t thread = 0; thread < SEQUENTIAL_THREADS; thread++)
+    {
+        backend->Close();
+        std::thread(LogBurst, std::ref(*logger), thread).join();
+        backend->Open();
+        logger->Flush();
+
+        // Without the queue the thread would have used the shared one, which
+        // has room for the whole burst
+        const size_t count = backend->Count(thread);
+        if (count == SIZE_MAX || count >= BURST)
+        {
+            std::printf("thread %u wrote %zu records on its own queue\n", thread, count);
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+/**
+ * Checks that a thread beyond the maximum uses the shared queue while the
+ * other threads hold theirs
+ *
+ * @return
+ *      `true` if exactly one thread fell back to the shared queue
+ */
+static bool CheckFallback()
+{
+    CaptureLogger* backend{};
+    const std::unique_ptr<rklog::AsyncLogger> logger = MakeLogger(backend, CONCURRENT_THREADS - 1);
+    backend->Close();
+
+    // The threads wait for each other before exiting, so that none of them
+    // gives up its queue to the one that is left out
+    std::atomic<uint32_t> done{};
+    std::vector<std::thread> threads{};
+    for (uint32_t thread = 0; thread < CONCURRENT_THREADS; thread++)
+    {
+        threads.emplace_back([&logger, &done, thread] {
+            LogBurst(*logger, thread);
+            done.fetch_add(1);
+            while (done.load() < CONCURRENT_THREADS)
+                std::this_thread::yield();
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    backend->Open();
+    logger->Flush();
+
+    uint32_t shared{};
+    size_t written{};
+    for (uint32_t thread = 0; thread < CONCURRENT_THREADS; thread++)
+    {
+        const size_t count = backend->Count(thread);
+        if (count == SIZE_MAX)
+            return false;
+
+        shared += count == BURST;
+        written += count;
+    }
+
+    const bool passed = shared == 1 && written + GetDropped(*logger) == CONCURRENT_THREADS * BURST;
+    if (!passed)
+        std::printf("%u threads on the shared queue, %zu records written\n", shared, written);
+
+    return passed;
+}
+
+/**
+ * Checks that a thread logging from the destructor of a thread local, once
+ * its queues are given up, still gets its record written, while the next
+ * thread takes over its queue
+ *
+ * @return
+ *      `true` if every record of the threads is written
+ */
+static bool CheckTornDown()
+{
+    CaptureLogger* backend{};
+    const std::unique_ptr<rklog::AsyncLogger> logger = MakeLogger(backend, 1);
+    for (uint32_t thread = 0; thread < SEQUENTIAL_THREADS; thread++)
+    {
+        std::thread([&logger, thread] {
+            // Constructed before the list of queues, so destroyed after it
+            thread_local LogOnExit onExit{};
+            onExit.logger = logger.get();
+            onExit.thread = thread;
+
+            for (uint32_t record = 0; record < THREAD_CAPACITY / 2; record++)
+                logger->Info("{}:{}", thread, record);
+        }).join();
+
+        // Emptied before the next thread fills the queue, which drops when full
+        logger->Flush();
+    }
+
+    bool passed = GetDropped(*logger) == 0;
+    for (uint32_t thread = 0; thread < SEQUENTIAL_THREADS; thread++)
+    {
+        const size_t count = backend->Count(thread);
+        if (count != THREAD_CAPACITY / 2 + 1)
+        {
+            std::printf("thread %u wrote %zu records\n", thread, count);
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+/**
+ * Checks that `Flush()` waits for the records still in the queues of threads
+ * that are alive
+ *
+ * @return
+ *      `true` if every record is written when `Flush()` returns
+ */
+static bool CheckFlush()
+{
+    CaptureLogger* backend{};
+    const std::unique_ptr<rklog::AsyncLogger> logger = MakeLogger(backend, CONCURRENT_THREADS);
+    backend->Close();
+
+    std::atomic<uint32_t> logged{};
+    std::atomic<bool> flushed{};
+    std::vector<std::thread> threads{};
+    for (uint32_t thread = 0; thread < CONCURRENT_THREADS; thread++)
+    {
+        threads.emplace_back([&logger, &logged, &flushed, thread] {
+            for (uint32_t record = 0; record < THREAD_CAPACITY / 2; record++)
+                logger->Info("{}:{}", thread, record);
+
+            logged.fetch_add(1);
+            while (!flushed.load())
+                std::this_thread::yield();
+        });
+    }
+
+    while (logged.load() < CONCURRENT_THREADS)
+        std::this_thread::yield();
+
+    backend->Open();
+    logger->Flush();
+
+    bool passed = true;
+    for (uint32_t thread = 0; thread < CONCURRENT_THREADS; thread++)
+    {
+        const size_t count = backend->Count(thread);
+        if (count != THREAD_CAPACITY / 2)
+        {
+            std::printf("thread %u had %zu records written by the flush\n", thread, count);
+            passed = false;
+        }
+    }
+
+    flushed.store(true);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    return passed;
+}
+
+int main()
+{
+    const bool reuse = CheckReuse();
+    std::printf("reuse:     %s\n", reuse ? "ok" : "FAILED");
+    const bool fallback = CheckFallback();
+    std::printf("fallback:  %s\n", fallback ? "ok" : "FAILED");
+    const bool tornDown = CheckTornDown();
+    std::printf("torn down: %s\n", tornDown ? "ok" : "FAILED");
+    const bool flush = CheckFlush();
+    std::printf("flush:     %s\n", flush ? "ok" : "FAILED");
+    return reuse && fallback && tornDown && flush ? EXIT_SUCCESS : EXIT_FAILURE;
+}
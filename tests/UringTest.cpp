@@ -0,0 +1,224 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Core/Uring.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/// The size of each buffer of the writers, small so that records straddle them
+static constexpr size_t BUFFER_SIZE = 4096;
+/// The number of records each case writes
+static constexpr uint32_t RECORD_COUNT = 20000;
+/// The number of records after which a case submits the current buffer
+static constexpr uint32_t SUBMIT_EVERY = 97;
+/// The number of threads the exiting threads case writes from, one at a time
+static constexpr uint32_t THREAD_COUNT = 50;
+/// The exit code of a child that cannot install its seccomp filter
+static constexpr int SKIPPED = 2;
+
+/**
+ * Gets a record of varying length, so that the records end at every offset
+ * of the buffers
+ *
+ * @param[in] record
+ *      The index of the record
+ *
+ * @return
+ *      The record, a line
+ */
+static std::string MakeRecord(uint32_t record)
+{
+    return std::to_string(record) + ':' + std::string(record * 13 % 300, static_cast<char>('a' + record % 26)) + '\n';
+}
+
+/**
+ * Writes records to a writer, submitting every now and then
+ *
+ * @param[in] writer
+ *      The writer
+ * @param[in] first
+ *      The index of the first record
+ * @param[in] count
+ *      The number of records
+ * @param[out] expected
+ *      The records written, appended to
+ */
+static void WriteRecords(rklog::UringWriter& writer, uint32_t first, uint32_t count, std::string& expected)
+{
+    for (uint32_t record = first; record < first + count; record++)
+    {
+        const std::string text = MakeRecord(record);
+        writer.Write(text);
+        expected += text;
+        if (record % SUBMIT_EVERY == 0)
+            writer.Submit();
+    }
+}
+
+/**
+ * Checks that a file holds exactly the expected bytes
+ *
+ * @param[in] path
+ *      The path to the file
+ * @param[in] expected
+ *      The expected contents
+ *
+ * @return
+ *      `true` if the contents match
+ */
+static bool CheckFile(const std::filesystem::path& path, const std::string& expected)
+{
+    std::ifstream file(path, std::ios::binary);
+    const std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (contents == expected)
+        return true;
+
+    std::printf("%zu of %zu bytes match\n", static_cast<size_t>(std::mismatch(contents.begin(), contents.end(),
+        expected.begin(), expected.end()).first - contents.begin()), expected.size());
+    return false;
+}
+
+/**
+ * Makes `io_uring_enter()` fail with `EPERM` for the calling process
+ *
+ * @return
+ *      `true` if the filter is installed
+ */
+static bool BlockUringEnter()
+{
+    sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_enter, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    };
+    const sock_fprog program{static_cast<unsigned short>(std::size(filter)), filter};
+
+    return ::prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 &&
+        ::prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) == 0;
+}
+
+int main()
+{
+    constexpr std::pair<rklog::SyncMode, const char*> SYNC_MODES[] = {
+        { rklog::SyncMode::NONE, "none" },
+        { rklog::SyncMode::DATA, "data" },
+        { rklog::SyncMode::FULL, "full" },
+    };
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "rklog_uring_test.log";
+    bool passed = true;
+
+    // The ring refused by the kernel halfway through, in a child so that the
+    // filter does not outlive the case
+    {
+        const pid_t child = ::fork();
+        if (child == 0)
+        {
+            constexpr rklog::UringPolicy policy = rklog::InitBuildUringPolicy()
+                .SetSyncMode(rklog::SyncMode::DATA)
+                .Build();
+
+            std::string expected{};
+            rklog::UringWriter writer{path, BUFFER_SIZE, policy};
+            if (!writer.UsesUring())
+                std::_Exit(SKIPPED);
+
+            WriteRecords(writer, 0, RECORD_COUNT / 2, expected);
+            if (!BlockUringEnter())
+                std::_Exit(SKIPPED);
+
+            WriteRecords(writer, RECORD_COUNT / 2, RECORD_COUNT / 2, expected);
+            writer.Flush();
+            std::_Exit(writer.UsesUring() ? EXIT_FAILURE : EXIT_SUCCESS);
+        }
+
+        int status{};
+        ::waitpid(child, &status, 0);
+        const int code = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+        if (code == SKIPPED)
+        {
+            std::printf("%-20s skipped\n", "ring dropped");
+        }
+        else
+        {
+            std::string written{};
+            for (uint32_t record = 0; record < RECORD_COUNT; record++)
+                written += MakeRecord(record);
+
+            const bool whole = code == EXIT_SUCCESS && CheckFile(path, written);
+            std::printf("%-20s %s\n", "ring dropped", whole ? "ok" : "FAILED");
+            passed &= whole;
+        }
+    }
+
+    for (const bool uring : { true, false })
+    {
+        for (const auto& [sync, name] : SYNC_MODES)
+        {
+            const rklog::UringPolicy policy = rklog::InitBuildUringPolicy()
+                .SetUringEnabled(uring)
+                .SetSyncMode(sync)
+                .Build();
+
+            std::string expected{};
+            bool used{};
+            {
+                rklog::UringWriter writer{path, BUFFER_SIZE, policy};
+                used = writer.UsesUring();
+                WriteRecords(writer, 0, RECORD_COUNT, expected);
+                writer.Flush();
+            }
+
+            const bool whole = CheckFile(path, expected);
+            std::printf("%-6s sync %-8s %s\n", used ? "uring" : "writev", name, whole ? "ok" : "FAILED");
+            passed &= whole;
+        }
+    }
+
+    // Requests still in flight when the thread that submitted them exits are
+    // cancelled by the kernel and have to be queued again
+    for (const auto& [sync, name] : SYNC_MODES)
+    {
+        const rklog::UringPolicy policy = rklog::InitBuildUringPolicy()
+            .SetSyncMode(sync)
+            .Build();
+
+        std::string expected{};
+        {
+            rklog::UringWriter writer{path, BUFFER_SIZE, policy};
+            constexpr uint32_t perThread = RECORD_COUNT / THREAD_COUNT;
+            for (uint32_t thread = 0; thread < THREAD_COUNT; thread++)
+            {
+                std::thread([&writer, &expected, thread] {
+                    WriteRecords(writer, thread * perThread, perThread, expected);
+                    writer.Submit();
+                }).join();
+            }
+
+            writer.Flush();
+        }
+
+        const bool whole = CheckFile(path, expected);
+        std::printf("exiting sync %-7s %s\n", name, whole ? "ok" : "FAILED");
+        passed &= whole;
+    }
+
+    std::filesystem::remove(path);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,519 @@
+#include <rklog/rklog.hpp>
+#include <rklog/Core/Platform.hpp>
+#include <rklog/Logger/AsyncLogger.hpp>
+#include <rklog/Logger/BinaryLogger.hpp>
+#include <rklog/Logger/FileLogger.hpp>
+#include <rklog/Logger/JsonSink.hpp>
+#include <rklog/Logger/MappedFileLogger.hpp>
+#include <rklog/Logger/SinkLogger.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace rklog;
+
+// --- allocation counting ----------------------------------------------------
+//
+// Every allocation made through the global `operator new` is counted, so the
+// allocations per record can be reported. Aligned allocations bypass these
+// and are not counted; the library only makes them when creating loggers.
+// Inlining `free()` into the callers of `operator delete` would look like a
+// mismatched deallocation to the compiler, so the functions are kept out of
+// line
+
+static std::atomic<uint64_t> g_Allocations{};
+
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size > 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// --- benchmark cases --------------------------------------------------------
+
+#if defined(RKLOG_PLATFORM_WINDOWS)
+static constexpr const char* NULL_DEVICE = "NUL";
+#else
+static constexpr const char* NULL_DEVICE = "/dev/null";
+#endif
+
+/**
+ * Enum describing the output formats of the results
+ */
+enum class OutputFormat
+{
+    TEXT, // A table for reading
+    CSV,  // One comma separated row per case, after a header row
+    JSON, // One JSON object per case and line
+};
+
+/**
+ * Struct containing the options given on the command line
+ */
+struct Options final
+{
+public:
+    uint64_t records{100'000};                        // The number of records logged per thread
+    uint32_t maxThreads{4};                           // The largest number of threads logging at once
+    std::vector<LockPolicy> locks{LockPolicy::MUTEX}; // The lock policies to run each case with
+    std::string_view filter{};                        // Only cases whose name contains this are run
+    std::filesystem::path dir{};                      // The directory the files are written to
+    OutputFormat format{OutputFormat::TEXT};          // How the results are written
+};
+
+/**
+ * Struct describing a logger under test
+ */
+struct LoggerCase final
+{
+public:
+    std::string_view name{};                                                     // The name of the case
+    bool writesToStdErr{};                                                       // Whether `stderr` is redirected to the null device
+    std::function<std::unique_ptr<Logger>(const std::filesystem::path&)> make{}; // Creates the logger, given a file path
+};
+
+/**
+ * Struct describing a log call under test
+ */
+struct MessageCase final
+{
+public:
+    std::string_view name{};            // The name of the case
+    void (*log)(Logger&, uint64_t i){}; // Makes the i-th log call
+};
+
+/**
+ * Struct containing the results of a single run
+ */
+struct Result final
+{
+public:
+    std::string_view logger{};  // The name of the logger case
+    std::string_view message{}; // The name of the message case
+    uint32_t threads{};         // The number of threads logging
+    LockPolicy lock{};          // The lock policy of the logger
+    uint64_t records{};         // The total number of records logged
+    double nsPerRecord{};       // The wall time divided by the records
+    double recordsPerSecond{};  // The records logged per second
+    uint64_t p50{};             // The median latency of a log call in ns
+    uint64_t p99{};             // The 99th percentile latency in ns
+    uint64_t p999{};            // The 99.9th percentile latency in ns
+    uint64_t max{};             // The highest latency in ns
+    double allocsPerRecord{};   // The allocations per record
+};
+
+static const std::vector<LoggerCase> LOGGERS = {
+    { "basic", true, [](const std::filesystem::path&) -> std::unique_ptr<Logger> {
+        return std::make_unique<BasicLogger>("bench");
+    } },
+    { "color", true, [](const std::filesystem::path&) -> std::unique_ptr<Logger> {
+        return std::make_unique<ColorLogger>("bench");
+    } },
+    { "file-null", false, [](const std::filesystem::path&) -> std::unique_ptr<Logger> {
+        return std::make_unique<FileLogger>(NULL_DEVICE, "bench");
+    } },
+    { "file-tmpfs", false, [](const std::filesystem::path& path) -> std::unique_ptr<Logger> {
+        return std::make_unique<FileLogger>(path, "bench");
+    } },
+    { "json-tmpfs", false, [](const std::filesystem::path& path) -> std::unique_ptr<Logger> {
+        auto logger = std::make_unique<SinkLogger>("bench");
+        logger->Attach(std::make_shared<JsonSink>(path));
+        return logger;
+    } },
+    { "binary-tmpfs", false, [](const std::filesystem::path& path) -> std::unique_ptr<Logger> {
+        return std::make_unique<BinaryLogger>(path, "bench");
+    } },
+    { "mapped-tmpfs", false, [](const std::filesystem::path& path) -> std::unique_ptr<Logger> {
+        return std::make_unique<MappedFileLogger>(path, "bench");
+    } },
+    { "async-file-tmpfs", false, [](const std::filesystem::path& path) -> std::unique_ptr<Logger> {
+        return std::make_unique<AsyncLogger>(std::make_unique<FileLogger>(path, "bench"));
+    } },
+};
+
+static const std::vector<MessageCase> MESSAGES = {
+    { "static", [](Logger& logger, uint64_t) {
+        logger.Info("connection accepted");
+    } },
+    { "long", [](Logger& logger, uint64_t) {
+        logger.Info("the quick brown fox jumps over the lazy dog while the lazy dog keeps on sleeping in "
+            "the afternoon sun, unaware of the fox, the hunter, the farmer and the rest of the village");
+    } },
+    { "ints", [](Logger& logger, uint64_t i) {
+        logger.Info("request {} took {} us with status {}", i, i * 7, 200);
+    } },
+    { "string", [](Logger& logger, uint64_t) {
+        const std::string_view user = "jane.doe@example.com/session-42";
+        logger.Info("user {} logged in", user);
+    } },
+    { "mixed", [](Logger& logger, uint64_t i) {
+        logger.Info("order {} filled at {:.2f} for {}", i, 101.25, "ACME");
+    } },
+    { "fields", [](Logger& logger, uint64_t i) {
+        logger.Info("request done", kv("latency_us", i), kv("path", "/index.html"), kv("ok", true));
+    } },
+};
+
+static std::string_view GetLockName(LockPolicy policy)
+{
+    switch (policy)
+    {
+        case LockPolicy::NONE:
+            return "none";
+        case LockPolicy::MUTEX:
+            return "mutex";
+        case LockPolicy::SPIN:
+            return "spin";
+        case LockPolicy::ATOMIC_WRITE:
+            return "atomic";
+    }
+
+    RKLOG_UNREACHABLE();
+}
+
+/**
+ * Class pointing `stderr` at the null device for as long as it lives, so the
+ * terminal is not part of what is measured
+ */
+class StdErrRedirect final
+{
+public:
+    StdErrRedirect()
+    {
+        std::fflush(stderr);
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        m_Saved = _dup(2);
+        const int null = _open(NULL_DEVICE, _O_WRONLY);
+        _dup2(null, 2);
+        _close(null);
+#else
+        m_Saved = dup(2);
+        const int null = open(NULL_DEVICE, O_WRONLY);
+        dup2(null, 2);
+        close(null);
+#endif
+    }
+
+    StdErrRedirect(const StdErrRedirect&) = delete;
+    StdErrRedirect& operator=(const StdErrRedirect&) = delete;
+
+    ~StdErrRedirect()
+    {
+#if defined(RKLOG_PLATFORM_WINDOWS)
+        _dup2(m_Saved, 2);
+        _close(m_Saved);
+#else
+        dup2(m_Saved, 2);
+        close(m_Saved);
+#endif
+    }
+
+private:
+    /// The descriptor `stderr` pointed to before
+    int m_Saved{};
+};
+
+static uint64_t Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Gets the smallest time between two clock reads, which every latency
+ * includes
+ */
+static uint64_t MeasureClockOverhead()
+{
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 10'000; i++)
+    {
+        const uint64_t start = Now();
+        overhead = std::min(overhead, Now() - start);
+    }
+
+    return overhead;
+}
+
+/**
+ * Runs a case: every thread makes the same number of log calls, each of them
+ * timed. The wall time runs from the release of the threads until the logger
+ * has been flushed
+ */
+static Result Run(const LoggerCase& loggerCase, const MessageCase& messageCase, uint32_t threads, LockPolicy lock, const Options& options)
+{
+    const std::filesystem::path path = options.dir / std::format("rklog-bench-{}.log", loggerCase.name);
+    std::optional<StdErrRedirect> redirect{};
+    if (loggerCase.writesToStdErr)
+        redirect.emplace();
+
+    std::unique_ptr<Logger> logger = loggerCase.make(path);
+    logger->SetLockPolicy(lock);
+
+    // Lets the logger and the format buffers of this thread reach their
+    // steady state before anything is measured
+    for (uint64_t i = 0; i < std::min<uint64_t>(options.records, 1000); i++)
+        messageCase.log(*logger, i);
+    logger->Flush();
+
+    std::vector<std::vector<uint64_t>> latencies(threads, std::vector<uint64_t>(options.records));
+    std::latch ready(threads + 1);
+    std::latch start(1);
+    std::vector<std::thread> workers{};
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            std::vector<uint64_t>& samples = latencies[t];
+            ready.count_down();
+            start.wait();
+
+            for (uint64_t i = 0; i < options.records; i++)
+            {
+                const uint64_t before = Now();
+                messageCase.log(*logger, i);
+                samples[i] = Now() - before;
+            }
+        });
+    }
+
+    ready.arrive_and_wait();
+    const uint64_t allocationsBefore = g_Allocations.load();
+    const uint64_t wallStart = Now();
+    start.count_down();
+
+    for (std::thread& worker : workers)
+        worker.join();
+    logger->Flush();
+
+    const uint64_t wall = Now() - wallStart;
+    const uint64_t allocations = g_Allocations.load() - allocationsBefore;
+
+    logger.reset();
+    redirect.reset();
+    std::error_code error{};
+    std::filesystem::remove(path, error);
+
+    std::vector<uint64_t> all{};
+    all.reserve(threads * options.records);
+    for (const std::vector<uint64_t>& samples : latencies)
+        all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+
+    const auto percentile = [&all](double p) {
+        return all[std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())))];
+    };
+
+    const uint64_t records = threads * options.records;
+    return Result{
+        loggerCase.name, messageCase.name, threads, lock, records,
+        static_cast<double>(wall) / static_cast<double>(records),
+        static_cast<double>(records) * 1e9 / static_cast<double>(wall),
+        percentile(0.5), percentile(0.99), percentile(0.999), all.back(),
+        static_cast<double>(allocations) / static_cast<double>(records),
+    };
+}
+
+static void PrintHeader(OutputFormat format, uint64_t clockOverhead)
+{
+    switch (format)
+    {
+        case OutputFormat::TEXT:
+            std::fputs(std::format("# latencies include {} ns of clock overhead\n{:<18} {:<8} {:>7} {:<6} {:>10} {:>12} {:>8} {:>8} {:>8} {:>10} {:>8}\n",
+                clockOverhead, "logger", "message", "threads", "lock", "ns/record", "records/s", "p50", "p99", "p99.9", "max", "allocs").c_str(), stdout);
+            break;
+        case OutputFormat::CSV:
+            std::fputs("logger,message,threads,lock,records,ns_per_record,records_per_sec,p50_ns,p99_ns,p999_ns,max_ns,allocs_per_record\n", stdout);
+            break;
+        case OutputFormat::JSON:
+            break;
+    }
+
+    std::fflush(stdout);
+}
+
+static void PrintResult(OutputFormat format, const Result& r)
+{
+    const std::string_view lock = GetLockName(r.lock);
+    std::string line{};
+    switch (format)
+    {
+        case OutputFormat::TEXT:
+            line = std::format("{:<18} {:<8} {:>7} {:<6} {:>10.1f} {:>12.0f} {:>8} {:>8} {:>8} {:>10} {:>8.2f}\n",
+                r.logger, r.message, r.threads, lock, r.nsPerRecord, r.recordsPerSecond, r.p50, r.p99, r.p999, r.max, r.allocsPerRecord);
+            break;
+        case OutputFormat::CSV:
+            line = std::format("{},{},{},{},{},{:.2f},{:.0f},{},{},{},{},{:.3f}\n",
+                r.logger, r.message, r.threads, lock, r.records, r.nsPerRecord, r.recordsPerSecond, r.p50, r.p99, r.p999, r.max, r.allocsPerRecord);
+            break;
+        case OutputFormat::JSON:
+            line = std::format("{{\"logger\":\"{}\",\"message\":\"{}\",\"threads\":{},\"lock\":\"{}\",\"records\":{},\"ns_per_record\":{:.2f},"
+                "\"records_per_sec\":{:.0f},\"p50_ns\":{},\"p99_ns\":{},\"p999_ns\":{},\"max_ns\":{},\"allocs_per_record\":{:.3f}}}\n",
+                r.logger, r.message, r.threads, lock, r.records, r.nsPerRecord, r.recordsPerSecond, r.p50, r.p99, r.p999, r.max, r.allocsPerRecord);
+            break;
+    }
+
+    std::fputs(line.c_str(), stdout);
+    std::fflush(stdout);
+}
+
+static void PrintUsage()
+{
+    std::fputs("usage: rklog_bench [--records N] [--threads N] [--locks none,mutex,spin,atomic]\n"
+        "                   [--filter TEXT] [--dir DIR] [--format text|csv|json]\n"
+        "\n"
+        "Measures every logger with every kind of message on 1, 2, 4, ... up to N\n"
+        "threads (4 by default), each logging N records (100000 by default). Files\n"
+        "are written to DIR, by default /dev/shm where it exists. Only the cases\n"
+        "whose logger/message name contains TEXT are run. The lock policy `none`\n"
+        "is only run on a single thread.\n", stderr);
+}
+
+template<typename T>
+static bool ParseNumber(std::string_view text, T& value)
+{
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size() && value > 0;
+}
+
+static bool ParseLocks(std::string_view text, std::vector<LockPolicy>& locks)
+{
+    locks.clear();
+    while (!text.empty())
+    {
+        const size_t comma = text.find(',');
+        const std::string_view name = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+        const LockPolicy policies[] = {LockPolicy::NONE, LockPolicy::MUTEX, LockPolicy::SPIN, LockPolicy::ATOMIC_WRITE};
+        const auto it = std::find_if(std::begin(policies), std::end(policies), [name](LockPolicy policy) { return GetLockName(policy) == name; });
+        if (it == std::end(policies))
+            return false;
+
+        locks.push_back(*it);
+    }
+
+    return !locks.empty();
+}
+
+static std::optional<Options> ParseOptions(int argc, char** argv)
+{
+    Options options{};
+    std::error_code error{};
+    options.dir = std::filesystem::is_directory("/dev/shm", error) ? std::filesystem::path("/dev/shm") : std::filesystem::temp_directory_path(error);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--records" && hasValue)
+        {
+            if (!ParseNumber(argv[++i], options.records))
+                return std::nullopt;
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            if (!ParseNumber(argv[++i], options.maxThreads))
+                return std::nullopt;
+        }
+        else if (arg == "--locks" && hasValue)
+        {
+            if (!ParseLocks(argv[++i], options.locks))
+                return std::nullopt;
+        }
+        else if (arg == "--filter" && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--dir" && hasValue)
+        {
+            options.dir = argv[++i];
+        }
+        else if (arg == "--format" && hasValue)
+        {
+            const std::string_view format = argv[++i];
+            if (format == "text")
+                options.format = OutputFormat::TEXT;
+            else if (format == "csv")
+                options.format = OutputFormat::CSV;
+            else if (format == "json")
+                options.format = OutputFormat::JSON;
+            else
+                return std::nullopt;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    return options;
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = ParseOptions(argc, argv);
+    if (!options)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    PrintHeader(options->format, MeasureClockOverhead());
+    for (const LoggerCase& loggerCase : LOGGERS)
+    {
+        for (const MessageCase& messageCase : MESSAGES)
+        {
+            const std::string name = std::format("{}/{}", loggerCase.name, messageCase.name);
+            if (name.find(options->filter) == std::string::npos)
+                continue;
+
+            for (uint32_t threads = 1; threads <= options->maxThreads; threads = threads < options->maxThreads ? std::min(threads * 2, options->maxThreads) : threads + 1)
+            {
+                for (const LockPolicy lock : options->locks)
+                {
+                    if (lock == LockPolicy::NONE && threads > 1)
+                        continue;
+
+                    PrintResult(options->format, Run(loggerCase, messageCase, threads, lock, *options));
+                }
+            }
+        }
+    }
+
+    return 0;
+}
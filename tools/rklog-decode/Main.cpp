@@ -0,0 +1,578 @@
+#include <rklog/Config/Style.hpp>
+#include <rklog/Core/Binary.hpp>
+#include <rklog/Core/Deferred.hpp>
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace rklog;
+
+/**
+ * Struct containing a format entry read from the file
+ */
+struct FormatEntry final
+{
+public:
+    std::string format{};             // The format string
+    std::string file{};               // The source file of the call site
+    uint32_t line{};                  // The source line of the call site
+    std::string function{};           // The function of the call site
+    std::vector<ArgType> signature{}; // The types of the arguments
+};
+
+/// A decoded argument
+using DecodedArg = std::variant<bool, char, int64_t, uint64_t, float, double, std::string_view, const void*>;
+
+/**
+ * Struct containing the options given on the command line
+ */
+struct Options final
+{
+public:
+    std::string_view path{};       // The path to the binary log
+    LogLevel minLevel{};           // The lowest level that is written
+    std::optional<int64_t> from{}; // The earliest time that is written
+    std::optional<int64_t> to{};   // The latest time that is written
+};
+
+/**
+ * Class reading a binary log entry by entry. The file is read in chunks, so
+ * that arbitrarily large logs can be decoded
+ */
+class Reader final
+{
+public:
+    explicit Reader(const char* path) :
+        m_File(path, std::ios::binary) {}
+
+    bool IsOpen() const { return m_File.is_open(); }
+
+    /**
+     * Runs a parser over the pending data, reading more of the file until the
+     * parser has enough data to succeed
+     *
+     * @return
+     *      `false` once the file ends before the parser succeeds
+     */
+    template<typename Parser>
+    bool Parse(Parser&& parser)
+    {
+        for (;;)
+        {
+            std::string_view data = std::string_view(m_Buffer).substr(m_Offset);
+            if (!data.empty() && parser(data))
+            {
+                m_Offset = m_Buffer.size() - data.size();
+                return true;
+            }
+
+            if (!Fill())
+                return false;
+        }
+    }
+
+    /**
+     * Checks whether unread data is left over
+     */
+    bool HasLeftover() const { return m_Offset < m_Buffer.size(); }
+
+private:
+    bool Fill()
+    {
+        constexpr size_t CHUNK_SIZE = 1024 * 1024;
+
+        m_Buffer.erase(0, m_Offset);
+        m_Offset = 0;
+
+        const size_t size = m_Buffer.size();
+        m_Buffer.resize(size + CHUNK_SIZE);
+        m_File.read(m_Buffer.data() + size, CHUNK_SIZE);
+        m_Buffer.resize(size + static_cast<size_t>(m_File.gcount()));
+        return m_Buffer.size() > size;
+    }
+
+private:
+    std::ifstream m_File;
+    std::string m_Buffer{};
+    size_t m_Offset{};
+};
+
+/**
+ * Reads a little endian value copied byte for byte
+ */
+template<typename T>
+static bool ReadRaw(std::string_view& data, T& value)
+{
+    if (data.size() < sizeof(T))
+        return false;
+
+    std::memcpy(&value, data.data(), sizeof(T));
+    data.remove_prefix(sizeof(T));
+    return true;
+}
+
+/**
+ * Reads the arguments of a record according to its signature
+ */
+static bool ReadArgs(std::string_view& data, const std::vector<ArgType>& signature, std::vector<DecodedArg>& args)
+{
+    args.clear();
+    for (const ArgType type : signature)
+    {
+        uint64_t raw{};
+        int64_t value{};
+        switch (type)
+        {
+            case ArgType::BOOL:
+            case ArgType::CHAR:
+            case ArgType::UINT8:
+            {
+                char c{};
+                if (!ReadRaw(data, c))
+                    return false;
+
+                if (type == ArgType::BOOL)
+                    args.emplace_back(c != 0);
+                else if (type == ArgType::CHAR)
+                    args.emplace_back(c);
+                else
+                    args.emplace_back(static_cast<uint64_t>(static_cast<uint8_t>(c)));
+                break;
+            }
+            case ArgType::INT8:
+            case ArgType::INT16:
+            case ArgType::INT32:
+            case ArgType::INT64:
+                if (!binary::ReadSignedVarint(data, value))
+                    return false;
+                args.emplace_back(value);
+                break;
+            case ArgType::UINT16:
+            case ArgType::UINT32:
+            case ArgType::UINT64:
+                if (!binary::ReadVarint(data, raw))
+                    return false;
+                args.emplace_back(raw);
+                break;
+            case ArgType::FLOAT:
+            {
+                float f{};
+                if (!ReadRaw(data, f))
+                    return false;
+                args.emplace_back(f);
+                break;
+            }
+            case ArgType::DOUBLE:
+            {
+                double d{};
+                if (!ReadRaw(data, d))
+                    return false;
+                args.emplace_back(d);
+                break;
+            }
+            case ArgType::STRING:
+            {
+                std::string_view str{};
+                if (!binary::ReadString(data, str))
+                    return false;
+                args.emplace_back(str);
+                break;
+            }
+            case ArgType::POINTER:
+                if (!binary::ReadVarint(data, raw))
+                    return false;
+                args.emplace_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(raw)));
+                break;
+            case ArgType::CUSTOM:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the value of an argument used as a dynamic width or precision
+ */
+static uint64_t ToInteger(const DecodedArg& arg)
+{
+    if (const auto* value = std::get_if<int64_t>(&arg))
+        return static_cast<uint64_t>(*value);
+    if (const auto* value = std::get_if<uint64_t>(&arg))
+        return *value;
+
+    return 0;
+}
+
+/**
+ * Parses the index of an argument at the start of a replacement field, or
+ * takes the next one if the field has none
+ */
+static size_t ParseIndex(std::string_view& field, size_t& nextIndex)
+{
+    size_t index{};
+    const auto result = std::from_chars(field.data(), field.data() + field.size(), index);
+    if (result.ec != std::errc())
+        return nextIndex++;
+
+    field.remove_prefix(static_cast<size_t>(result.ptr - field.data()));
+    return index;
+}
+
+/**
+ * Formats a message from its format string and decoded arguments. As the
+ * types are only known at runtime, every replacement field is formatted on
+ * its own
+ */
+static void FormatMessage(std::string& out, std::string_view format, const std::vector<DecodedArg>& args)
+{
+    size_t nextIndex{};
+    size_t idx{};
+    while (idx < format.size())
+    {
+        const char c = format[idx];
+        if ((c == '{' || c == '}') && idx + 1 < format.size() && format[idx + 1] == c)
+        {
+            out.push_back(c);
+            idx += 2;
+            continue;
+        }
+        if (c != '{')
+        {
+            out.push_back(c);
+            idx++;
+            continue;
+        }
+
+        // Finds the end of the field, skipping nested fields of the spec
+        size_t end = idx + 1;
+        for (int depth = 1; end < format.size(); end++)
+        {
+            if (format[end] == '{')
+                depth++;
+            else if (format[end] == '}' && --depth == 0)
+                break;
+        }
+
+        std::string_view field = format.substr(idx + 1, end - idx - 1);
+        const size_t index = ParseIndex(field, nextIndex);
+
+        std::string spec = "{";
+        for (size_t i = 0; i < field.size(); i++)
+        {
+            if (field[i] != '{')
+            {
+                spec.push_back(field[i]);
+                continue;
+            }
+
+            const size_t close = field.find('}', i);
+            std::string_view nested = field.substr(i + 1, close - i - 1);
+            const size_t nestedIndex = ParseIndex(nested, nextIndex);
+            spec += std::to_string(nestedIndex < args.size() ? ToInteger(args[nestedIndex]) : 0);
+            i = close;
+        }
+        spec.push_back('}');
+
+        if (index < args.size())
+        {
+            std::visit([&](const auto& value) {
+                std::vformat_to(std::back_inserter(out), spec, std::make_format_args(value));
+            }, args[index]);
+        }
+
+        idx = end + 1;
+    }
+}
+
+/**
+ * Parses a point in time, either as seconds since the epoch or as an
+ * ISO-8601 date and time in UTC (`YYYY-MM-DDTHH:MM:SS`)
+ */
+static std::optional<int64_t> ParseTime(std::string_view text)
+{
+    if (text.ends_with('Z'))
+        text.remove_suffix(1);
+
+    int64_t seconds{};
+    auto result = std::from_chars(text.data(), text.data() + text.size(), seconds);
+    if (result.ec == std::errc() && result.ptr == text.data() + text.size())
+        return seconds * 1'000'000'000;
+
+    std::array<int, 6> parts{};
+    const char* it = text.data();
+    const char* const end = text.data() + text.size();
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        result = std::from_chars(it, end, parts[i]);
+        if (result.ec != std::errc())
+            return std::nullopt;
+
+        it = result.ptr;
+        if (i + 1 < parts.size())
+        {
+            if (it == end)
+                return std::nullopt;
+            it++;
+        }
+    }
+
+    const std::chrono::year_month_day date{std::chrono::year(parts[0]), std::chrono::month(static_cast<unsigned>(parts[1])), std::chrono::day(static_cast<unsigned>(parts[2]))};
+    if (!date.ok())
+        return std::nullopt;
+
+    const auto time = std::chrono::sys_days(date) + std::chrono::hours(parts[3]) + std::chrono::minutes(parts[4]) + std::chrono::seconds(parts[5]);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * Parses the name of a log level
+ */
+static std::optional<LogLevel> ParseLevel(std::string_view text)
+{
+    constexpr std::array<std::string_view, 5> NAMES = { "debug", "info", "warning", "error", "fatal" };
+    for (size_t i = 0; i < NAMES.size(); i++)
+    {
+        if (text == NAMES[i])
+            return static_cast<LogLevel>(i);
+    }
+
+    return std::nullopt;
+}
+
+static void PrintUsage()
+{
+    std::fputs("usage: rklog-decode [--level debug|info|warning|error|fatal] [--from TIME] [--to TIME] FILE\n"
+        "\n"
+        "Decodes a binary log written by rklog::BinaryLogger into text, using the\n"
+        "pattern and the tags the logger was configured with. TIME is either the\n"
+        "seconds since the Unix epoch or YYYY-MM-DDTHH:MM:SS in UTC.\n", stderr);
+}
+
+static std::optional<Options> ParseOptions(int argc, char** argv)
+{
+    Options options{};
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--level" && hasValue)
+        {
+            const auto level = ParseLevel(argv[++i]);
+            if (!level)
+                return std::nullopt;
+            options.minLevel = *level;
+        }
+        else if ((arg == "--from" || arg == "--to") && hasValue)
+        {
+            const auto time = ParseTime(argv[++i]);
+            if (!time)
+                return std::nullopt;
+            (arg == "--from" ? options.from : options.to) = time;
+        }
+        else if (!arg.starts_with("--") && options.path.empty())
+        {
+            options.path = arg;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (options.path.empty())
+        return std::nullopt;
+
+    return options;
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = ParseOptions(argc, argv);
+    if (!options)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    Reader reader(std::string(options->path).c_str());
+    if (!reader.IsOpen())
+    {
+        std::fprintf(stderr, "rklog-decode: cannot open %s\n", std::string(options->path).c_str());
+        return 1;
+    }
+
+    // --- header ---
+
+    std::optional<std::string> title{};
+    std::string pattern{};
+    TimeFormat timeFormat{};
+    std::array<std::string, 5> tags{};
+    int64_t time{};
+
+    const bool validHeader = reader.Parse([&](std::string_view& data) {
+        std::string_view titleText{};
+        std::string_view patternText{};
+        std::array<std::string_view, 5> tagTexts{};
+
+        if (!data.starts_with(binary::MAGIC))
+            return false;
+        data.remove_prefix(binary::MAGIC.size());
+
+        uint8_t version{};
+        uint8_t hasTitle{};
+        std::array<uint8_t, 3> format{};
+        if (!ReadRaw(data, version) || version != binary::VERSION || !ReadRaw(data, hasTitle) ||
+            !binary::ReadString(data, titleText) || !binary::ReadString(data, patternText) || !ReadRaw(data, format))
+            return false;
+        for (std::string_view& tag : tagTexts)
+        {
+            if (!binary::ReadString(data, tag))
+                return false;
+        }
+        if (!binary::ReadSignedVarint(data, time))
+            return false;
+
+        if (hasTitle)
+            title = std::string(titleText);
+        pattern = patternText;
+        timeFormat = TimeFormat{static_cast<TimePrecision>(format[0]), format[1] != 0, format[2] != 0};
+        for (size_t i = 0; i < tags.size(); i++)
+            tags[i] = tagTexts[i];
+        return true;
+    });
+
+    if (!validHeader)
+    {
+        std::fprintf(stderr, "rklog-decode: %s is not a binary log of a supported version\n", std::string(options->path).c_str());
+        return 1;
+    }
+
+    auto builder = InitBuildStyle();
+    for (size_t i = 0; i < tags.size(); i++)
+        (void)builder.SetConfig(InitBuildConfig(static_cast<LogLevel>(i)).SetTag(tags[i]).Build());
+    const LogStyle style = builder
+        .SetPattern(pattern)
+        .SetTimeFormat(timeFormat)
+        .Build();
+
+    // --- entries ---
+
+    std::vector<FormatEntry> formats{};
+    std::vector<DecodedArg> args{};
+    std::string message{};
+    std::string line{};
+    bool corrupt{};
+
+    for (;;)
+    {
+        bool isRecord{};
+        LogRecord record{};
+        const FormatEntry* entry{};
+
+        const bool parsed = reader.Parse([&](std::string_view& data) {
+            const auto tag = static_cast<uint8_t>(data.front());
+            data.remove_prefix(1);
+
+            if (tag == binary::FORMAT_TAG)
+            {
+                uint64_t lineNumber{};
+                uint64_t count{};
+                std::string_view format{};
+                std::string_view file{};
+                std::string_view function{};
+                if (!binary::ReadString(data, format) || !binary::ReadString(data, file) ||
+                    !binary::ReadVarint(data, lineNumber) || !binary::ReadString(data, function) ||
+                    !binary::ReadVarint(data, count) || data.size() < count)
+                    return false;
+
+                FormatEntry& added = formats.emplace_back();
+                added.format = format;
+                added.file = file;
+                added.line = static_cast<uint32_t>(lineNumber);
+                added.function = function;
+                for (size_t i = 0; i < count; i++)
+                    added.signature.push_back(static_cast<ArgType>(data[i]));
+                data.remove_prefix(count);
+
+                isRecord = false;
+                return true;
+            }
+
+            const uint8_t level = tag - binary::RECORD_TAG;
+            uint64_t id{};
+            int64_t delta{};
+            uint64_t threadId{};
+            if (tag < binary::RECORD_TAG || level > static_cast<uint8_t>(LogLevel::LOG_FATAL))
+            {
+                corrupt = true;
+                return true;
+            }
+            if (!binary::ReadVarint(data, id) || !binary::ReadSignedVarint(data, delta) || !binary::ReadVarint(data, threadId))
+                return false;
+            if (id >= formats.size())
+            {
+                corrupt = true;
+                return true;
+            }
+
+            entry = &formats[id];
+            if (!ReadArgs(data, entry->signature, args))
+                return false;
+
+            time += delta;
+            record.level = static_cast<LogLevel>(level);
+            record.threadId = threadId;
+            isRecord = true;
+            return true;
+        });
+
+        if (!parsed || corrupt)
+            break;
+        if (!isRecord)
+            continue;
+
+        if (record.level < options->minLevel || (options->from && time < *options->from) || (options->to && time > *options->to))
+            continue;
+
+        message.clear();
+        try
+        {
+            FormatMessage(message, entry->format, args);
+        }
+        catch (const std::format_error& error)
+        {
+            message = std::format("<cannot format \"{}\": {}>", entry->format, error.what());
+        }
+
+        record.message = message;
+        record.time = TimeStamp(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time))));
+        record.location = SourceLocation(entry->file.c_str(), entry->line, entry->function.c_str());
+
+        line.clear();
+        style.FormatTo(line, record, title, false);
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+
+    if (corrupt)
+    {
+        std::fprintf(stderr, "rklog-decode: stopped at a corrupt entry\n");
+        return 1;
+    }
+    if (reader.HasLeftover())
+        std::fprintf(stderr, "rklog-decode: the log ends in a partial entry\n");
+
+    return 0;
+}